@@ -138,6 +138,12 @@ int CommandLineInterface::execute(const QStringList& args) noexcept {
          "settings. If not set, the settings from the boards will be used "
          "instead."),
       tr("file"));
+  QCommandLineOption drcProfileOption(
+      "drc-profile",
+      tr("Print the execution time of each design rule check job, either as "
+         "'%1' or as '%2'. Only has an effect together with '--drc'.")
+          .arg("table", "json"),
+      tr("format"));
   QCommandLineOption runSpecificJobOption(
       "run-job",
       tr("Run a particular output job. Can be given multiple times to run "
@@ -364,6 +370,7 @@ int CommandLineInterface::execute(const QStringList& args) noexcept {
     parser.addOption(ercOption);
     parser.addOption(drcOption);
     parser.addOption(drcSettingsOption);
+    parser.addOption(drcProfileOption);
     parser.addOption(runSpecificJobOption);
     parser.addOption(runAllJobsOption);
     parser.addOption(customJobsOption);
@@ -512,6 +519,7 @@ int CommandLineInterface::execute(const QStringList& args) noexcept {
         parser.isSet(ercOption),  // run ERC
         parser.isSet(drcOption),  // run DRC
         parser.value(drcSettingsOption),  // DRC settings
+        parser.value(drcProfileOption),  // DRC profile format
         parser.values(runSpecificJobOption),  // run specific output jobs
         parser.isSet(runAllJobsOption),  // run all output jobs
         parser.value(customJobsOption).trimmed(),  // custom jobs file path
@@ -584,11 +592,12 @@ int CommandLineInterface::execute(const QStringList& args) noexcept {
 
 bool CommandLineInterface::openProject(
     const QString& projectFile, bool runErc, bool runDrc,
-    const QString& drcSettingsPath, const QStringList& runJobs, bool runAllJobs,
-    const QString& customJobsPath, const QString& customOutDir,
-    const QStringList& exportSchematicsFiles, const QStringList& exportBomFiles,
-    const QStringList& exportBoardBomFiles, const QString& bomAttributes,
-    bool exportPcbFabricationData, const QString& pcbFabricationSettingsPath,
+    const QString& drcSettingsPath, const QString& drcProfileFormat,
+    const QStringList& runJobs, bool runAllJobs, const QString& customJobsPath,
+    const QString& customOutDir, const QStringList& exportSchematicsFiles,
+    const QStringList& exportBomFiles, const QStringList& exportBoardBomFiles,
+    const QString& bomAttributes, bool exportPcbFabricationData,
+    const QString& pcbFabricationSettingsPath,
     const QStringList& exportPnpTopFiles,
     const QStringList& exportPnpBottomFiles,
     const QStringList& exportNetlistFiles, const QStringList& boardNames,
@@ -806,6 +815,13 @@ bool CommandLineInterface::openProject(
           boardsToCheck.clear();  // avoid exporting any boards
         }
       }
+      if ((!drcProfileFormat.isEmpty()) && (drcProfileFormat != "table") &&
+          (drcProfileFormat != "json")) {
+        printErr(tr("ERROR: Unknown DRC profile format '%1'.")
+                     .arg(drcProfileFormat));
+        success = false;
+        boardsToCheck.clear();  // avoid exporting any boards
+      }
       foreach (Board* board, boardsToCheck) {
         print("  " % tr("Board '%1':").arg(*board->getName()));
         BoardDesignRuleCheck drc;
@@ -832,6 +848,11 @@ bool CommandLineInterface::openProject(
           printErr("      - " % msg);
           success = false;
         }
+
+        // Print profiling data, if requested.
+        if (!drcProfileFormat.isEmpty()) {
+          print(formatDrcProfile(result, drcProfileFormat == "json", "    "));
+        }
       }
     }
 
@@ -1329,6 +1350,69 @@ QStringList CommandLineInterface::formatLibraryElementCheckSummary(
   return messages;
 }
 
+QString CommandLineInterface::formatDrcProfile(
+    const BoardDesignRuleCheck::Result& result, bool json,
+    const QString& indent) noexcept {
+  // Sort jobs by execution time to see the most expensive ones first.
+  QVector<BoardDesignRuleCheck::JobStatistics> jobs = result.jobs;
+  std::stable_sort(jobs.begin(), jobs.end(),
+                   [](const BoardDesignRuleCheck::JobStatistics& a,
+                      const BoardDesignRuleCheck::JobStatistics& b) {
+                     return a.elapsedTimeMs > b.elapsedTimeMs;
+                   });
+
+  if (json) {
+    QJsonObject items;
+    for (const auto& pair : result.itemCounts) {
+      items.insert(pair.first, pair.second);
+    }
+    QJsonArray jobsArray;
+    for (const BoardDesignRuleCheck::JobStatistics& job : jobs) {
+      jobsArray.append(QJsonObject{
+          {"name", job.name},
+          {"elapsed_time_ms", job.elapsedTimeMs},
+          {"clipper_operations", static_cast<qint64>(job.clipperOperations)},
+      });
+    }
+    const QJsonObject root{
+        {"elapsed_time_ms", result.elapsedTimeMs},
+        {"planes_rebuild_time_ms", result.planesRebuildTimeMs},
+        {"air_wires_rebuild_time_ms", result.airWiresRebuildTimeMs},
+        {"data_copy_time_ms", result.dataCopyTimeMs},
+        {"items", items},
+        {"jobs", jobsArray},
+    };
+    return QString::fromUtf8(
+        QJsonDocument(root).toJson(QJsonDocument::Compact));
+  }
+
+  QStringList items;
+  for (const auto& pair : result.itemCounts) {
+    items.append(QString("%1 %2").arg(pair.second).arg(pair.first));
+  }
+  auto formatTime = [](qint64 ms) {
+    return QString("%1 ms").arg(ms, 6);
+  };
+  QStringList lines;
+  lines.append(indent % tr("Profile:"));
+  lines.append(indent % "  " % tr("Total time:").leftJustified(24) %
+               formatTime(result.elapsedTimeMs));
+  lines.append(indent % "  " % tr("Planes rebuild:").leftJustified(24) %
+               formatTime(result.planesRebuildTimeMs));
+  lines.append(indent % "  " % tr("Air wires rebuild:").leftJustified(24) %
+               formatTime(result.airWiresRebuildTimeMs));
+  lines.append(indent % "  " % tr("Board data copy:").leftJustified(24) %
+               formatTime(result.dataCopyTimeMs));
+  lines.append(indent % "  " % tr("Items:") % " " % items.join(", "));
+  lines.append(indent % "  " % tr("Jobs (executed in parallel):"));
+  for (const BoardDesignRuleCheck::JobStatistics& job : jobs) {
+    lines.append(indent % "    " % job.name.leftJustified(46) %
+                 formatTime(job.elapsedTimeMs) % "  " %
+                 tr("%1 Clipper operations").arg(job.clipperOperations));
+  }
+  return lines.join("\n");
+}
+
 QStringList CommandLineInterface::formatCheckSummary(
     int approvedCount, int nonApprovedCount, const QString& indent) const {
   QStringList messages;
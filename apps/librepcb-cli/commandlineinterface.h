@@ -23,6 +23,7 @@
 /*******************************************************************************
  *  Includes
  ******************************************************************************/
+#include <librepcb/core/project/board/drc/boarddesignrulecheck.h>
 #include <librepcb/core/rulecheck/rulecheckmessage.h>
 
 #include <QtCore>
@@ -66,9 +67,10 @@ private:  // Methods
 
   bool openProject(
       const QString& projectFile, bool runErc, bool runDrc,
-      const QString& drcSettingsPath, const QStringList& runJobs,
-      bool runAllJobs, const QString& customJobsPath,
-      const QString& customOutDir, const QStringList& exportSchematicsFiles,
+      const QString& drcSettingsPath, const QString& drcProfileFormat,
+      const QStringList& runJobs, bool runAllJobs,
+      const QString& customJobsPath, const QString& customOutDir,
+      const QStringList& exportSchematicsFiles,
       const QStringList& exportBomFiles, const QStringList& exportBoardBomFiles,
       const QString& bomAttributes, bool exportPcbFabricationData,
       const QString& pcbFabricationSettingsPath,
@@ -100,6 +102,8 @@ private:  // Methods
       const CheckResult& checkResult) const;
   QStringList formatCheckSummary(int approvedCount, int nonApprovedCount,
                                  const QString& indent = "") const;
+  static QString formatDrcProfile(const BoardDesignRuleCheck::Result& result,
+                                  bool json, const QString& indent) noexcept;
 
   void processLibraryElement(const QString& libDir, TransactionalFileSystem& fs,
                              LibraryBaseElement& element, bool runCheck,
@@ -55,6 +55,7 @@
 #include <Quantity_ColorRGBA.hxx>
 #endif
 #include <StdFail_NotDone.hxx>
+#include <STEPCAFControl_Controller.hxx>
 #include <STEPCAFControl_Reader.hxx>
 #include <STEPCAFControl_Writer.hxx>
 #include <STEPControl_Reader.hxx>
@@ -64,6 +65,7 @@
 #include <TDF_ChildIterator.hxx>
 #include <TDF_Label.hxx>
 #include <TDF_LabelSequence.hxx>
+#include <TDF_Tool.hxx>
 #include <TDocStd_Document.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS_Face.hxx>
@@ -83,6 +85,11 @@ namespace librepcb {
 
 bool OccModel::sOutputVerbosityConfigured = false;
 
+// Note: When changing the tesselation parameters, make sure they are still
+// covered by getTesselationSettingsId() to invalidate cached tesselations.
+static const qreal sTesselationDeflection = 0.01;
+static const qreal sTesselationDeflectionAngle = 20. * 3.141 / 180.;
+
 /*******************************************************************************
  *  Data
  ******************************************************************************/
@@ -91,6 +98,13 @@ struct OccModel::Data {
 #if USE_OPENCASCADE
   Handle(TDocStd_Document) doc;
   TDF_Label assemblyLabel;
+
+  /// Shapes of the models already added to the assembly, used to add further
+  /// instances of the same model by reference instead of by copy. The value
+  /// also holds a reference to the model to keep the key valid.
+  QHash<const TDocStd_Document*,
+        std::pair<Handle(TDocStd_Document), QVector<TDF_Label>>>
+      addedModels = {};
 #else
   int dummy;
 #endif
@@ -102,6 +116,24 @@ struct OccModel::Data {
 
 #if USE_OPENCASCADE
 
+// The OpenCascade application keeps track of all open documents, which is not
+// thread-safe. Since models are loaded from multiple threads concurrently,
+// creating and closing documents needs to be serialized.
+static QMutex sDocumentMutex;
+
+static Handle(TDocStd_Document) newDocument() {
+  QMutexLocker lock(&sDocumentMutex);
+  Handle(XCAFApp_Application) app = XCAFApp_Application::GetApplication();
+  Handle(TDocStd_Document) doc;
+  app->NewDocument("MDTV-XCAF", doc);
+  return doc;
+}
+
+static void closeDocument(Handle(TDocStd_Document) doc) {
+  QMutexLocker lock(&sDocumentMutex);
+  doc->Close();
+}
+
 static bool tryGetColor(Handle(XCAFDoc_ColorTool) colorTool,
                         const TopoDS_Shape& shape, Quantity_Color& color) {
   return colorTool->GetColor(shape, XCAFDoc_ColorSurf, color) ||
@@ -162,8 +194,8 @@ static bool tesselateFace(Handle(XCAFDoc_ColorTool) colorTool,
                           QMap<OccModel::Color, QVector<QVector3D>>& result) {
   if (face.IsNull()) return false;
 
-  const Standard_Real deflectionAngle = 20. * 3.141 / 180.;
-  const Standard_Real deflection = 0.01;
+  const Standard_Real deflectionAngle = sTesselationDeflectionAngle;
+  const Standard_Real deflection = sTesselationDeflection;
 
   TopLoc_Location loc;
   Handle(Poly_Triangulation) triangulation =
@@ -376,13 +408,42 @@ void OccModel::addToAssembly(const OccModel& model, const Point3D& pos,
     TCollection_ExtendedString newName(cleanString(name).toStdString().c_str());
     TDataStd_Name::Set(newLabel, newName);
 
+    // If the same model was already added before, only add new instances of
+    // its shapes. Otherwise the model shapes would be copied into the
+    // assembly (and thus into the exported file) for every single instance.
     TDF_LabelSequence modelShapes;
-    modelShapeTool->GetFreeShapes(modelShapes);
+    auto addedModel = mImpl->addedModels.find(model.mImpl->doc.get());
+    if (addedModel != mImpl->addedModels.end()) {
+      for (const TDF_Label& shapeLabel : addedModel->second) {
+        assemblyShapeTool->AddComponent(newLabel, shapeLabel,
+                                        TopLoc_Location());
+      }
+    } else {
+      modelShapeTool->GetFreeShapes(modelShapes);
+      addedModel = mImpl->addedModels.insert(
+          model.mImpl->doc.get(),
+          std::make_pair(model.mImpl->doc, QVector<TDF_Label>()));
+    }
     for (int i = 1; i <= modelShapes.Length(); ++i) {
       TopoDS_Shape shape = modelShapeTool->GetShape(modelShapes.Value(i));
       if (shape.IsNull()) continue;
       TDF_Label shapeLabel = assemblyShapeTool->AddShape(shape, Standard_False);
-      const QString shapeName = QString("%1:%2").arg(cleanString(name)).arg(i);
+      addedModel->second.append(shapeLabel);
+      // The shape is shared by all devices using this model, so name it after
+      // the model itself (if it has a name) instead of the current device.
+      QString shapeName;
+      Handle(TDataStd_Name) modelShapeName;
+      if (modelShapes.Value(i).FindAttribute(TDataStd_Name::GetID(),
+                                             modelShapeName)) {
+        const TCollection_ExtendedString& str = modelShapeName->Get();
+        shapeName = cleanString(QString::fromUtf16(
+            reinterpret_cast<const char16_t*>(str.ToExtString()),
+            str.Length()));
+      }
+      if (shapeName.isEmpty()) {
+        shapeName = QString("Model %1").arg(mImpl->addedModels.count());
+      }
+      shapeName += QString(":%1").arg(i);
       TDataStd_Name::Set(shapeLabel, shapeName.toStdString().c_str());
       // ATTENTION: Until LibrePCB 1.1.0 we passed shape.Location() instead of
       // TopLoc_Location(), but this caused wrong placement in rare cases.
@@ -536,6 +597,82 @@ QMap<OccModel::Color, QVector<QVector3D>> OccModel::tesselate() const {
   return result;
 }
 
+QVector<OccModel::AssemblyComponent> OccModel::getAssemblyComponents() const {
+  QVector<AssemblyComponent> result;
+#if USE_OPENCASCADE
+  auto getName = [](const TDF_Label& label) {
+    Handle(TDataStd_Name) name;
+    if (!label.FindAttribute(TDataStd_Name::GetID(), name)) {
+      return QString();
+    }
+    const TCollection_ExtendedString& str = name->Get();
+    return QString::fromUtf16(
+        reinterpret_cast<const char16_t*>(str.ToExtString()), str.Length());
+  };
+
+  if (mImpl->assemblyLabel.IsNull()) {
+    return result;  // Not an assembly.
+  }
+
+  try {
+    Handle(XCAFDoc_ShapeTool) shapeTool =
+        XCAFDoc_DocumentTool::ShapeTool(mImpl->doc->Main());
+    Handle(XCAFDoc_ColorTool) colorTool =
+        XCAFDoc_DocumentTool::ColorTool(mImpl->doc->Main());
+    TDF_LabelSequence components;
+    XCAFDoc_ShapeTool::GetComponents(mImpl->assemblyLabel, components);
+    for (Standard_Integer i = 1; i <= components.Length(); ++i) {
+      TDF_Label instanceLabel;
+      if (!XCAFDoc_ShapeTool::GetReferredShape(components.Value(i),
+                                               instanceLabel)) {
+        continue;
+      }
+      AssemblyComponent cmp;
+      cmp.name = getName(instanceLabel);
+      const gp_Trsf t =
+          XCAFDoc_ShapeTool::GetLocation(components.Value(i)).Transformation();
+      for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 4; ++col) {
+          cmp.location(row, col) = t.Value(row + 1, col + 1);
+        }
+      }
+      TDF_LabelSequence shapeComponents;
+      XCAFDoc_ShapeTool::GetComponents(instanceLabel, shapeComponents);
+      for (Standard_Integer k = 1; k <= shapeComponents.Length(); ++k) {
+        TDF_Label shapeLabel;
+        if (!XCAFDoc_ShapeTool::GetReferredShape(shapeComponents.Value(k),
+                                                 shapeLabel)) {
+          continue;
+        }
+        TCollection_AsciiString entry;
+        TDF_Tool::Entry(shapeLabel, entry);
+        cmp.shapeEntries.append(QString(entry.ToCString()));
+        cmp.shapeNames.append(getName(shapeLabel));
+        const TopoDS_Shape shape = shapeTool->GetShape(shapeLabel);
+        for (TopAbs_ShapeEnum type : {TopAbs_SOLID, TopAbs_FACE}) {
+          for (TopExp_Explorer e(shape, type); e.More(); e.Next()) {
+            Color color;
+            if (tryGetColor(colorTool, e.Current(), color) &&
+                (!cmp.colors.contains(color))) {
+              cmp.colors.append(color);
+            }
+          }
+        }
+      }
+      std::sort(cmp.colors.begin(), cmp.colors.end());
+      result.append(cmp);
+    }
+  } catch (const Standard_Failure& e) {
+    qCritical() << "OpenCascade error:" << e.GetMessageString();
+    throw RuntimeError(
+        __FILE__, __LINE__,
+        QString("STEP assembly inspection failed: %1")
+            .arg(e.GetMessageString()));
+  }
+#endif
+  return result;
+}
+
 /*******************************************************************************
  *  Static Methods
  ******************************************************************************/
@@ -553,6 +690,13 @@ QString OccModel::getOccVersionString() noexcept {
   return s;
 }
 
+QString OccModel::getTesselationSettingsId() noexcept {
+  return QString("%1;deflection=%2;angle=%3")
+      .arg(getOccVersionString())
+      .arg(sTesselationDeflection)
+      .arg(sTesselationDeflectionAngle);
+}
+
 void OccModel::setVerboseOutput(bool verbose) noexcept {
 #if USE_OPENCASCADE
   const Message_SequenceOfPrinters& printers =
@@ -572,9 +716,7 @@ std::unique_ptr<OccModel> OccModel::createAssembly(const QString& name) {
   try {
     initOpenCascade();
 
-    Handle(XCAFApp_Application) app = XCAFApp_Application::GetApplication();
-    Handle(TDocStd_Document) doc;
-    app->NewDocument("MDTV-XCAF", doc);
+    Handle(TDocStd_Document) doc = newDocument();
     Handle(XCAFDoc_ShapeTool) shapeTool =
         XCAFDoc_DocumentTool::ShapeTool(doc->Main());
     TDF_Label label = shapeTool->NewShape();
@@ -606,9 +748,7 @@ std::unique_ptr<OccModel> OccModel::createBoard(const librepcb::Path& outline,
   try {
     initOpenCascade();
 
-    Handle(XCAFApp_Application) app = XCAFApp_Application::GetApplication();
-    Handle(TDocStd_Document) doc;
-    app->NewDocument("MDTV-XCAF", doc);
+    Handle(TDocStd_Document) doc = newDocument();
     Handle(XCAFDoc_ShapeTool) shapeTool =
         XCAFDoc_DocumentTool::ShapeTool(doc->Main());
 
@@ -688,9 +828,7 @@ std::unique_ptr<OccModel> OccModel::loadStep(const QByteArray content) {
   try {
     initOpenCascade();
 
-    Handle(XCAFApp_Application) app = XCAFApp_Application::GetApplication();
-    Handle(TDocStd_Document) doc;
-    app->NewDocument("MDTV-XCAF", doc);
+    Handle(TDocStd_Document) doc = newDocument();
     STEPCAFControl_Reader stepReader;
     stepReader.SetColorMode(Standard_True);
     stepReader.SetNameMode(Standard_False);
@@ -711,7 +849,7 @@ std::unique_ptr<OccModel> OccModel::loadStep(const QByteArray content) {
     }
 
     if (!stepReader.Transfer(doc)) {
-      doc->Close();
+      closeDocument(doc);
       throw RuntimeError(__FILE__, __LINE__, "Failed to transfer STEP model.");
     }
     result.reset(new OccModel(std::make_unique<Data>(Data{doc, TDF_Label()})));
@@ -871,6 +1009,10 @@ void OccModel::initOpenCascade() {
     // Apply global settings.
     XCAFDoc_ShapeTool::SetAutoNaming(false);
 
+    // Register the STEP translation parameters once, since doing it lazily
+    // is not thread-safe in all OpenCascade versions.
+    STEPCAFControl_Controller::Init();
+
     // Initially we used 1e-6 (same as Horizon EDA) but it caused STEP export
     // errors in rare cases, due to arc vertices not within the precision.
     // Thus now allowing a larger tolerance.
@@ -57,6 +57,17 @@ public:
   // Types
   typedef std::tuple<qreal, qreal, qreal, qreal> Color;
 
+  /**
+   * @brief A component added by #addToAssembly()
+   */
+  struct AssemblyComponent {
+    QString name;  ///< Name passed to #addToAssembly()
+    QMatrix4x4 location;  ///< Placement within the assembly [mm]
+    QStringList shapeEntries;  ///< Label entries of the referenced shapes
+    QStringList shapeNames;  ///< Names of the referenced shapes
+    QList<Color> colors;  ///< Sorted unique colors of the referenced shapes
+  };
+
   // Constructors / Destructor
   OccModel() noexcept = delete;
   OccModel(const OccModel& other) = delete;
@@ -69,9 +80,30 @@ public:
   void saveAsStep(const QString& name, const FilePath& fp) const;
   QMap<Color, QVector<QVector3D>> tesselate() const;
 
+  /**
+   * @brief Get the components of an assembly
+   *
+   * Allows to inspect how models are referenced by an assembly created with
+   * #createAssembly(), e.g. whether identical models share their shapes.
+   *
+   * @return All components added to the assembly, in the order of addition.
+   */
+  QVector<AssemblyComponent> getAssemblyComponents() const;
+
   // Static Methods
   static bool isAvailable() noexcept;
   static QString getOccVersionString() noexcept;
+
+  /**
+   * @brief Get a string identifying the behavior of #tesselate()
+   *
+   * The returned value changes whenever the tesselation results might change,
+   * e.g. after changing the tesselation parameters or the OpenCascade version.
+   * It is used to invalidate persistently cached tesselation results.
+   *
+   * @return Tesselation settings identifier.
+   */
+  static QString getTesselationSettingsId() noexcept;
   static void setVerboseOutput(bool verbose) noexcept;
   static std::unique_ptr<OccModel> createAssembly(const QString& name);
   static std::unique_ptr<OccModel> createBoard(const Path& outline,
@@ -142,24 +142,76 @@ QString StepExport::run(std::shared_ptr<SceneData3D> data, FilePath fp,
     }
     emit progressPercent(20);
 
-    // Add devices.
+    // Add devices. Identical STEP models (e.g. of many 0402 resistors) are
+    // loaded only once, and all unique models are loaded in parallel.
     int deviceErrors = 0;
+    int uniqueModelCount = 0;
     QString lastError;
     if (std::shared_ptr<FileSystem> fs = data->getFileSystem()) {
-      int i = 1;
+      QHash<QByteArray, int> modelIndices;  // Key: Content hash
+      QVector<QByteArray> modelContents;
+      QVector<int> deviceModelIndices;  // -1 if there's no model
+      QHash<int, QString> deviceReadErrors;  // Key: Device index
       for (const auto& obj : data->getDevices()) {
+        int index = -1;
         try {
-          emit progressStatus(tr("Exporting device %1/%2...")
-                                  .arg(i)
-                                  .arg(data->getDevices().count()));
           const QByteArray content = fs->readIfExists(obj.stepFile);
           if (!content.isEmpty()) {
+            const QByteArray hash =
+                QCryptographicHash::hash(content, QCryptographicHash::Sha256);
+            index = modelIndices.value(hash, -1);
+            if (index < 0) {
+              index = modelContents.count();
+              modelIndices.insert(hash, index);
+              modelContents.append(content);
+            }
+          }
+        } catch (const Exception& e) {
+          deviceReadErrors.insert(deviceModelIndices.count(), e.getMsg());
+        }
+        deviceModelIndices.append(index);
+      }
+      uniqueModelCount = modelContents.count();
+
+      // Note: Using a dedicated thread pool since this method itself is
+      // already running in the global thread pool and blocks until the
+      // models are loaded.
+      QThreadPool pool;
+      QFuture<LoadedModel> future = QtConcurrent::mapped(
+          &pool, modelContents, [](const QByteArray& content) {
+            LoadedModel result;
+            try {
+              result.model = OccModel::loadStep(content);
+            } catch (const Exception& e) {
+              result.error = e.getMsg();
+            }
+            return result;
+          });
+      auto futureGuard = scopeGuard([&future]() {
+        future.cancel();
+        future.waitForFinished();
+      });
+
+      for (int i = 0; i < data->getDevices().count(); ++i) {
+        const auto& obj = data->getDevices().at(i);
+        const int index = deviceModelIndices.at(i);
+        try {
+          emit progressStatus(tr("Exporting device %1/%2...")
+                                  .arg(i + 1)
+                                  .arg(data->getDevices().count()));
+          if (deviceReadErrors.contains(i)) {
+            throw RuntimeError(__FILE__, __LINE__, deviceReadErrors.value(i));
+          } else if (index >= 0) {
+            // Blocks until the model is loaded.
+            const LoadedModel loaded = future.resultAt(index);
+            if (!loaded.model) {
+              throw RuntimeError(__FILE__, __LINE__, loaded.error);
+            }
             Point3D pos = obj.stepPosition;
             if (!obj.transform.getMirrored()) {
               std::get<2>(pos) += *data->getThickness();
             }
-            std::unique_ptr<OccModel> devModel = OccModel::loadStep(content);
-            model->addToAssembly(*devModel, pos, obj.stepRotation,
+            model->addToAssembly(*loaded.model, pos, obj.stepRotation,
                                  obj.transform, obj.name);
           }
         } catch (const Exception& e) {
@@ -168,9 +220,9 @@ QString StepExport::run(std::shared_ptr<SceneData3D> data, FilePath fp,
           ++deviceErrors;
           lastError = obj.name % ": " % e.getMsg();
         }
-        emit progressPercent(20 + ((70 * i) / data->getDevices().count()));
+        emit progressPercent(20 +
+                             ((70 * (i + 1)) / data->getDevices().count()));
         if (mAbort) return QString();
-        ++i;
       }
     }
 
@@ -178,7 +230,8 @@ QString StepExport::run(std::shared_ptr<SceneData3D> data, FilePath fp,
     emit progressStatus(tr("Saving..."));
     model->saveAsStep(data->getProjectName(), fp);
     emit progressPercent(100);
-    qDebug() << "Exported STEP file in" << timer.elapsed() << "ms.";
+    qDebug() << "Exported STEP file with" << uniqueModelCount
+             << "unique device models in" << timer.elapsed() << "ms.";
 
     QString errMsg;
     if (deviceErrors > 0) {
@@ -0,0 +1,257 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "tesselationcache.h"
+
+#include "../exceptions.h"
+#include "../fileio/fileutils.h"
+
+#include <QtCore>
+#include <QtGui>
+
+#include <cstring>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+
+// The vertex data is copied as-is from/to QVector3D arrays.
+static_assert(sizeof(QVector3D) == 3 * sizeof(float));
+
+static const qint64 sFileHeaderSize = 4 * sizeof(quint32);
+static const qint64 sGroupHeaderSize = 4 * sizeof(double) + 2 * sizeof(quint32);
+
+template <typename T>
+static void appendValue(QByteArray& data, T value) noexcept {
+  data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T readValue(const char*& data) noexcept {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  data += sizeof(T);
+  return value;
+}
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+TesselationCache::TesselationCache(const FilePath& dir, qint64 maxSize) noexcept
+  : mDir(dir),
+    mMaxSize(maxSize),
+    mSettingsId(OccModel::getTesselationSettingsId().toUtf8()),
+    mHits(0),
+    mMisses(0),
+    mMutex(),
+    mTotalSize(-1) {
+}
+
+TesselationCache::~TesselationCache() noexcept {
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+std::optional<TesselationCache::Model> TesselationCache::load(
+    const QByteArray& stepContent) noexcept {
+  std::optional<Model> model;
+  QFile file(getFilePath(stepContent).toStr());
+  if (file.open(QIODevice::ReadOnly)) {
+    const qint64 size = file.size();
+    if (uchar* data = file.map(0, size)) {
+      model = deserialize(reinterpret_cast<const char*>(data), size);
+      file.unmap(data);
+    }
+    file.close();
+    if (model) {
+      // Remember the last usage for pruning the least recently used entries.
+      // Note that on Windows, setting the file time requires write access.
+      if ((!file.open(QIODevice::ReadWrite)) ||
+          (!file.setFileTime(QDateTime::currentDateTime(),
+                             QFileDevice::FileModificationTime))) {
+        qWarning() << "Failed to update modification time of tesselation "
+                      "cache file:"
+                   << file.fileName() << file.errorString();
+      }
+    } else {
+      qWarning() << "Ignoring invalid tesselation cache file:"
+                 << file.fileName();
+    }
+  }
+  if (model) {
+    ++mHits;
+  } else {
+    ++mMisses;
+  }
+  return model;
+}
+
+void TesselationCache::store(const QByteArray& stepContent,
+                             const Model& model) noexcept {
+  try {
+    const QByteArray data = serialize(model);
+    FileUtils::writeFile(getFilePath(stepContent), data);  // can throw
+
+    QMutexLocker lock(&mMutex);
+    if (mTotalSize < 0) {
+      pruneLocked(mMaxSize);  // Determines the current total size.
+    } else if ((mTotalSize += data.size()) > mMaxSize) {
+      // Prune a bit more than needed to avoid pruning on every write.
+      pruneLocked((mMaxSize * 3) / 4);
+    }
+  } catch (const Exception& e) {
+    qWarning() << "Failed to write tesselation cache file:" << e.getMsg();
+  }
+}
+
+void TesselationCache::prune(qint64 maxSize) noexcept {
+  QMutexLocker lock(&mMutex);
+  pruneLocked(maxSize);
+}
+
+void TesselationCache::clear() noexcept {
+  prune(0);
+}
+
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+QByteArray TesselationCache::serialize(const Model& model) noexcept {
+  qint64 size = sFileHeaderSize + model.count() * sGroupHeaderSize;
+  for (const QVector<QVector3D>& vertices : model) {
+    size += vertices.count() * sizeof(QVector3D);
+  }
+
+  QByteArray data;
+  data.reserve(size);
+  appendValue<quint32>(data, sMagic);
+  appendValue<quint32>(data, sFormatVersion);
+  appendValue<quint32>(data, model.count());
+  appendValue<quint32>(data, 0);  // Reserved.
+  for (auto it = model.begin(); it != model.end(); it++) {
+    appendValue<double>(data, std::get<0>(it.key()));
+    appendValue<double>(data, std::get<1>(it.key()));
+    appendValue<double>(data, std::get<2>(it.key()));
+    appendValue<double>(data, std::get<3>(it.key()));
+    appendValue<quint32>(data, it.value().count());
+    appendValue<quint32>(data, 0);  // Reserved.
+  }
+  for (const QVector<QVector3D>& vertices : model) {
+    data.append(reinterpret_cast<const char*>(vertices.constData()),
+                vertices.count() * sizeof(QVector3D));
+  }
+  Q_ASSERT(data.size() == size);
+  return data;
+}
+
+std::optional<TesselationCache::Model> TesselationCache::deserialize(
+    const char* data, qint64 size) noexcept {
+  if (size < sFileHeaderSize) {
+    return std::nullopt;
+  }
+  const char* p = data;
+  const quint32 magic = readValue<quint32>(p);
+  const quint32 version = readValue<quint32>(p);
+  const quint32 groupCount = readValue<quint32>(p);
+  readValue<quint32>(p);  // Reserved.
+  if ((magic != sMagic) || (version != sFormatVersion) ||
+      (size < (sFileHeaderSize + groupCount * sGroupHeaderSize))) {
+    return std::nullopt;
+  }
+
+  QVector<std::pair<OccModel::Color, quint32>> groups;
+  qint64 expectedSize = sFileHeaderSize + groupCount * sGroupHeaderSize;
+  for (quint32 i = 0; i < groupCount; ++i) {
+    const double r = readValue<double>(p);
+    const double g = readValue<double>(p);
+    const double b = readValue<double>(p);
+    const double a = readValue<double>(p);
+    const quint32 vertexCount = readValue<quint32>(p);
+    readValue<quint32>(p);  // Reserved.
+    groups.append(std::make_pair(std::make_tuple(r, g, b, a), vertexCount));
+    expectedSize += qint64(vertexCount) * sizeof(QVector3D);
+  }
+  if (size != expectedSize) {
+    return std::nullopt;
+  }
+
+  Model model;
+  for (const auto& group : groups) {
+    QVector<QVector3D>& vertices = model[group.first];
+    if (group.second > 0) {
+      vertices.resize(group.second);
+      std::memcpy(vertices.data(), p, group.second * sizeof(QVector3D));
+      p += group.second * sizeof(QVector3D);
+    }
+  }
+  return model;
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+FilePath TesselationCache::getFilePath(
+    const QByteArray& stepContent) const noexcept {
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  hash.addData(mSettingsId);
+  hash.addData(QByteArray(1, '\0'));
+  hash.addData(stepContent);
+  return mDir.getPathTo(QString(hash.result().toHex()) + ".bin");
+}
+
+void TesselationCache::pruneLocked(qint64 maxSize) noexcept {
+  // Oldest (least recently used) files first.
+  const QFileInfoList files =
+      QDir(mDir.toStr())
+          .entryInfoList({"*.bin"}, QDir::Files, QDir::Time | QDir::Reversed);
+  qint64 totalSize = 0;
+  for (const QFileInfo& info : files) {
+    totalSize += info.size();
+  }
+  int removedCount = 0;
+  for (const QFileInfo& info : files) {
+    if (totalSize <= maxSize) {
+      break;
+    }
+    if (QFile::remove(info.absoluteFilePath())) {
+      totalSize -= info.size();
+      ++removedCount;
+    }
+  }
+  if (removedCount > 0) {
+    qDebug() << "Removed" << removedCount
+             << "entries from the tesselation cache.";
+  }
+  mTotalSize = totalSize;
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
@@ -0,0 +1,152 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_CORE_TESSELATIONCACHE_H
+#define LIBREPCB_CORE_TESSELATIONCACHE_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "../fileio/filepath.h"
+#include "occmodel.h"
+
+#include <QtCore>
+#include <QtGui>
+
+#include <atomic>
+#include <optional>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+
+/*******************************************************************************
+ *  Class TesselationCache
+ ******************************************************************************/
+
+/**
+ * @brief Persistent on-disk cache for tesselated STEP models
+ *
+ * Tesselating STEP models with OpenCascade is slow, so the 3D viewer stores
+ * the results (triangle vertices grouped by color) in this cache. Each model
+ * is stored in a separate file named by the SHA-256 hash of the STEP content
+ * and ::librepcb::OccModel::getTesselationSettingsId(), thus any change of
+ * the tesselation parameters automatically invalidates old entries.
+ *
+ * The files use a compact native-endian binary format which is memory-mapped
+ * on load, so the vertex data can be copied without any parsing:
+ *
+ *   - Header: Magic number, format version, number of color groups
+ *   - For each color group: RGBA color (4x double), number of vertices
+ *   - For each color group: Vertices (3x float each)
+ *
+ * When the total size of all files exceeds the configured limit, the least
+ * recently used entries are removed. Invalid or truncated files are treated
+ * as cache misses.
+ *
+ * @note All methods are thread-safe, and multiple instances may operate on
+ *       the same directory.
+ */
+class TesselationCache final {
+  Q_DECLARE_TR_FUNCTIONS(TesselationCache)
+
+public:
+  // Types
+  typedef QMap<OccModel::Color, QVector<QVector3D>> Model;
+
+  // Constructors / Destructor
+  TesselationCache() = delete;
+  TesselationCache(const TesselationCache& other) = delete;
+  explicit TesselationCache(const FilePath& dir,
+                            qint64 maxSize = 256 * 1024 * 1024) noexcept;
+  ~TesselationCache() noexcept;
+
+  // Getters
+  const FilePath& getDirectory() const noexcept { return mDir; }
+  qint64 getMaxSize() const noexcept { return mMaxSize; }
+  int getHitCount() const noexcept { return mHits; }
+  int getMissCount() const noexcept { return mMisses; }
+
+  // General Methods
+
+  /**
+   * @brief Look up the tesselation of a STEP model
+   *
+   * @param stepContent   Content of the STEP file.
+   *
+   * @return The cached tesselation, or `std::nullopt` if not cached.
+   */
+  std::optional<Model> load(const QByteArray& stepContent) noexcept;
+
+  /**
+   * @brief Add the tesselation of a STEP model to the cache
+   *
+   * Errors are only logged since the cache is not essential.
+   *
+   * @param stepContent   Content of the STEP file.
+   * @param model         Tesselation of the STEP file.
+   */
+  void store(const QByteArray& stepContent, const Model& model) noexcept;
+
+  /**
+   * @brief Remove the least recently used entries exceeding the size limit
+   *
+   * @param maxSize       Maximum total size in bytes to keep.
+   */
+  void prune(qint64 maxSize) noexcept;
+
+  /**
+   * @brief Remove all cached entries
+   */
+  void clear() noexcept;
+
+  // Operator Overloadings
+  TesselationCache& operator=(const TesselationCache& rhs) = delete;
+
+  // Static Methods
+  static QByteArray serialize(const Model& model) noexcept;
+  static std::optional<Model> deserialize(const char* data,
+                                          qint64 size) noexcept;
+
+private:  // Methods
+  FilePath getFilePath(const QByteArray& stepContent) const noexcept;
+  void pruneLocked(qint64 maxSize) noexcept;
+
+private:  // Data
+  const FilePath mDir;
+  const qint64 mMaxSize;
+  const QByteArray mSettingsId;
+  std::atomic<int> mHits;
+  std::atomic<int> mMisses;
+
+  QMutex mMutex;
+  qint64 mTotalSize;  ///< Estimated total size, -1 if not determined yet
+
+  static constexpr quint32 sMagic = 0x4354504C;  // "LPTC" (little endian)
+  static constexpr quint32 sFormatVersion = 1;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
+
+#endif
@@ -22,7 +22,8 @@
  ******************************************************************************/
 #include "airwiresbuilder.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <numeric>
 
 #include <QtCore>
 
@@ -79,116 +80,23 @@ public:
       mEdges.insert(mEdges.end(), del.getEdges().begin(), del.getEdges().end());
     }
 
-    // determine weights of these new edges
-    for (uint i = connectedEdges; i < mEdges.size(); ++i) {
-      mEdges[i].weight = mEdges[i].p1.dist2(mEdges[i].p2);
+    // convert to the flat edge list with weights, where negative weights
+    // denote edges which are already connected
+    QVector<AirWiresBuilder::Edge> edges;
+    edges.reserve(mEdges.size());
+    for (std::size_t i = 0; i < mEdges.size(); ++i) {
+      const delaunay::Edge<qreal>& edge = mEdges[i];
+      edges.append(AirWiresBuilder::Edge{
+          edge.p1.id, edge.p2.id,
+          (i < connectedEdges) ? qreal(-1) : edge.p1.dist2(edge.p2)});
     }
 
     // find airwires in list of edges
-    return kruskalMst();
+    return AirWiresBuilder::buildMinimumSpanningTree(mPoints.size(), edges);
   }
 
   AirWiresBuilderImpl& operator=(const AirWiresBuilderImpl& rhs) = delete;
 
-private:  // Methods
-  // adapted from horizon/kicad
-  AirWiresBuilder::AirWires kruskalMst() noexcept {
-    unsigned int nodeNumber = mPoints.size();
-    unsigned int mstExpectedSize = nodeNumber - 1;
-    unsigned int mstSize = 0;
-    bool ratsnestLines = false;
-
-    // printf("mst nodes : %d edges : %d\n", mPoints.size(), mEdges.size () );
-    // The output
-    AirWiresBuilder::AirWires mst;
-
-    // Set tags for marking cycles
-    std::unordered_map<int, int> tags;
-    unsigned int tag = 0;
-
-    for (auto& node : mPoints) {
-      node.tag = tag;
-      tags[node.id] = tag++;
-    }
-
-    // Lists of nodes connected together (subtrees) to detect cycles in the
-    // graph
-    std::vector<std::list<int>> cycles(nodeNumber);
-
-    for (unsigned int i = 0; i < nodeNumber; ++i) cycles[i].push_back(i);
-
-    // Kruskal algorithm requires edges to be sorted by their weight
-    std::sort(
-        mEdges.begin(), mEdges.end(),
-        [](const delaunay::Edge<qreal>& a, const delaunay::Edge<qreal>& b) {
-          return a.weight > b.weight;
-        });
-
-    while (mstSize < mstExpectedSize && !mEdges.empty()) {
-      auto& dt = mEdges.back();
-
-      int srcTag = tags[dt.p1.id];
-      int trgTag = tags[dt.p2.id];
-      // printf("mstSize %d %d %f %d<>%d\n", mstSize, mstExpectedSize,
-      // dt.weight, srcTag, trgTag);
-
-      // Check if by adding this edge we are going to join two different
-      // forests
-      if (srcTag != trgTag) {
-        // Because edges are sorted by their weight, first we always process
-        // connected
-        // items (weight == 0). Once we stumble upon an edge with non-zero
-        // weight,
-        // it means that the rest of the lines are ratsnest.
-        if (!ratsnestLines && dt.weight >= 0) ratsnestLines = true;
-
-        // Update tags
-        if (ratsnestLines) {
-          for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end();
-               ++it) {
-            tags[mPoints[*it].id] = srcTag;
-          }
-
-          // Do a copy of edge, but make it RN_EDGE_MST. In contrary to
-          // RN_EDGE,
-          // RN_EDGE_MST saves both source and target node and does not
-          // require any other
-          // edges to exist for getting source/target nodes
-          // CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(),
-          // dt.GetWeight() );
-
-          // assert( newEdge.GetSourceNode()->GetTag() !=
-          // newEdge.GetTargetNode()->GetTag() );
-          // assert(dt.p1.tag != dt.p2.tag);
-          mst.append(std::make_pair(dt.p1.id, dt.p2.id));
-          ++mstSize;
-        } else {
-          // for( it = cycles[trgTag].begin(), itEnd =
-          // cycles[trgTag].end(); it != itEnd; ++it )
-          // for( auto it : cycles[trgTag] )
-          for (auto it = cycles[trgTag].begin(); it != cycles[trgTag].end();
-               ++it) {
-            tags[mPoints[*it].id] = srcTag;
-            mPoints[*it].tag = srcTag;
-          }
-
-          // Processing a connection, decrease the expected size of the
-          // ratsnest MST
-          --mstExpectedSize;
-        }
-
-        // Move nodes that were marked with old tag to the list marked with
-        // the new tag
-        cycles[srcTag].splice(cycles[srcTag].end(), cycles[trgTag]);
-      }
-
-      // Remove the edge that was just processed
-      mEdges.pop_back();
-    }
-
-    return mst;
-  }
-
 private:  // Data
   std::vector<delaunay::Vector2<qreal>> mPoints;
   std::vector<delaunay::Edge<qreal>> mEdges;
@@ -220,6 +128,58 @@ AirWiresBuilder::AirWires AirWiresBuilder::buildAirWires() noexcept {
   return mImpl->buildAirWires();
 }
 
+/*******************************************************************************
+ *  Static Methods
+ ******************************************************************************/
+
+AirWiresBuilder::AirWires AirWiresBuilder::buildMinimumSpanningTree(
+    int pointCount, QVector<Edge> edges) noexcept {
+  // Kruskal algorithm requires edges to be sorted by their weight. Already
+  // connected edges (negative weight) come first, so they join their points
+  // without creating airwires. Sorting stable keeps the result deterministic
+  // for edges of equal weight.
+  std::stable_sort(edges.begin(), edges.end(),
+                   [](const Edge& a, const Edge& b) {
+                     return a.weight < b.weight;
+                   });
+
+  // Disjoint-set forest to detect cycles in the graph, with path halving and
+  // union by size to keep the trees flat.
+  std::vector<int> parents(std::max(pointCount, 0));
+  std::vector<int> sizes(parents.size(), 1);
+  std::iota(parents.begin(), parents.end(), 0);
+  auto findRoot = [&parents](int i) {
+    while (parents[i] != i) {
+      parents[i] = parents[parents[i]];
+      i = parents[i];
+    }
+    return i;
+  };
+
+  AirWires mst;
+  int components = pointCount;
+  for (const Edge& edge : edges) {
+    if (components <= 1) {
+      break;  // All points are connected, no more airwires needed.
+    }
+    int root1 = findRoot(edge.p1);
+    int root2 = findRoot(edge.p2);
+    if (root1 == root2) {
+      continue;  // Would create a cycle.
+    }
+    if (sizes[root1] < sizes[root2]) {
+      std::swap(root1, root2);
+    }
+    parents[root2] = root1;
+    sizes[root1] += sizes[root2];
+    --components;
+    if (edge.weight >= 0) {
+      mst.append(std::make_pair(edge.p1, edge.p2));
+    }
+  }
+  return mst;
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -48,6 +48,11 @@ public:
   // Types
   typedef std::pair<int, int> AirWire;
   typedef QVector<AirWire> AirWires;
+  struct Edge {
+    int p1;  ///< ID of first point
+    int p2;  ///< ID of second point
+    qreal weight;  ///< Negative if the points are already connected
+  };
 
   // Constructors / Destructor
 
@@ -92,6 +97,23 @@ public:
    */
   AirWires buildAirWires() noexcept;
 
+  // Static Methods
+
+  /**
+   * @brief Calculate the minimum spanning tree of a graph
+   *
+   * Uses Kruskal's algorithm with a disjoint-set forest, thus it runs in
+   * O(E log E) for E edges.
+   *
+   * @param pointCount  Number of points (IDs must be 0..pointCount-1)
+   * @param edges       All candidate edges, including those which are
+   *                    already connected (negative weight)
+   *
+   * @return Edges of the minimum spanning tree which are not connected yet
+   */
+  static AirWires buildMinimumSpanningTree(int pointCount,
+                                           QVector<Edge> edges) noexcept;
+
   // Operator overloadings
   AirWiresBuilder& operator=(const AirWiresBuilder& rhs) = delete;
 
@@ -0,0 +1,267 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "boundingboxindex.h"
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+
+// Limits to keep the grid memory bounded also for degenerated input data.
+static constexpr int sMaxCellsPerAxis = 2048;
+static constexpr qint64 sMaxCellsPerItem = 64;
+
+/*******************************************************************************
+ *  Struct BoundingBoxIndex::Rect
+ ******************************************************************************/
+
+BoundingBoxIndex::Rect BoundingBoxIndex::Rect::fromPaths(
+    const ClipperLib::Paths& paths) noexcept {
+  Rect rect;
+  bool first = true;
+  for (const ClipperLib::Path& path : paths) {
+    for (const ClipperLib::IntPoint& p : path) {
+      if (first) {
+        rect = Rect{p.X, p.Y, p.X, p.Y};
+        first = false;
+      } else {
+        rect.minX = std::min(rect.minX, static_cast<qint64>(p.X));
+        rect.minY = std::min(rect.minY, static_cast<qint64>(p.Y));
+        rect.maxX = std::max(rect.maxX, static_cast<qint64>(p.X));
+        rect.maxY = std::max(rect.maxY, static_cast<qint64>(p.Y));
+      }
+    }
+  }
+  return rect;
+}
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+BoundingBoxIndex::BoundingBoxIndex() noexcept
+  : mItems(),
+    mGridValid(false),
+    mOriginX(0),
+    mOriginY(0),
+    mCellSize(1),
+    mCellCountX(0),
+    mCellCountY(0),
+    mCells(),
+    mLargeItems(),
+    mComparisonCount(0) {
+}
+
+BoundingBoxIndex::~BoundingBoxIndex() noexcept {
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+void BoundingBoxIndex::insert(int id, const Rect& rect) noexcept {
+  if (rect.isValid()) {
+    mItems.append(Item{id, rect});
+    mGridValid = false;
+  }
+}
+
+void BoundingBoxIndex::clear() noexcept {
+  mItems.clear();
+  mCells.clear();
+  mLargeItems.clear();
+  mGridValid = false;
+}
+
+QVector<int> BoundingBoxIndex::query(const Rect& rect) noexcept {
+  QVector<int> result;
+  if (!rect.isValid()) {
+    return result;
+  }
+  buildGrid();
+
+  QVector<int> indices = mLargeItems;
+  const int x0 = cellX(rect.minX);
+  const int x1 = cellX(rect.maxX);
+  const int y0 = cellY(rect.minY);
+  const int y1 = cellY(rect.maxY);
+  if ((qint64(x1 - x0 + 1) * qint64(y1 - y0 + 1)) > mCells.count()) {
+    // Cheaper to iterate over the non-empty cells than the covered cells.
+    for (auto it = mCells.begin(); it != mCells.end(); it++) {
+      indices += it.value();
+    }
+  } else {
+    for (int x = x0; x <= x1; ++x) {
+      for (int y = y0; y <= y1; ++y) {
+        auto it = mCells.constFind(cellKey(x, y));
+        if (it != mCells.constEnd()) {
+          indices += it.value();
+        }
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  mComparisonCount += indices.count();
+  for (int index : indices) {
+    const Item& item = mItems.at(index);
+    if (item.rect.overlaps(rect)) {
+      result.append(item.id);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+QVector<BoundingBoxIndex::Pair>
+    BoundingBoxIndex::findOverlappingPairs() noexcept {
+  QVector<Pair> pairs;
+  buildGrid();
+
+  auto addPair = [&pairs](int id1, int id2) {
+    pairs.append(std::make_pair(std::min(id1, id2), std::max(id1, id2)));
+  };
+
+  // Pairs of items within the same cell. Two overlapping items may share
+  // several cells, but the bottom left corner of their intersection lies in
+  // exactly one of them. Reporting the pair only in that cell avoids
+  // duplicates without any additional bookkeeping.
+  for (auto it = mCells.begin(); it != mCells.end(); it++) {
+    const QVector<int>& indices = it.value();
+    mComparisonCount += (qint64(indices.count()) * (indices.count() - 1)) / 2;
+    for (int i = 0; i < indices.count(); ++i) {
+      const Item& item1 = mItems.at(indices.at(i));
+      for (int k = i + 1; k < indices.count(); ++k) {
+        const Item& item2 = mItems.at(indices.at(k));
+        if (item1.rect.overlaps(item2.rect)) {
+          const int x = cellX(std::max(item1.rect.minX, item2.rect.minX));
+          const int y = cellY(std::max(item1.rect.minY, item2.rect.minY));
+          if (cellKey(x, y) == it.key()) {
+            addPair(item1.id, item2.id);
+          }
+        }
+      }
+    }
+  }
+
+  // Large items are compared against all other items. If both items are
+  // large, only compare them once.
+  QVector<bool> isLarge(mItems.count(), false);
+  for (int index : mLargeItems) {
+    isLarge[index] = true;
+  }
+  for (int index1 : mLargeItems) {
+    const Item& item1 = mItems.at(index1);
+    for (int index2 = 0; index2 < mItems.count(); ++index2) {
+      if ((index2 == index1) || (isLarge.at(index2) && (index2 < index1))) {
+        continue;
+      }
+      const Item& item2 = mItems.at(index2);
+      ++mComparisonCount;
+      if (item1.rect.overlaps(item2.rect)) {
+        addPair(item1.id, item2.id);
+      }
+    }
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void BoundingBoxIndex::buildGrid() noexcept {
+  if (mGridValid) {
+    return;
+  }
+
+  mCells.clear();
+  mLargeItems.clear();
+  mGridValid = true;
+  if (mItems.isEmpty()) {
+    return;
+  }
+
+  // Determine the grid bounds and the average item size.
+  Rect bounds = mItems.first().rect;
+  qreal averageSize = 0;
+  for (const Item& item : mItems) {
+    bounds.minX = std::min(bounds.minX, item.rect.minX);
+    bounds.minY = std::min(bounds.minY, item.rect.minY);
+    bounds.maxX = std::max(bounds.maxX, item.rect.maxX);
+    bounds.maxY = std::max(bounds.maxY, item.rect.maxY);
+    averageSize += (qreal(item.rect.maxX - item.rect.minX) +
+                    qreal(item.rect.maxY - item.rect.minY)) /
+        (2 * mItems.count());
+  }
+
+  // Use the average item size as cell size, so most items cover only a few
+  // cells. But limit the number of cells for very sparse data.
+  mOriginX = bounds.minX;
+  mOriginY = bounds.minY;
+  mCellSize = std::max(static_cast<qint64>(averageSize), qint64(1));
+  mCellSize = std::max(
+      mCellSize, (bounds.maxX - bounds.minX) / sMaxCellsPerAxis + qint64(1));
+  mCellSize = std::max(
+      mCellSize, (bounds.maxY - bounds.minY) / sMaxCellsPerAxis + qint64(1));
+  mCellCountX = static_cast<int>((bounds.maxX - mOriginX) / mCellSize) + 1;
+  mCellCountY = static_cast<int>((bounds.maxY - mOriginY) / mCellSize) + 1;
+
+  // Sort items into cells.
+  for (int i = 0; i < mItems.count(); ++i) {
+    const Rect& rect = mItems.at(i).rect;
+    const int x0 = cellX(rect.minX);
+    const int x1 = cellX(rect.maxX);
+    const int y0 = cellY(rect.minY);
+    const int y1 = cellY(rect.maxY);
+    if ((qint64(x1 - x0 + 1) * qint64(y1 - y0 + 1)) > sMaxCellsPerItem) {
+      mLargeItems.append(i);
+    } else {
+      for (int x = x0; x <= x1; ++x) {
+        for (int y = y0; y <= y1; ++y) {
+          mCells[cellKey(x, y)].append(i);
+        }
+      }
+    }
+  }
+}
+
+int BoundingBoxIndex::cellX(qint64 x) const noexcept {
+  const qint64 cell = (x - mOriginX) / mCellSize;
+  return static_cast<int>(qBound(qint64(0), cell, qint64(mCellCountX - 1)));
+}
+
+int BoundingBoxIndex::cellY(qint64 y) const noexcept {
+  const qint64 cell = (y - mOriginY) / mCellSize;
+  return static_cast<int>(qBound(qint64(0), cell, qint64(mCellCountY - 1)));
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
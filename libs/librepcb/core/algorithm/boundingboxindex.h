@@ -0,0 +1,156 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_CORE_BOUNDINGBOXINDEX_H
+#define LIBREPCB_CORE_BOUNDINGBOXINDEX_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <polyclipping/clipper.hpp>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+
+/*******************************************************************************
+ *  Class BoundingBoxIndex
+ ******************************************************************************/
+
+/**
+ * @brief Spatial index to quickly find overlapping axis-aligned bounding boxes
+ *
+ * The boxes are sorted into a uniform grid whose cell size is derived from
+ * the average box size. Boxes which would span a large number of cells (e.g.
+ * planes) are kept in a separate list and are compared against every other
+ * box instead. For typical board data (many small objects, few large ones)
+ * this makes finding all overlapping pairs roughly linear in the number of
+ * boxes, compared to a quadratic nested loop.
+ *
+ * Usage: Add all boxes with #insert(), then call #findOverlappingPairs() or
+ * #query(). The grid is (re)built lazily after any modification.
+ */
+class BoundingBoxIndex final {
+public:
+  // Types
+  struct Rect {
+    qint64 minX = 0;
+    qint64 minY = 0;
+    qint64 maxX = -1;  // Invalid (empty) by default.
+    qint64 maxY = -1;  // Invalid (empty) by default.
+
+    bool isValid() const noexcept { return (maxX >= minX) && (maxY >= minY); }
+    bool overlaps(const Rect& other) const noexcept {
+      return (minX <= other.maxX) && (other.minX <= maxX) &&
+          (minY <= other.maxY) && (other.minY <= maxY);
+    }
+    static Rect fromPaths(const ClipperLib::Paths& paths) noexcept;
+  };
+  typedef std::pair<int, int> Pair;
+
+  // Constructors / Destructor
+  BoundingBoxIndex() noexcept;
+  ~BoundingBoxIndex() noexcept;
+
+  // Getters
+  int getCount() const noexcept { return mItems.count(); }
+
+  /**
+   * @brief Get the number of box comparisons executed so far
+   *
+   * Counts all overlap tests done by #query() and #findOverlappingPairs()
+   * since construction. Intended to verify the complexity of the algorithm
+   * without relying on timings.
+   *
+   * @return Number of box comparisons.
+   */
+  qint64 getComparisonCount() const noexcept { return mComparisonCount; }
+
+  // General Methods
+
+  /**
+   * @brief Add a bounding box
+   *
+   * @param id    Arbitrary ID of the box, will be returned by the queries.
+   * @param rect  The bounding box. Invalid boxes are silently ignored since
+   *              they cannot overlap with anything.
+   */
+  void insert(int id, const Rect& rect) noexcept;
+
+  /**
+   * @brief Remove all boxes
+   */
+  void clear() noexcept;
+
+  /**
+   * @brief Find all boxes overlapping with a given rect
+   *
+   * @param rect  The rect to look for.
+   *
+   * @return IDs of all overlapping boxes, sorted ascending.
+   */
+  QVector<int> query(const Rect& rect) noexcept;
+
+  /**
+   * @brief Find all pairs of overlapping boxes
+   *
+   * @return All pairs of overlapping boxes. Each pair is reported only
+   *         once, with the lower ID as first element. The list is sorted
+   *         ascending.
+   */
+  QVector<Pair> findOverlappingPairs() noexcept;
+
+private:  // Methods
+  void buildGrid() noexcept;
+  int cellX(qint64 x) const noexcept;
+  int cellY(qint64 y) const noexcept;
+  static quint64 cellKey(int x, int y) noexcept {
+    return (static_cast<quint64>(x) << 32) | static_cast<quint32>(y);
+  }
+
+private:  // Data
+  struct Item {
+    int id;
+    Rect rect;
+  };
+  QVector<Item> mItems;
+
+  // Grid, built lazily.
+  bool mGridValid;
+  qint64 mOriginX;
+  qint64 mOriginY;
+  qint64 mCellSize;
+  int mCellCountX;
+  int mCellCountY;
+  QHash<quint64, QVector<int>> mCells;  // Indices into mItems.
+  QVector<int> mLargeItems;  // Indices into mItems, not contained in mCells.
+
+  qint64 mComparisonCount;  // Statistics.
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
+
+#endif
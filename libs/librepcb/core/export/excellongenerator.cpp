@@ -26,6 +26,7 @@
 #include "../fileio/fileutils.h"
 #include "../types/point.h"
 #include "../utils/toolbox.h"
+#include "gerberoutputstream.h"
 
 #include <QtCore>
 
@@ -44,7 +45,7 @@ ExcellonGenerator::ExcellonGenerator(const QDateTime& creationDate,
                                      const QString& projRevision,
                                      Plating plating, int fromLayer,
                                      int toLayer) noexcept
-  : mPlating(plating), mFileAttributes(), mUseG85Slots(false), mOutput() {
+  : mPlating(plating), mFileAttributes(), mUseG85Slots(false) {
   mFileAttributes.append(GerberAttribute::fileGenerationSoftware(
       "LibrePCB", "LibrePCB", Application::getVersion()));
   mFileAttributes.append(GerberAttribute::fileCreationDate(creationDate));
@@ -99,41 +100,52 @@ void ExcellonGenerator::drill(const NonEmptyPath& path,
   mDrillList.insert(tool, path);
 }
 
-void ExcellonGenerator::generate() {
-  mOutput.clear();
-  printHeader();
-  printDrills();
-  printFooter();
+void ExcellonGenerator::generate(QIODevice& device) const {
+  GerberOutputStream s(&device);
+  printHeader(s);
+  printDrills(s);  // can throw
+  printFooter(s);
+  s.flush();  // can throw
+}
+
+QByteArray ExcellonGenerator::generate() const {
+  QByteArray output;
+  QBuffer buffer(&output);
+  buffer.open(QIODevice::WriteOnly);
+  generate(buffer);  // can throw
+  return output;
 }
 
 void ExcellonGenerator::saveToFile(const FilePath& filepath) const {
-  FileUtils::writeFile(filepath, mOutput.toLatin1());  // can throw
+  FileUtils::writeFile(filepath, [this](QIODevice& device) {
+    generate(device);  // can throw
+  });  // can throw
 }
 
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
 
-void ExcellonGenerator::printHeader() noexcept {
-  mOutput.append("M48\n");  // Beginning of Part Program Header
+void ExcellonGenerator::printHeader(GerberOutputStream& s) const noexcept {
+  s.write("M48\n");  // Beginning of Part Program Header
 
   // Add file attributes.
   foreach (const GerberAttribute& a, mFileAttributes) {
-    mOutput.append(a.toExcellonString());
+    s.write(a.toExcellonString().toLatin1());
   }
 
-  mOutput.append("FMAT,2\n");  // Use Format 2 commands
-  mOutput.append("METRIC,TZ\n");  // Metric Format, Trailing Zeros Mode
+  s.write("FMAT,2\n");  // Use Format 2 commands
+  s.write("METRIC,TZ\n");  // Metric Format, Trailing Zeros Mode
 
-  printToolList();
+  printToolList(s);
 
-  mOutput.append("%\n");  // Beginning of Pattern
-  mOutput.append("G90\n");  // Absolute Mode
-  mOutput.append("G05\n");  // Drill Mode
-  mOutput.append("M71\n");  // Metric Measuring Mode
+  s.write("%\n");  // Beginning of Pattern
+  s.write("G90\n");  // Absolute Mode
+  s.write("G05\n");  // Drill Mode
+  s.write("M71\n");  // Metric Measuring Mode
 }
 
-void ExcellonGenerator::printToolList() noexcept {
+void ExcellonGenerator::printToolList(GerberOutputStream& s) const noexcept {
   const auto tools = mDrillList.uniqueKeys();
   for (int i = 0; i < tools.count(); ++i) {
     bool plated = std::get<1>(tools.at(i));
@@ -141,41 +153,44 @@ void ExcellonGenerator::printToolList() noexcept {
     GerberAttribute apertureFunctionAttribute = (mPlating == Plating::Mixed)
         ? GerberAttribute::apertureFunctionMixedPlatingDrill(plated, function)
         : GerberAttribute::apertureFunction(function);
-    mOutput.append(apertureFunctionAttribute.toExcellonString());
+    s.write(apertureFunctionAttribute.toExcellonString().toLatin1());
 
     Length dia = std::get<0>(tools.at(i));
-    mOutput.append(QString("T%1C%2\n").arg(i + 1).arg(dia.toMmString()));
+    s.write('T').writeInteger(i + 1).write('C').writeMm(dia).write('\n');
   }
 }
 
-void ExcellonGenerator::printDrills() {
-  for (int i = 0; i < mDrillList.uniqueKeys().count(); ++i) {
-    mOutput.append(QString("T%1\n").arg(i + 1));  // Select Tool
-    auto tool = mDrillList.uniqueKeys().value(i);
-    foreach (const NonEmptyPath& path, mDrillList.values(tool)) {
-      printPath(path);
+void ExcellonGenerator::printDrills(GerberOutputStream& s) const {
+  const auto tools = mDrillList.uniqueKeys();
+  for (int i = 0; i < tools.count(); ++i) {
+    s.write('T').writeInteger(i + 1).write('\n');  // Select Tool
+    const auto range = mDrillList.equal_range(tools.at(i));
+    for (auto it = range.first; it != range.second; ++it) {
+      printPath(s, *it);  // can throw
     }
   }
 }
 
-void ExcellonGenerator::printPath(const NonEmptyPath& path) {
+void ExcellonGenerator::printPath(GerberOutputStream& s,
+                                  const NonEmptyPath& path) const {
   if (path->getVertices().count() < 1) {
     qCritical() << "Empty path in Excellon export ignored!";
   } else if (path->getVertices().count() == 1) {
-    printDrill(path->getVertices().first().getPos());
+    printDrill(s, path->getVertices().first().getPos());
   } else if (mUseG85Slots) {
-    printSlot(path);
+    printSlot(s, path);  // can throw
   } else {
-    printRout(path);
+    printRout(s, path);
   }
 }
 
-void ExcellonGenerator::printDrill(const Point& pos) noexcept {
-  mOutput.append(QString("X%1Y%2\n")
-                     .arg(pos.getX().toMmString(), pos.getY().toMmString()));
+void ExcellonGenerator::printDrill(GerberOutputStream& s,
+                                   const Point& pos) const noexcept {
+  s.write('X').writeMm(pos.getX()).write('Y').writeMm(pos.getY()).write('\n');
 }
 
-void ExcellonGenerator::printSlot(const NonEmptyPath& path) {
+void ExcellonGenerator::printSlot(GerberOutputStream& s,
+                                  const NonEmptyPath& path) const {
   for (int i = 1; i < path->getVertices().count(); ++i) {
     const Vertex& v0 = path->getVertices().at(i - 1);
     const Vertex& v1 = path->getVertices().at(i);
@@ -185,73 +200,76 @@ void ExcellonGenerator::printSlot(const NonEmptyPath& path) {
           tr("Using the G85 slot command is not possible for curved slots. "
              "Either remove curved slots or disable the G85 export option."));
     }
-    mOutput.append(QString("X%1Y%2G85X%3Y%4\n")
-                       .arg(v0.getPos().getX().toMmString(),
-                            v0.getPos().getY().toMmString(),
-                            v1.getPos().getX().toMmString(),
-                            v1.getPos().getY().toMmString()));
+    s.write('X').writeMm(v0.getPos().getX());
+    s.write('Y').writeMm(v0.getPos().getY());
+    s.write("G85X").writeMm(v1.getPos().getX());
+    s.write('Y').writeMm(v1.getPos().getY()).write('\n');
   }
 }
 
-void ExcellonGenerator::printRout(const NonEmptyPath& path) noexcept {
-  printMoveTo(path->getVertices().first().getPos());
-  mOutput.append("M15\n");  // Z Axis Route Position
+void ExcellonGenerator::printRout(GerberOutputStream& s,
+                                  const NonEmptyPath& path) const noexcept {
+  printMoveTo(s, path->getVertices().first().getPos());
+  s.write("M15\n");  // Z Axis Route Position
   for (int i = 1; i < path->getVertices().count(); ++i) {
     const Vertex& v0 = path->getVertices().at(i - 1);
     const Vertex& v1 = path->getVertices().at(i);
     if (v0.getAngle() == 0) {
-      printLinearInterpolation(v1.getPos());
+      printLinearInterpolation(s, v1.getPos());
     } else if (v0.getAngle().abs() > Angle::deg180()) {
       // Split arc as recommended in the XNC format specification from Ucamco.
       if (auto center =
               Toolbox::arcCenter(v0.getPos(), v1.getPos(), v0.getAngle())) {
         const Angle halfAngle = v0.getAngle() / 2;
         const Point middlePos = v0.getPos().rotated(halfAngle, *center);
-        printCircularInterpolation(v0.getPos(), middlePos, halfAngle);
-        printCircularInterpolation(middlePos, v1.getPos(),
+        printCircularInterpolation(s, v0.getPos(), middlePos, halfAngle);
+        printCircularInterpolation(s, middlePos, v1.getPos(),
                                    v0.getAngle() - halfAngle);
       } else {
         // Fallback: Use single arc segment and hope the Excellon parser can
         // handle it.
         qCritical() << "Failed to split arc segment into two pieces for "
                        "ExcellonGenerator export!";
-        printCircularInterpolation(v0.getPos(), v1.getPos(), v0.getAngle());
+        printCircularInterpolation(s, v0.getPos(), v1.getPos(),
+                                   v0.getAngle());
       }
     } else {
-      printCircularInterpolation(v0.getPos(), v1.getPos(), v0.getAngle());
+      printCircularInterpolation(s, v0.getPos(), v1.getPos(), v0.getAngle());
     }
   }
-  mOutput.append("M16\n");  // Retract With Clamping
-  mOutput.append("G05\n");  // Drill Mode
+  s.write("M16\n");  // Retract With Clamping
+  s.write("G05\n");  // Drill Mode
 }
 
-void ExcellonGenerator::printMoveTo(const Point& pos) noexcept {
-  mOutput.append(QString("G00X%1Y%2\n")
-                     .arg(pos.getX().toMmString(), pos.getY().toMmString()));
+void ExcellonGenerator::printMoveTo(GerberOutputStream& s,
+                                    const Point& pos) const noexcept {
+  s.write("G00X").writeMm(pos.getX());
+  s.write('Y').writeMm(pos.getY()).write('\n');
 }
 
-void ExcellonGenerator::printLinearInterpolation(const Point& pos) noexcept {
-  mOutput.append(QString("G01X%1Y%2\n")
-                     .arg(pos.getX().toMmString(), pos.getY().toMmString()));
+void ExcellonGenerator::printLinearInterpolation(
+    GerberOutputStream& s, const Point& pos) const noexcept {
+  s.write("G01X").writeMm(pos.getX());
+  s.write('Y').writeMm(pos.getY()).write('\n');
 }
 
 void ExcellonGenerator::printCircularInterpolation(
-    const Point& from, const Point& to, const Angle& angle) noexcept {
-  const QString cmd = (angle < 0) ? "G02" : "G03";
+    GerberOutputStream& s, const Point& from, const Point& to,
+    const Angle& angle) const noexcept {
   std::optional<Length> radius = Toolbox::arcRadius(from, to, angle);
   if (!radius) {
     qCritical() << "Failed to calculate arc radius in ExcellonGenerator, will "
                    "apply clipping.";
     radius = Length::fromMm(1e6);
   }
-  mOutput.append(QString("%1X%2Y%3A%4\n")
-                     .arg(cmd, to.getX().toMmString(), to.getY().toMmString(),
-                          radius->abs().toMmString()));
+  s.write((angle < 0) ? "G02" : "G03");
+  s.write('X').writeMm(to.getX()).write('Y').writeMm(to.getY());
+  s.write('A').writeMm(radius->abs()).write('\n');
 }
 
-void ExcellonGenerator::printFooter() noexcept {
-  mOutput.append("T0\n");
-  mOutput.append("M30\n");  // End of Program Rewind
+void ExcellonGenerator::printFooter(GerberOutputStream& s) const noexcept {
+  s.write("T0\n");
+  s.write("M30\n");  // End of Program Rewind
 }
 
 /*******************************************************************************
@@ -35,6 +35,7 @@
  ******************************************************************************/
 namespace librepcb {
 
+class GerberOutputStream;
 class Point;
 
 /*******************************************************************************
@@ -63,33 +64,50 @@ public:
   // Setters
   void setUseG85Slots(bool use) noexcept { mUseG85Slots = use; }
 
-  // Getters
-  const QString& toStr() const noexcept { return mOutput; }
-
   // General Methods
   void drill(const Point& pos, const PositiveLength& dia, bool plated,
              Function function) noexcept;
   void drill(const NonEmptyPath& path, const PositiveLength& dia, bool plated,
              Function function) noexcept;
-  void generate();
+
+  /**
+   * @brief Generate the Excellon file and stream it into a device
+   *
+   * @param device  Device to write the file content to.
+   *
+   * @throws Exception if the drills could not be exported or writing to the
+   *                   device failed.
+   */
+  void generate(QIODevice& device) const;
+
+  /**
+   * @brief Generate the Excellon file in memory
+   *
+   * @return File content.
+   */
+  QByteArray generate() const;
+
   void saveToFile(const FilePath& filepath) const;
 
   // Operator Overloadings
   ExcellonGenerator& operator=(const ExcellonGenerator& rhs) = delete;
 
 private:
-  void printHeader() noexcept;
-  void printToolList() noexcept;
-  void printDrills();
-  void printPath(const NonEmptyPath& path);
-  void printDrill(const Point& pos) noexcept;
-  void printSlot(const NonEmptyPath& path);
-  void printRout(const NonEmptyPath& path) noexcept;
-  void printMoveTo(const Point& pos) noexcept;
-  void printLinearInterpolation(const Point& pos) noexcept;
-  void printCircularInterpolation(const Point& from, const Point& to,
-                                  const Angle& angle) noexcept;
-  void printFooter() noexcept;
+  void printHeader(GerberOutputStream& s) const noexcept;
+  void printToolList(GerberOutputStream& s) const noexcept;
+  void printDrills(GerberOutputStream& s) const;
+  void printPath(GerberOutputStream& s, const NonEmptyPath& path) const;
+  void printDrill(GerberOutputStream& s, const Point& pos) const noexcept;
+  void printSlot(GerberOutputStream& s, const NonEmptyPath& path) const;
+  void printRout(GerberOutputStream& s,
+                 const NonEmptyPath& path) const noexcept;
+  void printMoveTo(GerberOutputStream& s, const Point& pos) const noexcept;
+  void printLinearInterpolation(GerberOutputStream& s,
+                                const Point& pos) const noexcept;
+  void printCircularInterpolation(GerberOutputStream& s, const Point& from,
+                                  const Point& to,
+                                  const Angle& angle) const noexcept;
+  void printFooter(GerberOutputStream& s) const noexcept;
 
   // Types
   typedef std::tuple<Length, bool, Function> Tool;
@@ -102,7 +120,6 @@ private:
   bool mUseG85Slots;
 
   // Excellon Data
-  QString mOutput;
   QMultiMap<Tool, NonEmptyPath> mDrillList;
 };
 
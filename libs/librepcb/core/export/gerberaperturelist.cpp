@@ -23,6 +23,7 @@
 #include "gerberaperturelist.h"
 
 #include "gerberattributewriter.h"
+#include "gerberoutputstream.h"
 
 #include <QtCore>
 
@@ -45,8 +46,8 @@ GerberApertureList::~GerberApertureList() noexcept {
  *  Getters
  ******************************************************************************/
 
-QString GerberApertureList::generateString() const noexcept {
-  QString str;
+QByteArray GerberApertureList::generateString() const noexcept {
+  QByteArray str;
   GerberAttributeWriter attributeWriter;
   for (auto it = mApertures.constBegin(); it != mApertures.constEnd(); ++it) {
     // Set attributes.
@@ -54,16 +55,16 @@ QString GerberApertureList::generateString() const noexcept {
     if (Function function = it.value().first) {
       attributes.append(GerberAttribute::apertureFunction(*function));
     }
-    str.append(attributeWriter.setAttributes(attributes));
+    str.append(attributeWriter.setAttributes(attributes).toUtf8());
 
     // Replace placeholders "{}" by the aperture number.
-    QString definition = it.value().second;
-    str.append(definition.replace("{}", QString::number(it.key())));
+    QByteArray definition = it.value().second;
+    str.append(definition.replace("{}", QByteArray::number(it.key())));
   }
 
   // Explicitly clear all attributes at the end of the aperture list to avoid
   // propagating attributes to the rest of the Gerber file!
-  str.append(attributeWriter.setAttributes({}));
+  str.append(attributeWriter.setAttributes({}).toUtf8());
 
   return str;
 }
@@ -74,8 +75,9 @@ QString GerberApertureList::generateString() const noexcept {
 
 int GerberApertureList::addCircle(const UnsignedLength& dia,
                                   Function function) {
-  return addAperture(QString("%ADD{}C,%1*%\n").arg(dia->toMmString()),
-                     function);
+  GerberOutputStream s;
+  s.write("%ADD{}C,").writeMm(*dia).write("*%\n");
+  return addAperture(s.getData(), function);
 }
 
 int GerberApertureList::addObround(const PositiveLength& w,
@@ -85,13 +87,13 @@ int GerberApertureList::addObround(const PositiveLength& w,
     // For maximum compatibility, use a circle if width==height.
     return addCircle(positiveToUnsigned(w), function);
   } else if (rot % Angle::deg180() == 0) {
-    return addAperture(
-        QString("%ADD{}O,%1X%2*%\n").arg(w->toMmString(), h->toMmString()),
-        function);
+    GerberOutputStream s;
+    s.write("%ADD{}O,").writeMm(*w).write('X').writeMm(*h).write("*%\n");
+    return addAperture(s.getData(), function);
   } else if (rot % Angle::deg90() == 0) {
-    return addAperture(
-        QString("%ADD{}O,%1X%2*%\n").arg(h->toMmString(), w->toMmString()),
-        function);
+    GerberOutputStream s;
+    s.write("%ADD{}O,").writeMm(*h).write('X').writeMm(*w).write("*%\n");
+    return addAperture(s.getData(), function);
   } else if (w < h) {
     // Same as condition below, but swap width and height and rotate by 90° to
     // simplify calculations and to merge all combinations of parameters
@@ -104,23 +106,21 @@ int GerberApertureList::addObround(const PositiveLength& w,
     // Normalize the rotation to a range of 0..180° to avoid generating
     // multiple different apertures which represent exactly the same image.
     Angle uniqueRotatation = rot.mappedTo0_360deg() % Angle::deg180();
-    QString s = "%AMROTATEDOBROUND{}";
+    GerberOutputStream s;
+    s.write("%AMROTATEDOBROUND{}");
     Point start = Point(-w / 2 + h / 2, 0).rotated(uniqueRotatation);
     Point end = Point(w / 2 - h / 2, 0).rotated(uniqueRotatation);
     // ATTENTION: Don't use the optional rotation parameter in the circles!
     // It causes critical issues with some crappy CAM software!
-    s += QString("*1,1,%1,%2,%3")
-             .arg(h->toMmString(), start.getX().toMmString(),
-                  start.getY().toMmString());
-    s += QString("*1,1,%1,%2,%3")
-             .arg(h->toMmString(), end.getX().toMmString(),
-                  end.getY().toMmString());
-    s += QString("*20,1,%1,%2,%3,%4,%5,0*%\n")
-             .arg(h->toMmString(), start.getX().toMmString(),
-                  start.getY().toMmString(), end.getX().toMmString(),
-                  end.getY().toMmString());
-    s += "%ADD{}ROTATEDOBROUND{}*%\n";
-    return addAperture(s, function);
+    s.write("*1,1,").writeMm(*h).write(',').writeMm(start.getX());
+    s.write(',').writeMm(start.getY());
+    s.write("*1,1,").writeMm(*h).write(',').writeMm(end.getX());
+    s.write(',').writeMm(end.getY());
+    s.write("*20,1,").writeMm(*h).write(',').writeMm(start.getX());
+    s.write(',').writeMm(start.getY()).write(',').writeMm(end.getX());
+    s.write(',').writeMm(end.getY()).write(",0*%\n");
+    s.write("%ADD{}ROTATEDOBROUND{}*%\n");
+    return addAperture(s.getData(), function);
   }
 }
 
@@ -130,13 +130,13 @@ int GerberApertureList::addRect(const PositiveLength& w,
                                 Function function) noexcept {
   // Handle simple cases first.
   if ((r == 0) && (rot % Angle::deg180() == 0)) {
-    return addAperture(
-        QString("%ADD{}R,%1X%2*%\n").arg(w->toMmString(), h->toMmString()),
-        function);
+    GerberOutputStream s;
+    s.write("%ADD{}R,").writeMm(*w).write('X').writeMm(*h).write("*%\n");
+    return addAperture(s.getData(), function);
   } else if ((r == 0) && (rot % Angle::deg90() == 0)) {
-    return addAperture(
-        QString("%ADD{}R,%1X%2*%\n").arg(h->toMmString(), w->toMmString()),
-        function);
+    GerberOutputStream s;
+    s.write("%ADD{}R,").writeMm(*h).write('X').writeMm(*w).write("*%\n");
+    return addAperture(s.getData(), function);
   } else if (w < h) {
     // Swap width and height and rotate by 90° to simplify calculations and
     // to merge all combinations of parameters leading in the same image.
@@ -155,12 +155,13 @@ int GerberApertureList::addRect(const PositiveLength& w,
   // Let's use the "Vector Line (Code 20)" macro instead.
   if (r == 0) {
     // Corners are not rounded.
-    QString s = "%AMROTATEDRECT{}";
-    s += QString("*20,1,%1,%2,0.0,%3,0.0,%4*%\n")
-             .arg(h->toMmString(), (-w / 2).toMmString(), (w / 2).toMmString(),
-                  uniqueRotatation.toDegString());
-    s += "%ADD{}ROTATEDRECT{}*%\n";
-    return addAperture(s, function);
+    GerberOutputStream s;
+    s.write("%AMROTATEDRECT{}");
+    s.write("*20,1,").writeMm(*h).write(',').writeMm(-w / 2);
+    s.write(",0.0,").writeMm(w / 2).write(",0.0,");
+    s.writeDeg(uniqueRotatation).write("*%\n");
+    s.write("%ADD{}ROTATEDRECT{}*%\n");
+    return addAperture(s.getData(), function);
   } else if (r >= std::min(w, h) / 2) {
     // The radius is too large for the given size, it's actually an obround.
     return addObround(w, h, rot, function);
@@ -172,21 +173,21 @@ int GerberApertureList::addRect(const PositiveLength& w,
         Point((w / 2) - r, r - (h / 2)).rotated(uniqueRotatation),
         Point(r - (w / 2), r - (h / 2)).rotated(uniqueRotatation),
     };
-    QString s = "%AMROUNDEDRECT{}*";
-    s += QString("20,1,%1,%2,0.0,%3,0.0,%4*")
-             .arg(h->toMmString(), (r - (w / 2)).toMmString(),
-                  ((w / 2) - r).toMmString(), uniqueRotatation.toDegString());
-    s += QString("20,1,%1,%2,0.0,%3,0.0,%4*")
-             .arg((h - (r * 2)).toMmString(), (-w / 2).toMmString(),
-                  (w / 2).toMmString(), uniqueRotatation.toDegString());
+    GerberOutputStream s;
+    s.write("%AMROUNDEDRECT{}*");
+    s.write("20,1,").writeMm(*h).write(',').writeMm(r - (w / 2));
+    s.write(",0.0,").writeMm((w / 2) - r).write(",0.0,");
+    s.writeDeg(uniqueRotatation).write('*');
+    s.write("20,1,").writeMm(h - (r * 2)).write(',').writeMm(-w / 2);
+    s.write(",0.0,").writeMm(w / 2).write(",0.0,");
+    s.writeDeg(uniqueRotatation).write('*');
     foreach (const Point& p, circlePositions) {
-      s += QString("1,1,%1,%2,%3*")
-               .arg((r * 2).toMmString(), p.getX().toMmString(),
-                    p.getY().toMmString());
+      s.write("1,1,").writeMm(r * 2).write(',').writeMm(p.getX());
+      s.write(',').writeMm(p.getY()).write('*');
     }
-    s += "%\n";
-    s += "%ADD{}ROUNDEDRECT{}*%\n";
-    return addAperture(s, function);
+    s.write("%\n");
+    s.write("%ADD{}ROUNDEDRECT{}*%\n");
+    return addAperture(s.getData(), function);
   }
 }
 
@@ -226,25 +227,25 @@ int GerberApertureList::addOctagon(const PositiveLength& w,
     return addObround(w, h, rot, function);
   } else {
     // Corners are rounded, build a macro with four rects and eight circles.
-    QString s = "%AMROUNDEDOCTAGON{}*";
+    GerberOutputStream s;
+    s.write("%AMROUNDEDOCTAGON{}*");
     Path octagonWithoutArcs;
     foreach (const Vertex& v, Path::octagon(w, h, r).getVertices()) {
       octagonWithoutArcs.addVertex(v.getPos());
     }
-    s += buildOutlineMacro(octagonWithoutArcs, uniqueRotatation);
+    buildOutlineMacro(s, octagonWithoutArcs, uniqueRotatation);
     const Path innerOctagon =
         Path::octagon(PositiveLength(innerWidth), PositiveLength(innerHeight),
                       UnsignedLength(0))
             .rotated(uniqueRotatation);
     for (int i = 1; i < innerOctagon.getVertices().count(); ++i) {  // Skip [0]!
       const Point p = innerOctagon.getVertices().at(i).getPos();
-      s += QString("1,1,%1,%2,%3*")
-               .arg((r * 2).toMmString(), p.getX().toMmString(),
-                    p.getY().toMmString());
+      s.write("1,1,").writeMm(r * 2).write(',').writeMm(p.getX());
+      s.write(',').writeMm(p.getY()).write('*');
     }
-    s += "%\n";
-    s += "%ADD{}ROUNDEDOCTAGON{}*%\n";
-    return addAperture(s, function);
+    s.write("%\n");
+    s.write("%ADD{}ROUNDEDOCTAGON{}*%\n");
+    return addAperture(s.getData(), function);
   }
 }
 
@@ -277,38 +278,39 @@ int GerberApertureList::addComponentPin(bool isPin1) noexcept {
  *  Private Methods
  ******************************************************************************/
 
-int GerberApertureList::addOutline(const QString& name, const Path& path,
+int GerberApertureList::addOutline(const char* name, const Path& path,
                                    const Angle& rot,
                                    Function function) noexcept {
-  QString s = QString("%AM%1{}*").arg(name);
-  s += buildOutlineMacro(path, rot);
-  s += QString("%\n");
-  s += QString("%ADD{}%1{}*%\n").arg(name);
-  return addAperture(s, function);
+  GerberOutputStream s;
+  s.write("%AM").write(name).write("{}*");
+  buildOutlineMacro(s, path, rot);
+  s.write("%\n");
+  s.write("%ADD{}").write(name).write("{}*%\n");
+  return addAperture(s.getData(), function);
 }
 
-QString GerberApertureList::buildOutlineMacro(Path path,
-                                              const Angle& rot) const noexcept {
+void GerberApertureList::buildOutlineMacro(GerberOutputStream& s, Path path,
+                                           const Angle& rot) const noexcept {
   path.close();
   Q_ASSERT(path.getVertices().count() >= 4);
-  QString s = QString("4,1,%2,").arg(path.getVertices().count() - 1);
+  s.write("4,1,").writeInteger(path.getVertices().count() - 1).write(',');
   foreach (const Vertex& v, path.getVertices()) {
     Q_ASSERT(v.getAngle() == 0);
-    s += QString("%1,%2,").arg(v.getPos().getX().toMmString(),
-                               v.getPos().getY().toMmString());
+    s.writeMm(v.getPos().getX()).write(',');
+    s.writeMm(v.getPos().getY()).write(',');
   }
-  s += QString("%1*").arg(rot.toDegString());
-  return s;
+  s.writeDeg(rot).write('*');
 }
 
-int GerberApertureList::addAperture(QString aperture,
+int GerberApertureList::addAperture(const QByteArray& aperture,
                                     Function function) noexcept {
-  auto value = std::make_pair(function, aperture);
-  int number = mApertures.key(value, -1);
+  const auto value = std::make_pair(function, aperture);
+  int number = mApertureNumbers.value(value, -1);
   if (number < 0) {
     number = mApertures.count() + 10;  // 10 is the number of the first aperture
     Q_ASSERT(!mApertures.contains(number));
     mApertures.insert(number, value);
+    mApertureNumbers.insert(value, number);
   }
   return number;
 }
@@ -39,6 +39,7 @@
 namespace librepcb {
 
 class Angle;
+class GerberOutputStream;
 
 /*******************************************************************************
  *  Class GerberApertureList
@@ -82,9 +83,9 @@ public:
   /**
    * @brief Generate the aperture definitions string
    *
-   * @return String containing 0..n lines
+   * @return UTF-8 encoded string containing 0..n lines
    */
-  QString generateString() const noexcept;
+  QByteArray generateString() const noexcept;
 
   // General Methods
 
@@ -188,20 +189,20 @@ private:  // Methods
    *
    * @return Aperture number.
    */
-  int addOutline(const QString& name, const Path& path, const Angle& rot,
+  int addOutline(const char* name, const Path& path, const Angle& rot,
                  Function function) noexcept;
 
   /**
    * @brief Internal helper for #addOutline()
    *
+   * @param s         Stream to write the aperture macro content to.
    * @param path      The vertices. ATTENTION: After closing the path, it must
    *                  contain at least 4 vertices and it must not contain any
    *                  arc segment (i.e. all angles must be zero)!!!
    * @param rot       Rotation.
-   *
-   * @return Aperture macro content.
    */
-  QString buildOutlineMacro(Path path, const Angle& rot) const noexcept;
+  void buildOutlineMacro(GerberOutputStream& s, Path path,
+                         const Angle& rot) const noexcept;
 
   /**
    * @brief Helper method to actually add a new or get an existing aperture
@@ -215,7 +216,7 @@ private:  // Methods
    *
    * @return Aperture number.
    */
-  int addAperture(QString aperture, Function function) noexcept;
+  int addAperture(const QByteArray& aperture, Function function) noexcept;
 
 private:  // Data
   /// Added apertures
@@ -224,7 +225,10 @@ private:  // Data
   /// - value:  Aperture function and definition, with the placeholder "{}"
   ///           instead of the aperture number. Needs to be substituted by the
   ///           aperture number when serializing.
-  QMap<int, std::pair<Function, QString>> mApertures;
+  QMap<int, std::pair<Function, QByteArray>> mApertures;
+
+  /// Reverse lookup of #mApertures to quickly find existing apertures
+  QMap<std::pair<Function, QByteArray>, int> mApertureNumbers;
 };
 
 /*******************************************************************************
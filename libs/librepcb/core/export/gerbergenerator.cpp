@@ -30,6 +30,7 @@
 #include "gerberaperturelist.h"
 #include "gerberattribute.h"
 #include "gerberattributewriter.h"
+#include "gerberoutputstream.h"
 
 #include <QtCore>
 
@@ -45,8 +46,7 @@ namespace librepcb {
 GerberGenerator::GerberGenerator(const QDateTime& creationDate,
                                  const QString& projName, const Uuid& projUuid,
                                  const QString& projRevision) noexcept
-  : mOutput(),
-    mContent(),
+  : mContent(),
     mAttributeWriter(new GerberAttributeWriter()),
     mApertureList(new GerberApertureList()),
     mCurrentApertureNumber(-1) {
@@ -108,10 +108,10 @@ void GerberGenerator::setFileFunctionComponent(int layer,
 void GerberGenerator::setLayerPolarity(Polarity p) noexcept {
   switch (p) {
     case Polarity::Positive:
-      mContent.append("%LPD*%\n");
+      mContent.write("%LPD*%\n");
       break;
     case Polarity::Negative:
-      mContent.append("%LPC*%\n");
+      mContent.write("%LPC*%\n");
       break;
     default:
       qCritical()
@@ -398,19 +398,28 @@ void GerberGenerator::flashComponentPin(
  *  General Methods
  ******************************************************************************/
 
-void GerberGenerator::generate() {
-  mOutput.clear();
-  printHeader();
-  printApertureList();
-  printContent();
-  printFooter();
+void GerberGenerator::generate(QIODevice& device) const {
+  GerberOutputStream s(&device, true);
+  printHeader(s);
+  printApertureList(s);
+  printContent(s);
+  printFooter(s);  // can throw
+  s.flush();  // can throw
+}
+
+QByteArray GerberGenerator::generate() const {
+  QByteArray output;
+  output.reserve(mContent.getData().size() + 4096);
+  QBuffer buffer(&output);
+  buffer.open(QIODevice::WriteOnly);
+  generate(buffer);  // can throw
+  return output;
 }
 
 void GerberGenerator::saveToFile(const FilePath& filepath) const {
-  // Note: Although we save it as UTF-8, usually it will still contain only
-  // ASCII characters for maximum compatibility with legacy crappy readers.
-  // Unicode is only required when exporting Gerber X3 assembly attributes.
-  FileUtils::writeFile(filepath, mOutput.toUtf8());  // can throw
+  FileUtils::writeFile(filepath, [this](QIODevice& device) {
+    generate(device);  // can throw
+  });  // can throw
 }
 
 /*******************************************************************************
@@ -458,53 +467,57 @@ void GerberGenerator::setCurrentAttributes(
   if (componentRotation) {
     attributes.append(GerberAttribute::componentRotation(*componentRotation));
   }
-  mContent.append(mAttributeWriter->setAttributes(attributes));
+  const QString str = mAttributeWriter->setAttributes(attributes);
+  if (!str.isEmpty()) {
+    mContent.write(str);
+  }
 }
 
 void GerberGenerator::setCurrentAperture(int number) noexcept {
   if (number != mCurrentApertureNumber) {
-    mContent.append(QString("D%1*\n").arg(number));
+    mContent.write('D').writeInteger(number).write("*\n");
     mCurrentApertureNumber = number;
   }
 }
 
 void GerberGenerator::setRegionModeOn() noexcept {
-  mContent.append("G36*\n");
+  mContent.write("G36*\n");
 }
 
 void GerberGenerator::setRegionModeOff() noexcept {
-  mContent.append("G37*\n");
+  mContent.write("G37*\n");
 }
 
 void GerberGenerator::switchToLinearInterpolationModeG01() noexcept {
-  mContent.append("G01*\n");
+  mContent.write("G01*\n");
 }
 
 void GerberGenerator::switchToCircularCwInterpolationModeG02() noexcept {
-  mContent.append("G02*\n");
+  mContent.write("G02*\n");
 }
 
 void GerberGenerator::switchToCircularCcwInterpolationModeG03() noexcept {
-  mContent.append("G03*\n");
+  mContent.write("G03*\n");
 }
 
 void GerberGenerator::moveToPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D02*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  mContent.write('X').writeNm(pos.getX());
+  mContent.write('Y').writeNm(pos.getY()).write("D02*\n");
 }
 
 void GerberGenerator::linearInterpolateToPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D01*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  mContent.write('X').writeNm(pos.getX());
+  mContent.write('Y').writeNm(pos.getY()).write("D01*\n");
 }
 
 void GerberGenerator::circularInterpolateToPosition(const Point& start,
                                                     const Point& center,
                                                     const Point& end) noexcept {
   Point diff = center - start;
-  mContent.append(QString("X%1Y%2I%3J%4D01*\n")
-                      .arg(end.getX().toNmString(), end.getY().toNmString(),
-                           diff.getX().toNmString(), diff.getY().toNmString()));
+  mContent.write('X').writeNm(end.getX());
+  mContent.write('Y').writeNm(end.getY());
+  mContent.write('I').writeNm(diff.getX());
+  mContent.write('J').writeNm(diff.getY()).write("D01*\n");
 }
 
 void GerberGenerator::interpolateBetween(const Vertex& from,
@@ -526,65 +539,57 @@ void GerberGenerator::interpolateBetween(const Vertex& from,
 }
 
 void GerberGenerator::flashAtPosition(const Point& pos) noexcept {
-  mContent.append(QString("X%1Y%2D03*\n")
-                      .arg(pos.getX().toNmString(), pos.getY().toNmString()));
+  mContent.write('X').writeNm(pos.getX());
+  mContent.write('Y').writeNm(pos.getY()).write("D03*\n");
 }
 
-void GerberGenerator::printHeader() noexcept {
-  mOutput.append("G04 --- HEADER BEGIN --- *\n");
+void GerberGenerator::printHeader(GerberOutputStream& s) const noexcept {
+  s.write("G04 --- HEADER BEGIN --- *\n");
 
   // Add file attributes.
   foreach (const GerberAttribute& a, mFileAttributes) {
-    mOutput.append(a.toGerberString());
+    s.write(a.toGerberString());
   }
 
   // coordinate format specification:
   //  - leading zeros omitted
   //  - absolute coordinates
   //  - coordinate format "6.6" --> allows us to directly use nanometers (i64)!
-  mOutput.append("%FSLAX66Y66*%\n");
+  s.write("%FSLAX66Y66*%\n");
 
   // set unit to millimeters
-  mOutput.append("%MOMM*%\n");
+  s.write("%MOMM*%\n");
 
   // start linear interpolation mode
-  mOutput.append("G01*\n");
+  s.write("G01*\n");
 
   // Use multi quadrant arc mode (single quadrant mode is buggy in some CAM
   // software and is now deprecated in the current Gerber specs).
   // See https://github.com/LibrePCB/LibrePCB/issues/247.
-  mOutput.append("G75*\n");
+  s.write("G75*\n");
 
-  mOutput.append("G04 --- HEADER END --- *\n");
+  s.write("G04 --- HEADER END --- *\n");
 }
 
-void GerberGenerator::printApertureList() noexcept {
-  mOutput.append("G04 --- APERTURE LIST BEGIN --- *\n");
-  mOutput.append(mApertureList->generateString());
-  mOutput.append("G04 --- APERTURE LIST END --- *\n");
+void GerberGenerator::printApertureList(GerberOutputStream& s) const noexcept {
+  s.write("G04 --- APERTURE LIST BEGIN --- *\n");
+  s.write(mApertureList->generateString());
+  s.write("G04 --- APERTURE LIST END --- *\n");
 }
 
-void GerberGenerator::printContent() noexcept {
-  mOutput.append("G04 --- BOARD BEGIN --- *\n");
-  mOutput.append(mContent);
-  mOutput.append("G04 --- BOARD END --- *\n");
+void GerberGenerator::printContent(GerberOutputStream& s) const noexcept {
+  s.write("G04 --- BOARD BEGIN --- *\n");
+  s.write(mContent.getData());
+  s.write("G04 --- BOARD END --- *\n");
 }
 
-void GerberGenerator::printFooter() noexcept {
+void GerberGenerator::printFooter(GerberOutputStream& s) const {
   // MD5 checksum over content
-  mOutput.append(
-      GerberAttribute::fileMd5(calcOutputMd5Checksum()).toGerberString());
+  const QString md5 = s.getMd5Checksum();  // can throw
+  s.write(GerberAttribute::fileMd5(md5).toGerberString());
 
   // end of file
-  mOutput.append("M02*\n");
-}
-
-QString GerberGenerator::calcOutputMd5Checksum() const noexcept {
-  // according to the RS-274C standard, linebreaks are not included in the
-  // checksum
-  QString data = QString(mOutput).remove(QChar('\n'));
-  return QString(
-      QCryptographicHash::hash(data.toUtf8(), QCryptographicHash::Md5).toHex());
+  s.write("M02*\n");
 }
 
 /*******************************************************************************
@@ -28,6 +28,7 @@
 #include "../types/uuid.h"
 #include "gerberaperturelist.h"
 #include "gerberattribute.h"
+#include "gerberoutputstream.h"
 
 #include <QtCore>
 
@@ -66,9 +67,6 @@ public:
                   const Uuid& projUuid, const QString& projRevision) noexcept;
   ~GerberGenerator() noexcept;
 
-  // Getters
-  const QString& toStr() const noexcept { return mOutput; }
-
   // Plot Methods
   void setFileFunctionOutlines(bool plated) noexcept;
   void setFileFunctionCopper(int layer, CopperSide side,
@@ -130,7 +128,23 @@ public:
                          bool isPin1) noexcept;
 
   // General Methods
-  void generate();
+
+  /**
+   * @brief Generate the Gerber file and stream it into a device
+   *
+   * @param device  Device to write the UTF-8 encoded file content to.
+   *
+   * @throws Exception if writing to the device failed.
+   */
+  void generate(QIODevice& device) const;
+
+  /**
+   * @brief Generate the Gerber file in memory
+   *
+   * @return UTF-8 encoded file content.
+   */
+  QByteArray generate() const;
+
   void saveToFile(const FilePath& filepath) const;
 
   // Operator Overloadings
@@ -158,18 +172,16 @@ private:
                                      const Point& end) noexcept;
   void interpolateBetween(const Vertex& from, const Vertex& to) noexcept;
   void flashAtPosition(const Point& pos) noexcept;
-  void printHeader() noexcept;
-  void printApertureList() noexcept;
-  void printContent() noexcept;
-  void printFooter() noexcept;
-  QString calcOutputMd5Checksum() const noexcept;
+  void printHeader(GerberOutputStream& s) const noexcept;
+  void printApertureList(GerberOutputStream& s) const noexcept;
+  void printContent(GerberOutputStream& s) const noexcept;
+  void printFooter(GerberOutputStream& s) const;
 
   // Metadata
   QVector<GerberAttribute> mFileAttributes;
 
   // Gerber Data
-  QString mOutput;
-  QString mContent;
+  GerberOutputStream mContent;
   QScopedPointer<GerberAttributeWriter> mAttributeWriter;
   QScopedPointer<GerberApertureList> mApertureList;
   int mCurrentApertureNumber;
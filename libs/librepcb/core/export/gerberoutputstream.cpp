@@ -0,0 +1,205 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "gerberoutputstream.h"
+
+#include "../exceptions.h"
+#include "../types/angle.h"
+#include "../types/length.h"
+
+#include <QtCore>
+
+#include <cstring>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+GerberOutputStream::GerberOutputStream(QIODevice* device, bool calcMd5) noexcept
+  : mDevice(device),
+    mMd5(calcMd5 ? new QCryptographicHash(QCryptographicHash::Md5) : nullptr),
+    mBuffer(),
+    mWriteFailed(false) {
+  Q_ASSERT((!mMd5) || mDevice);  // Checksum is calculated when flushing.
+  if (mDevice) {
+    mBuffer.reserve(sBufferSize + 1024);
+  }
+}
+
+GerberOutputStream::~GerberOutputStream() noexcept {
+}
+
+/*******************************************************************************
+ *  Getters
+ ******************************************************************************/
+
+QString GerberOutputStream::getMd5Checksum() {
+  Q_ASSERT(mMd5);
+  flush();  // can throw
+  return QString(mMd5->result().toHex());
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+GerberOutputStream& GerberOutputStream::write(char c) noexcept {
+  writeRaw(&c, 1);
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::write(const char* str) noexcept {
+  writeRaw(str, std::strlen(str));
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::write(const QByteArray& data) noexcept {
+  writeRaw(data.constData(), data.size());
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::write(const QString& str) noexcept {
+  // Note: Although we save it as UTF-8, usually it will still contain only
+  // ASCII characters for maximum compatibility with legacy crappy readers.
+  // Unicode is only required when exporting Gerber X3 assembly attributes.
+  return write(str.toUtf8());
+}
+
+GerberOutputStream& GerberOutputStream::writeInteger(qint64 value) noexcept {
+  writeDecimal(value, 0);
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::writeNm(const Length& value) noexcept {
+  writeDecimal(value.toNm(), 0);
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::writeMm(const Length& value) noexcept {
+  writeDecimal(value.toNm(), 6);
+  return *this;
+}
+
+GerberOutputStream& GerberOutputStream::writeDeg(const Angle& value) noexcept {
+  writeDecimal(value.toMicroDeg(), 6);
+  return *this;
+}
+
+void GerberOutputStream::flush() {
+  flushBuffer();
+  if (mWriteFailed) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Failed to write output data: %1")
+                           .arg(mDevice ? mDevice->errorString() : QString()));
+  }
+}
+
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void GerberOutputStream::writeRaw(const char* data, qsizetype size) noexcept {
+  if (mDevice && (size >= sBufferSize)) {
+    // Large chunk of data -> write it directly, without copying.
+    flushBuffer();
+    writeToDevice(data, size);
+  } else {
+    mBuffer.append(data, size);
+    if (mDevice && (mBuffer.size() >= sBufferSize)) {
+      flushBuffer();
+    }
+  }
+}
+
+void GerberOutputStream::writeDecimal(qint64 value, int pointPos) noexcept {
+  // Same output as Toolbox::decimalFixedPointToString(), but formatted
+  // backwards into a stack buffer to avoid any heap allocation.
+  char buffer[32];
+  char* const end = buffer + sizeof(buffer);
+  char* p = end;
+  quint64 abs = (value < 0) ? (-static_cast<quint64>(value))
+                            : static_cast<quint64>(value);
+  if (pointPos > 0) {
+    // Fractional digits without trailing zeros, but at least one digit.
+    bool significant = false;
+    for (int i = 0; i < pointPos; ++i) {
+      const char digit = static_cast<char>('0' + (abs % 10));
+      abs /= 10;
+      if (significant || (digit != '0')) {
+        *--p = digit;
+        significant = true;
+      }
+    }
+    if (!significant) {
+      *--p = '0';
+    }
+    *--p = '.';
+  }
+  do {
+    *--p = static_cast<char>('0' + (abs % 10));
+    abs /= 10;
+  } while (abs > 0);
+  if (value < 0) {
+    *--p = '-';
+  }
+  writeRaw(p, end - p);
+}
+
+void GerberOutputStream::flushBuffer() noexcept {
+  if (mDevice && (!mBuffer.isEmpty())) {
+    writeToDevice(mBuffer.constData(), mBuffer.size());
+    mBuffer.resize(0);  // Keeps the allocated capacity.
+  }
+}
+
+void GerberOutputStream::writeToDevice(const char* data,
+                                       qsizetype size) noexcept {
+  if (mMd5) {
+    // According to the RS-274C standard, line breaks are not included in the
+    // checksum.
+    const char* const end = data + size;
+    const char* start = data;
+    while (start < end) {
+      const char* lf =
+          static_cast<const char*>(std::memchr(start, '\n', end - start));
+      const char* chunkEnd = lf ? lf : end;
+      if (chunkEnd > start) {
+        mMd5->addData(QByteArray::fromRawData(start, chunkEnd - start));
+      }
+      start = chunkEnd + 1;
+    }
+  }
+  if (mDevice->write(data, size) != size) {
+    mWriteFailed = true;
+  }
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
@@ -0,0 +1,132 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_CORE_GERBEROUTPUTSTREAM_H
+#define LIBREPCB_CORE_GERBEROUTPUTSTREAM_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <QtCore>
+
+#include <memory>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+
+class Angle;
+class Length;
+
+/*******************************************************************************
+ *  Class GerberOutputStream
+ ******************************************************************************/
+
+/**
+ * @brief Buffered UTF-8 writer used to generate Gerber and Excellon files
+ *
+ * Formats coordinates directly into a byte buffer without any intermediate
+ * QString, which keeps memory usage and export time low even for files with
+ * millions of vertices. The produced number formats are identical to
+ * ::librepcb::Length::toNmString(), ::librepcb::Length::toMmString() and
+ * ::librepcb::Angle::toDegString().
+ *
+ * If a device is passed to the constructor, the buffer is flushed to it
+ * whenever it exceeds a certain size. Without a device, all data is kept in
+ * memory and can be retrieved with #getData().
+ *
+ * Write errors are remembered and reported by #flush() to keep the write
+ * methods lightweight.
+ */
+class GerberOutputStream final {
+  Q_DECLARE_TR_FUNCTIONS(GerberOutputStream)
+
+public:
+  // Constructors / Destructor
+  GerberOutputStream(const GerberOutputStream& other) = delete;
+  explicit GerberOutputStream(QIODevice* device = nullptr,
+                              bool calcMd5 = false) noexcept;
+  ~GerberOutputStream() noexcept;
+
+  // Getters
+
+  /**
+   * @brief Get the data written so far (only if no device is used)
+   *
+   * @return Buffered UTF-8 data.
+   */
+  const QByteArray& getData() const noexcept { return mBuffer; }
+
+  /**
+   * @brief Get the MD5 checksum of all data written so far
+   *
+   * Line breaks are not included in the checksum, as specified by the
+   * RS-274C standard. Only available if the checksum calculation was enabled
+   * in the constructor.
+   *
+   * @return Hex encoded MD5 checksum.
+   *
+   * @throws Exception if writing to the device failed.
+   */
+  QString getMd5Checksum();
+
+  // General Methods
+  GerberOutputStream& write(char c) noexcept;
+  GerberOutputStream& write(const char* str) noexcept;
+  GerberOutputStream& write(const QByteArray& data) noexcept;
+  GerberOutputStream& write(const QString& str) noexcept;
+  GerberOutputStream& writeInteger(qint64 value) noexcept;
+  GerberOutputStream& writeNm(const Length& value) noexcept;
+  GerberOutputStream& writeMm(const Length& value) noexcept;
+  GerberOutputStream& writeDeg(const Angle& value) noexcept;
+
+  /**
+   * @brief Write all buffered data to the device
+   *
+   * @throws Exception if writing to the device failed.
+   */
+  void flush();
+
+  // Operator Overloadings
+  GerberOutputStream& operator=(const GerberOutputStream& rhs) = delete;
+
+private:  // Methods
+  void writeRaw(const char* data, qsizetype size) noexcept;
+  void writeDecimal(qint64 value, int pointPos) noexcept;
+  void flushBuffer() noexcept;
+  void writeToDevice(const char* data, qsizetype size) noexcept;
+
+private:  // Data
+  QIODevice* mDevice;
+  std::unique_ptr<QCryptographicHash> mMd5;
+  QByteArray mBuffer;
+  bool mWriteFailed;
+
+  /// Buffer size at which the buffer gets flushed to the device
+  static constexpr qsizetype sBufferSize = 64 * 1024;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace librepcb
+
+#endif
@@ -75,6 +75,24 @@ void FileUtils::writeFile(const FilePath& filepath, const QByteArray& content) {
   }
 }
 
+void FileUtils::writeFile(const FilePath& filepath,
+                          const std::function<void(QIODevice&)>& writer) {
+  makePath(filepath.getParentDir());  // can throw
+  QSaveFile file(filepath.toStr());
+  if (!file.open(QIODevice::WriteOnly)) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Could not open or create file \"%1\": %2")
+                           .arg(filepath.toNative(), file.errorString()));
+  }
+  writer(file);  // can throw
+  if (!file.commit()) {
+    throw RuntimeError(__FILE__, __LINE__,
+                       tr("Could not write to "
+                          "file \"%1\": %2")
+                           .arg(filepath.toNative(), file.errorString()));
+  }
+}
+
 void FileUtils::copyFile(const FilePath& source, const FilePath& dest) {
   if (!source.isExistingFile()) {
     throw LogicError(
@@ -25,6 +25,8 @@
  ******************************************************************************/
 #include <QtCore>
 
+#include <functional>
+
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
@@ -74,6 +76,22 @@ public:
    */
   static void writeFile(const FilePath& filepath, const QByteArray& content);
 
+  /**
+   * @brief Stream content into a file
+   *
+   * Same as #writeFile(const FilePath&, const QByteArray&), but the content
+   * is written by a callback to avoid keeping it in memory. The file is only
+   * (over)written if the callback succeeds.
+   *
+   * @param filepath      The file to (over)write
+   * @param writer        Callback writing the content to the passed device.
+   *                      Shall throw an exception in case of an error.
+   *
+   * @throws Exception    If an error occurs.
+   */
+  static void writeFile(const FilePath& filepath,
+                        const std::function<void(QIODevice&)>& writer);
+
   /**
    * @brief Copy a single file
    *
@@ -203,6 +203,20 @@ std::unique_ptr<Component> Component::open(
   return obj;
 }
 
+std::unique_ptr<Component> Component::openMetadata(
+    std::unique_ptr<TransactionalDirectory> directory) {
+  Q_ASSERT(directory);
+  const std::unique_ptr<const SExpression> root =
+      parseMetadata(*directory, getShortElementName(), getLongElementName(),
+                    {"signal", "variant"});
+  if (!root) {
+    return nullptr;  // File format migration required.
+  }
+  std::unique_ptr<Component> obj(new Component(std::move(directory), *root));
+  obj->mIsMetadataOnly = true;
+  return obj;
+}
+
 /*******************************************************************************
  *  Protected Methods
  ******************************************************************************/
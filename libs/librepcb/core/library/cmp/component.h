@@ -140,6 +140,8 @@ public:
   static std::unique_ptr<Component> open(
       std::unique_ptr<TransactionalDirectory> directory,
       bool abortBeforeMigration = false);
+  static std::unique_ptr<Component> openMetadata(
+      std::unique_ptr<TransactionalDirectory> directory);
   static QString getShortElementName() noexcept {
     return QStringLiteral("cmp");
   }
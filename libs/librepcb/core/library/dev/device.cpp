@@ -126,6 +126,20 @@ std::unique_ptr<Device> Device::open(
   return obj;
 }
 
+std::unique_ptr<Device> Device::openMetadata(
+    std::unique_ptr<TransactionalDirectory> directory) {
+  Q_ASSERT(directory);
+  const std::unique_ptr<const SExpression> root =
+      parseMetadata(*directory, getShortElementName(), getLongElementName(),
+                    {"pad"});
+  if (!root) {
+    return nullptr;  // File format migration required.
+  }
+  std::unique_ptr<Device> obj(new Device(std::move(directory), *root));
+  obj->mIsMetadataOnly = true;
+  return obj;
+}
+
 /*******************************************************************************
  *  Protected Methods
  ******************************************************************************/
@@ -92,6 +92,8 @@ public:
   static std::unique_ptr<Device> open(
       std::unique_ptr<TransactionalDirectory> directory,
       bool abortBeforeMigration = false);
+  static std::unique_ptr<Device> openMetadata(
+      std::unique_ptr<TransactionalDirectory> directory);
   static QString getShortElementName() noexcept {
     return QStringLiteral("dev");
   }
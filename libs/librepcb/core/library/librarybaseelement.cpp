@@ -24,6 +24,7 @@
 
 #include "../application.h"
 #include "../fileio/versionfile.h"
+#include "../serialization/fileformatmigration.h"
 #include "../serialization/sexpression.h"
 #include "../utils/toolbox.h"
 #include "librarybaseelementcheck.h"
@@ -56,7 +57,8 @@ LibraryBaseElement::LibraryBaseElement(
     mNames(name_en_US),
     mDescriptions(description_en_US),
     mKeywords(keywords_en_US),
-    mMessageApprovals() {
+    mMessageApprovals(),
+    mIsMetadataOnly(false) {
 }
 
 LibraryBaseElement::LibraryBaseElement(
@@ -75,7 +77,8 @@ LibraryBaseElement::LibraryBaseElement(
     mNames(root),
     mDescriptions(root),
     mKeywords(root),
-    mMessageApprovals() {
+    mMessageApprovals(),
+    mIsMetadataOnly(false) {
   // Load message approvals.
   foreach (const SExpression* child, root.getChildren("approved")) {
     mMessageApprovals.insert(*child);
@@ -146,6 +149,12 @@ RuleCheckMessageList LibraryBaseElement::runChecks() const {
 }
 
 void LibraryBaseElement::save() {
+  if (mIsMetadataOnly) {
+    throw LogicError(__FILE__, __LINE__,
+                     "Cannot save a library element with only its metadata "
+                     "loaded.");
+  }
+
   // Content.
   std::unique_ptr<SExpression> root =
       SExpression::createList("librepcb_" % mLongElementName);
@@ -225,6 +234,20 @@ Version LibraryBaseElement::readFileFormat(
   return fileFormat;
 }
 
+std::unique_ptr<const SExpression> LibraryBaseElement::parseMetadata(
+    const TransactionalDirectory& directory, const QString& shortElementName,
+    const QString& longElementName, const QSet<QString>& skippedLists) {
+  const Version fileFormat =
+      readFileFormat(directory, ".librepcb-" % shortElementName);
+  if (!FileFormatMigration::getMigrations(fileFormat).isEmpty()) {
+    return nullptr;
+  }
+  const QString fileName = longElementName % ".lp";
+  return SExpression::parse(directory.read(fileName),
+                            directory.getAbsPath(fileName),
+                            SExpression::Mode::LibrePCB, skippedLists);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -86,6 +86,17 @@ public:
     return mMessageApprovals;
   }
 
+  /**
+   * @brief Check whether only the metadata of this element has been loaded
+   *
+   * Elements opened with `openMetadata()` (e.g. ::librepcb::Symbol::
+   * openMetadata()) contain only the metadata required for indexing, without
+   * any geometry. Such elements cannot be saved.
+   *
+   * @return Whether this element contains only its metadata.
+   */
+  bool isMetadataOnly() const noexcept { return mIsMetadataOnly; }
+
   // Setters
   void setVersion(const Version& version) noexcept { mVersion = version; }
   void setAuthor(const QString& author) noexcept { mAuthor = author; }
@@ -143,6 +154,21 @@ protected:  // Methods
   static Version readFileFormat(const TransactionalDirectory& directory,
                                 const QString& fileName);
 
+  /**
+   * @brief Parse the main file of an element without some of its content
+   *
+   * @param directory         Directory of the element.
+   * @param shortElementName  Short element name, e.g. "sym".
+   * @param longElementName   Long element name, e.g. "symbol".
+   * @param skippedLists      Names of top-level lists to skip while parsing.
+   *
+   * @return The root node, or `nullptr` if a file format migration would be
+   *         required to load the element.
+   */
+  static std::unique_ptr<const SExpression> parseMetadata(
+      const TransactionalDirectory& directory, const QString& shortElementName,
+      const QString& longElementName, const QSet<QString>& skippedLists);
+
 protected:  // Data
   // General Attributes
   const QString mShortElementName;  ///< e.g. "lib", "cmpcat"
@@ -161,6 +187,9 @@ protected:  // Data
 
   // Library element check
   QSet<SExpression> mMessageApprovals;
+
+  /// Whether only the metadata was loaded, see #isMetadataOnly()
+  bool mIsMetadataOnly;
 };
 
 /*******************************************************************************
@@ -311,6 +311,20 @@ std::unique_ptr<Package> Package::open(
   return obj;
 }
 
+std::unique_ptr<Package> Package::openMetadata(
+    std::unique_ptr<TransactionalDirectory> directory) {
+  Q_ASSERT(directory);
+  const std::unique_ptr<const SExpression> root =
+      parseMetadata(*directory, getShortElementName(), getLongElementName(),
+                    {"pad", "3d_model", "footprint"});
+  if (!root) {
+    return nullptr;  // File format migration required.
+  }
+  std::unique_ptr<Package> obj(new Package(std::move(directory), *root));
+  obj->mIsMetadataOnly = true;
+  return obj;
+}
+
 /*******************************************************************************
  *  Protected Methods
  ******************************************************************************/
@@ -139,6 +139,8 @@ public:
   static std::unique_ptr<Package> open(
       std::unique_ptr<TransactionalDirectory> directory,
       bool abortBeforeMigration = false);
+  static std::unique_ptr<Package> openMetadata(
+      std::unique_ptr<TransactionalDirectory> directory);
   static QString getShortElementName() noexcept {
     return QStringLiteral("pkg");
   }
@@ -185,6 +185,20 @@ std::unique_ptr<Symbol> Symbol::open(
   return obj;
 }
 
+std::unique_ptr<Symbol> Symbol::openMetadata(
+    std::unique_ptr<TransactionalDirectory> directory) {
+  Q_ASSERT(directory);
+  const std::unique_ptr<const SExpression> root =
+      parseMetadata(*directory, getShortElementName(), getLongElementName(),
+                    {"pin", "polygon", "circle", "text", "image"});
+  if (!root) {
+    return nullptr;  // File format migration required.
+  }
+  std::unique_ptr<Symbol> obj(new Symbol(std::move(directory), *root));
+  obj->mIsMetadataOnly = true;
+  return obj;
+}
+
 /*******************************************************************************
  *  Protected Methods
  ******************************************************************************/
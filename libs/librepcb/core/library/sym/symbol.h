@@ -110,6 +110,8 @@ public:
   static std::unique_ptr<Symbol> open(
       std::unique_ptr<TransactionalDirectory> directory,
       bool abortBeforeMigration = false);
+  static std::unique_ptr<Symbol> openMetadata(
+      std::unique_ptr<TransactionalDirectory> directory);
   static QString getShortElementName() noexcept {
     return QStringLiteral("sym");
   }
@@ -57,6 +57,7 @@
 #include "items/bi_via.h"
 #include "items/bi_zone.h"
 
+#include <QtConcurrent>
 #include <QtCore>
 
 #include <algorithm>
@@ -147,7 +148,8 @@ Board::Board(Project& project,
     mSilkscreenLayersBot({&Layer::botLegend(), &Layer::botNames()}),
     mDrcMessageApprovalsVersion(Application::getFileFormatVersion()),
     mDrcMessageApprovals(),
-    mSupportedDrcMessageApprovals() {
+    mSupportedDrcMessageApprovals(),
+    mAirWiresRevision(0) {
   if (mDirectoryName.isEmpty()) {
     throw LogicError(__FILE__, __LINE__);
   }
@@ -545,8 +547,10 @@ void Board::invalidatePlanes(const Layer* layer) noexcept {
   Q_ASSERT((!layer) || (layer->isCopper()));
   if (layer) {
     mScheduledLayersForPlanesRebuild.insert(layer);
+    mScheduledAreasForPlanesRebuild.remove(layer);
   } else {
     mScheduledLayersForPlanesRebuild |= mCopperLayers;
+    mScheduledAreasForPlanesRebuild.clear();
   }
 }
 
@@ -557,12 +561,68 @@ void Board::invalidatePlanes(const QSet<const Layer*>& layers) noexcept {
   }
 #endif
   mScheduledLayersForPlanesRebuild |= layers;
+  foreach (const Layer* layer, layers) {
+    mScheduledAreasForPlanesRebuild.remove(layer);
+  }
+}
+
+void Board::invalidatePlanes(const QVector<Point>& points,
+                             const UnsignedLength& margin,
+                             const Layer* layer) noexcept {
+  Q_ASSERT((!layer) || (layer->isCopper()));
+  if (points.isEmpty()) {
+    return;
+  }
+  Point bottomLeft = points.first();
+  Point topRight = points.first();
+  for (const Point& p : points) {
+    bottomLeft.setX(std::min(bottomLeft.getX(), p.getX()));
+    bottomLeft.setY(std::min(bottomLeft.getY(), p.getY()));
+    topRight.setX(std::max(topRight.getX(), p.getX()));
+    topRight.setY(std::max(topRight.getY(), p.getY()));
+  }
+  const std::pair<Point, Point> area(bottomLeft - Point(*margin, *margin),
+                                     topRight + Point(*margin, *margin));
+  const QSet<const Layer*> layers =
+      layer ? QSet<const Layer*>{layer} : mCopperLayers;
+  foreach (const Layer* l, layers) {
+    if (!mScheduledLayersForPlanesRebuild.contains(l)) {
+      QVector<std::pair<Point, Point>>& areas =
+          mScheduledAreasForPlanesRebuild[l];
+      areas.append(area);
+      // Limit memory usage for many modifications between two rebuilds (e.g.
+      // while dragging) by merging all areas into their bounding box.
+      if (areas.count() > 100) {
+        std::pair<Point, Point> merged = areas.first();
+        for (const auto& a : std::as_const(areas)) {
+          merged.first.setX(std::min(merged.first.getX(), a.first.getX()));
+          merged.first.setY(std::min(merged.first.getY(), a.first.getY()));
+          merged.second.setX(std::max(merged.second.getX(), a.second.getX()));
+          merged.second.setY(std::max(merged.second.getY(), a.second.getY()));
+        }
+        areas = {merged};
+      }
+    }
+  }
 }
 
 QSet<const Layer*> Board::takeScheduledLayersForPlanesRebuild(
-    const QSet<const Layer*>& layers) noexcept {
+    const QSet<const Layer*>& layers,
+    QHash<const Layer*, QVector<std::pair<Point, Point>>>* areas) noexcept {
   auto result = mScheduledLayersForPlanesRebuild & layers;
   mScheduledLayersForPlanesRebuild -= layers;
+  for (auto it = mScheduledAreasForPlanesRebuild.begin();
+       it != mScheduledAreasForPlanesRebuild.end();) {
+    if (layers.contains(it.key())) {
+      if (areas) {
+        areas->insert(it.key(), it.value());
+      }
+      result.insert(it.key());
+      it = mScheduledAreasForPlanesRebuild.erase(it);
+    } else {
+      it++;
+    }
+  }
   return result;
 }
 
@@ -706,35 +766,28 @@ void Board::triggerAirWiresRebuild() noexcept {
     return;
   }
 
-  try {
-    foreach (NetSignal* netsignal, mScheduledNetSignalsForAirWireRebuild) {
-      // remove old airwires
-      while (BI_AirWire* airWire = mAirWires.take(netsignal)) {
-        airWire->removeFromBoard();  // can throw
-        emit airWireRemoved(*airWire);
-        delete airWire;
-      }
+  const QVector<AirWiresJob> jobs = takeScheduledAirWiresJobs();
+  if (!jobs.isEmpty()) {
+    applyAirWiresJobResults(
+        QtConcurrent::blockingMapped<QList<AirWiresJobResult>>(
+            jobs, &Board::runAirWiresJob));
+  }
+}
 
-      if (netsignal && netsignal->isAddedToCircuit()) {
-        // calculate new airwires
-        BoardAirWiresBuilder builder(*this, *netsignal);
-        QVector<std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*>>
-            airwires = builder.buildAirWires();
+void Board::triggerAirWiresRebuildAsync() noexcept {
+  if (!mIsAddedToProject) {
+    return;
+  }
 
-        // add new airwires
-        foreach (const auto& points, airwires) {
-          std::unique_ptr<BI_AirWire> airWire(
-              new BI_AirWire(*this, *netsignal, *points.first, *points.second));
-          airWire->addToBoard();  // can throw
-          mAirWires.insert(netsignal, airWire.get());
-          emit airWireAdded(*airWire.release());
-        }
-      }
-    }
-    mScheduledNetSignalsForAirWireRebuild.clear();
-  } catch (const std::exception&
-               e) {  // std::exception because of the many std containers...
-    qCritical() << "Failed to build airwires:" << e.what();
+  const QVector<AirWiresJob> jobs = takeScheduledAirWiresJobs();
+  if (!jobs.isEmpty()) {
+    auto watcher = new QFutureWatcher<AirWiresJobResult>(this);
+    connect(watcher, &QFutureWatcher<AirWiresJobResult>::finished, this,
+            [this, watcher]() {
+              applyAirWiresJobResults(watcher->future().results());
+              watcher->deleteLater();
+            });
+    watcher->setFuture(QtConcurrent::mapped(jobs, &Board::runAirWiresJob));
   }
 }
 
@@ -745,6 +798,13 @@ void Board::forceAirWiresRebuild() noexcept {
   triggerAirWiresRebuild();
 }
 
+void Board::forceAirWiresRebuildAsync() noexcept {
+  mScheduledNetSignalsForAirWireRebuild.unite(
+      Toolbox::toSet(mProject.getCircuit().getNetSignals().values()));
+  mScheduledNetSignalsForAirWireRebuild.unite(Toolbox::toSet(mAirWires.keys()));
+  triggerAirWiresRebuildAsync();
+}
+
 /*******************************************************************************
  *  General Methods
  ******************************************************************************/
@@ -962,7 +1022,7 @@ void Board::addToProject() {
   }
 
   mIsAddedToProject = true;
-  forceAirWiresRebuild();
+  forceAirWiresRebuildAsync();
   sgl.dismiss();
 }
 
@@ -1107,6 +1167,107 @@ void Board::save() {
   }
 }
 
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+QVector<Board::AirWiresJob> Board::takeScheduledAirWiresJobs() noexcept {
+  // Take a snapshot of all the data needed to calculate the air wires since
+  // the board must not be accessed from worker threads.
+  QVector<AirWiresJob> jobs;
+  jobs.reserve(mScheduledNetSignalsForAirWireRebuild.count());
+  foreach (NetSignal* netsignal, mScheduledNetSignalsForAirWireRebuild) {
+    // The current air wires are kept until the new ones are available to
+    // avoid flickering. They don't access their anchors anymore, so it's
+    // fine if the anchors are deleted in the meantime.
+    AirWiresJob job{netsignal, std::nullopt, ++mAirWiresRevision, nullptr};
+    if (netsignal && netsignal->isAddedToCircuit()) {
+      job.netSignalUuid = netsignal->getUuid();
+      job.builder = std::make_shared<BoardAirWiresBuilder>(*this, *netsignal);
+    }
+    mAirWiresPendingRevisions.insert(netsignal, job.revision);
+    jobs.append(job);
+  }
+  mScheduledNetSignalsForAirWireRebuild.clear();
+  return jobs;
+}
+
+void Board::removeAirWires(NetSignal* netsignal) noexcept {
+  while (BI_AirWire* airWire = mAirWires.take(netsignal)) {
+    try {
+      airWire->removeFromBoard();  // can throw
+    } catch (const Exception& e) {
+      qCritical() << "Failed to remove airwire:" << e.getMsg();
+    }
+    emit airWireRemoved(*airWire);
+    delete airWire;
+  }
+}
+
+Board::AirWiresJobResult Board::runAirWiresJob(
+    const AirWiresJob& job) noexcept {
+  AirWiresJobResult result{job.netSignal, job.netSignalUuid, job.revision, {},
+                           QString()};
+  try {
+    if (job.builder) {
+      result.airWires = job.builder->buildAirWires();
+    }
+  } catch (const std::exception& e) {
+    // std::exception because of the many std containers...
+    result.error = e.what();
+  }
+  return result;
+}
+
+void Board::applyAirWiresJobResults(
+    const QList<AirWiresJobResult>& results) noexcept {
+  foreach (const AirWiresJobResult& result, results) {
+    NetSignal* netsignal = result.netSignal;  // Do not dereference!
+
+    // Discard outdated results, i.e. if the net signal has been modified or
+    // calculated again since the snapshot was taken. In that case the anchors
+    // of the result might not even exist anymore.
+    if ((mAirWiresPendingRevisions.value(netsignal) != result.revision) ||
+        mScheduledNetSignalsForAirWireRebuild.contains(netsignal)) {
+      continue;
+    }
+    mAirWiresPendingRevisions.remove(netsignal);
+    if (!mIsAddedToProject) {
+      continue;
+    }
+
+    // Remove old airwires.
+    removeAirWires(netsignal);
+
+    try {
+      if (!result.error.isEmpty()) {
+        throw RuntimeError(__FILE__, __LINE__, result.error);
+      }
+
+      // The net signal might have been removed and deleted in the meantime,
+      // so look it up in the circuit instead of using the pointer.
+      NetSignal* currentNetSignal = result.netSignalUuid
+          ? mProject.getCircuit().getNetSignals().value(*result.netSignalUuid)
+          : nullptr;
+
+      // add new airwires
+      if (currentNetSignal && (currentNetSignal == netsignal) &&
+          currentNetSignal->isAddedToCircuit()) {
+        foreach (const auto& points, result.airWires) {
+          std::unique_ptr<BI_AirWire> airWire(new BI_AirWire(
+              *this, *currentNetSignal, *points.first, *points.second));
+          airWire->addToBoard();  // can throw
+          mAirWires.insert(netsignal, airWire.get());
+          emit airWireAdded(*airWire.release());
+        }
+      }
+    } catch (const std::exception&
+                 e) {  // std::exception because of the many std containers...
+      qCritical() << "Failed to build airwires:" << e.what();
+    }
+  }
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
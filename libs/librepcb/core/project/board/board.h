@@ -28,6 +28,7 @@
 #include "../../types/elementname.h"
 #include "../../types/length.h"
 #include "../../types/lengthunit.h"
+#include "../../types/point.h"
 #include "../../types/tag.h"
 #include "../../types/uuid.h"
 #include "../../types/version.h"
@@ -46,6 +47,7 @@ class BI_Base;
 class BI_Device;
 class BI_Hole;
 class BI_NetLine;
+class BI_NetLineAnchor;
 class BI_NetPoint;
 class BI_NetSegment;
 class BI_Pad;
@@ -54,6 +56,7 @@ class BI_Polygon;
 class BI_StrokeText;
 class BI_Via;
 class BI_Zone;
+class BoardAirWiresBuilder;
 class BoardDesignRuleCheckSettings;
 class BoardDesignRules;
 class BoardFabricationOutputSettings;
@@ -223,8 +226,36 @@ public:
   void removePlane(BI_Plane& plane);
   void invalidatePlanes(const Layer* layer = nullptr) noexcept;
   void invalidatePlanes(const QSet<const Layer*>& layers) noexcept;
+
+  /**
+   * @brief Schedule planes for rebuild within a limited area
+   *
+   * Compared to invalidating whole layers, this allows the plane builder to
+   * keep the fragments of planes far away from the modification.
+   *
+   * @param points  The points of the modified item, before and after the
+   *                modification. The invalidated area is their bounding box.
+   * @param margin  Margin around the bounding box, e.g. half the trace width.
+   * @param layer   The affected layer, or `nullptr` for all copper layers.
+   */
+  void invalidatePlanes(const QVector<Point>& points,
+                        const UnsignedLength& margin,
+                        const Layer* layer = nullptr) noexcept;
+
+  /**
+   * @brief Get and reset the layers scheduled for a planes rebuild
+   *
+   * @param layers  The layers to take. Other layers stay scheduled.
+   * @param areas   If not `nullptr`, the invalidated areas of layers which are
+   *                not completely invalidated are returned here. If `nullptr`,
+   *                these layers are considered as completely invalidated.
+   *
+   * @return All scheduled layers, including those with invalidated areas.
+   */
   QSet<const Layer*> takeScheduledLayersForPlanesRebuild(
-      const QSet<const Layer*>& layers) noexcept;
+      const QSet<const Layer*>& layers,
+      QHash<const Layer*, QVector<std::pair<Point, Point>>>* areas =
+          nullptr) noexcept;
 
   // Zone Methods
   const QMap<Uuid, BI_Zone*>& getZones() const noexcept { return mZones; }
@@ -255,8 +286,27 @@ public:
   void scheduleAirWiresRebuild(NetSignal* netsignal) noexcept {
     mScheduledNetSignalsForAirWireRebuild.insert(netsignal);
   }
+
+  /**
+   * @brief Rebuild the air wires of all scheduled net signals
+   *
+   * The net signals are calculated in parallel, but this method blocks until
+   * all air wires are updated.
+   */
   void triggerAirWiresRebuild() noexcept;
+
+  /**
+   * @brief Rebuild the air wires of all scheduled net signals in background
+   *
+   * Same as #triggerAirWiresRebuild(), but returns immediately. The air wires
+   * are updated later when the calculation has finished. Until then, the
+   * old air wires are kept (see BI_AirWire::getP1()). Results of net signals
+   * which have been modified in the meantime are discarded since they are
+   * outdated (they will be rebuilt by the next trigger anyway).
+   */
+  void triggerAirWiresRebuildAsync() noexcept;
   void forceAirWiresRebuild() noexcept;
+  void forceAirWiresRebuildAsync() noexcept;
 
   // General Methods
   std::optional<std::pair<Point, Point>> calculateBoundingRect() const noexcept;
@@ -296,6 +346,26 @@ signals:
   void airWireRemoved(BI_AirWire& airWire);
 
 private:
+  struct AirWiresJob {
+    NetSignal* netSignal;  ///< Only used as key, might be deleted meanwhile
+    std::optional<Uuid> netSignalUuid;  ///< To look up the net signal again
+    quint64 revision;
+    std::shared_ptr<const BoardAirWiresBuilder> builder;  ///< Or nullptr
+  };
+  struct AirWiresJobResult {
+    NetSignal* netSignal;  ///< Only used as key, might be deleted meanwhile
+    std::optional<Uuid> netSignalUuid;  ///< To look up the net signal again
+    quint64 revision;
+    QVector<std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*>>
+        airWires;
+    QString error;
+  };
+  QVector<AirWiresJob> takeScheduledAirWiresJobs() noexcept;
+  void removeAirWires(NetSignal* netsignal) noexcept;
+  static AirWiresJobResult runAirWiresJob(const AirWiresJob& job) noexcept;
+  void applyAirWiresJobResults(
+      const QList<AirWiresJobResult>& results) noexcept;
+
   // General
   Project& mProject;  ///< A reference to the Project object (from the ctor)
   const QString mDirectoryName;
@@ -307,6 +377,8 @@ private:
   QScopedPointer<BoardFabricationOutputSettings> mFabricationOutputSettings;
   QSet<NetSignal*> mScheduledNetSignalsForAirWireRebuild;
   QSet<const Layer*> mScheduledLayersForPlanesRebuild;
+  QHash<const Layer*, QVector<std::pair<Point, Point>>>
+      mScheduledAreasForPlanesRebuild;  ///< Layers not in the set above.
 
   // Attributes
   Uuid mUuid;
@@ -345,6 +417,10 @@ private:
   QMap<Uuid, BI_StrokeText*> mStrokeTexts;
   QMap<Uuid, BI_Hole*> mHoles;
   QMultiHash<NetSignal*, BI_AirWire*> mAirWires;
+
+  // Air wires calculation
+  quint64 mAirWiresRevision;  ///< Incremented for each calculated net signal
+  QHash<NetSignal*, quint64> mAirWiresPendingRevisions;  ///< Latest per net
 };
 
 /*******************************************************************************
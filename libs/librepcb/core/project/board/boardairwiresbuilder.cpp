@@ -23,8 +23,10 @@
 #include "boardairwiresbuilder.h"
 
 #include "../../algorithm/airwiresbuilder.h"
+#include "../../algorithm/boundingboxindex.h"
 #include "../../library/pkg/footprintpad.h"
 #include "../../types/layer.h"
+#include "../../utils/clipperhelpers.h"
 #include "../circuit/circuit.h"
 #include "../circuit/componentsignalinstance.h"
 #include "../circuit/netsignal.h"
@@ -48,133 +50,149 @@ namespace librepcb {
  *  Constructors / Destructor
  ******************************************************************************/
 
-BoardAirWiresBuilder::BoardAirWiresBuilder(const Board& board,
-                                           const NetSignal& netsignal) noexcept
-  : mBoard(board), mNetSignal(netsignal) {
-}
-
-BoardAirWiresBuilder::~BoardAirWiresBuilder() noexcept {
-}
-
-/*******************************************************************************
- *  General Methods
- ******************************************************************************/
-
-QVector<std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*>>
-    BoardAirWiresBuilder::buildAirWires() const {
-  AirWiresBuilder builder;
-
-  // Map from ID to (position, start layer number, end layer number)
-  QHash<int, std::tuple<Point, int, int>> pointLayerMap;
-
-  // Map from anchor to ID
-  QHash<const BI_NetLineAnchor*, int> anchorMap;
-
+BoardAirWiresBuilder::BoardAirWiresBuilder(
+    const Board& board, const NetSignal& netsignal) noexcept {
   // footprint pads
-  foreach (ComponentSignalInstance* cmpSig, mNetSignal.getComponentSignals()) {
+  foreach (ComponentSignalInstance* cmpSig, netsignal.getComponentSignals()) {
     Q_ASSERT(cmpSig);
     foreach (BI_Pad* pad, cmpSig->getRegisteredFootprintPads()) {
-      if (&pad->getBoard() != &mBoard) continue;
-      const Point& pos = pad->getPosition();
-      int id = builder.addPoint(pos);
+      if (&pad->getBoard() != &board) continue;
       if (pad->getProperties().isTht()) {
-        pointLayerMap[id] =
-            std::make_tuple(pos, Layer::topCopper().getCopperNumber(),
-                            Layer::botCopper().getCopperNumber());
+        addPoint(*pad, pad->getPosition(), Layer::topCopper().getCopperNumber(),
+                 Layer::botCopper().getCopperNumber());
       } else {
-        pointLayerMap[id] =
-            std::make_tuple(pos, pad->getSolderLayer().getCopperNumber(),
-                            pad->getSolderLayer().getCopperNumber());
+        addPoint(*pad, pad->getPosition(),
+                 pad->getSolderLayer().getCopperNumber(),
+                 pad->getSolderLayer().getCopperNumber());
       }
-      anchorMap[pad] = id;
     }
   }
 
   // board pads, vias, netpoints, netlines
-  foreach (const BI_NetSegment* netsegment, mNetSignal.getBoardNetSegments()) {
+  foreach (const BI_NetSegment* netsegment, netsignal.getBoardNetSegments()) {
     Q_ASSERT(netsegment);
-    if (&netsegment->getBoard() != &mBoard) continue;
+    if (&netsegment->getBoard() != &board) continue;
     foreach (const BI_Pad* pad, netsegment->getPads()) {
       Q_ASSERT(pad);
-      const Point& pos = pad->getPosition();
-      int id = builder.addPoint(pos);
       if (pad->getProperties().isTht()) {
-        pointLayerMap[id] =
-            std::make_tuple(pos, Layer::topCopper().getCopperNumber(),
-                            Layer::botCopper().getCopperNumber());
+        addPoint(*pad, pad->getPosition(), Layer::topCopper().getCopperNumber(),
+                 Layer::botCopper().getCopperNumber());
       } else {
-        pointLayerMap[id] =
-            std::make_tuple(pos, pad->getSolderLayer().getCopperNumber(),
-                            pad->getSolderLayer().getCopperNumber());
+        addPoint(*pad, pad->getPosition(),
+                 pad->getSolderLayer().getCopperNumber(),
+                 pad->getSolderLayer().getCopperNumber());
       }
-      anchorMap[pad] = id;
     }
     foreach (const BI_Via* via, netsegment->getVias()) {
       Q_ASSERT(via);
-      const Point& pos = via->getPosition();
-      int id = builder.addPoint(pos);
-      pointLayerMap[id] =
-          std::make_tuple(pos, via->getVia().getStartLayer().getCopperNumber(),
-                          via->getVia().getEndLayer().getCopperNumber());
-      anchorMap[via] = id;
+      addPoint(*via, via->getPosition(),
+               via->getVia().getStartLayer().getCopperNumber(),
+               via->getVia().getEndLayer().getCopperNumber());
     }
     foreach (const BI_NetPoint* netpoint, netsegment->getNetPoints()) {
       Q_ASSERT(netpoint);
       if (const Layer* layer = netpoint->getLayerOfTraces()) {
-        Point pos = netpoint->getPosition();
-        int id = builder.addPoint(pos);
-        pointLayerMap[id] = std::make_tuple(pos, layer->getCopperNumber(),
-                                            layer->getCopperNumber());
-        anchorMap[netpoint] = id;
+        addPoint(*netpoint, netpoint->getPosition(), layer->getCopperNumber(),
+                 layer->getCopperNumber());
       }
     }
     foreach (const BI_NetLine* netline, netsegment->getNetLines()) {
       Q_ASSERT(netline);
-      Q_ASSERT(anchorMap.contains(&netline->getP1()));
-      Q_ASSERT(anchorMap.contains(&netline->getP2()));
-      builder.addEdge(anchorMap[&netline->getP1()],
-                      anchorMap[&netline->getP2()]);
+      Q_ASSERT(mPointIndices.contains(&netline->getP1()));
+      Q_ASSERT(mPointIndices.contains(&netline->getP2()));
+      mEdges.append(std::make_pair(mPointIndices.value(&netline->getP1()),
+                                   mPointIndices.value(&netline->getP2())));
     }
   }
 
-  // determine connections made by planes
-  foreach (const BI_Plane* plane, mNetSignal.getBoardPlanes()) {
+  // plane fragments
+  foreach (const BI_Plane* plane, netsignal.getBoardPlanes()) {
     Q_ASSERT(plane);
-    if (&plane->getBoard() != &mBoard) continue;
+    if (&plane->getBoard() != &board) continue;
     const int planeLayer = plane->getLayer().getCopperNumber();
     foreach (const Path& fragment, plane->getFragments()) {
-      int lastId = -1;
-      for (auto it = pointLayerMap.begin(); it != pointLayerMap.end(); it++) {
-        const Point& pos = std::get<0>(it.value());
-        const int startLayer = std::get<1>(it.value());
-        const int endLayer = std::get<2>(it.value());
-        if ((planeLayer >= startLayer) && (planeLayer <= endLayer) &&
-            fragment.toQPainterPathPx().contains(pos.toPxQPointF())) {
-          if (lastId >= 0) {
-            builder.addEdge(lastId, it.key());
-          }
-          lastId = it.key();
+      mFragments.append(std::make_pair(fragment, planeLayer));
+    }
+  }
+}
+
+BoardAirWiresBuilder::~BoardAirWiresBuilder() noexcept {
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+BoardAirWiresBuilder::AirWires BoardAirWiresBuilder::buildAirWires() const {
+  // Note: The IDs returned by the builder are equal to the indices in mPoints.
+  AirWiresBuilder builder;
+  for (const AnchorPoint& point : mPoints) {
+    builder.addPoint(point.position);
+  }
+  for (const auto& edge : mEdges) {
+    builder.addEdge(edge.first, edge.second);
+  }
+
+  // determine connections made by planes
+  // Note: To avoid testing every point against every plane fragment, the
+  // fragments are converted to integer polygons once and their bounding boxes
+  // are put into a spatial index, so each point is only tested against the
+  // few fragments around it.
+  QVector<std::pair<ClipperLib::Path, int>> fragments;  // Path, copper layer
+  BoundingBoxIndex fragmentsIndex;
+  for (const auto& fragment : mFragments) {
+    // Note: Fragments contain no arcs, thus the tolerance is irrelevant.
+    const ClipperLib::Path path =
+        ClipperHelpers::convert(fragment.first, PositiveLength(5000));
+    fragmentsIndex.insert(fragments.count(),
+                          BoundingBoxIndex::Rect::fromPaths({path}));
+    fragments.append(std::make_pair(path, fragment.second));
+  }
+  QVector<int> lastIds(fragments.count(), -1);  // Last point per fragment.
+  for (int id = 0; id < mPoints.count(); ++id) {
+    const AnchorPoint& point = mPoints.at(id);
+    const ClipperLib::IntPoint pos = ClipperHelpers::convert(point.position);
+    const BoundingBoxIndex::Rect rect{pos.X, pos.Y, pos.X, pos.Y};
+    for (int index : fragmentsIndex.query(rect)) {
+      const int planeLayer = fragments.at(index).second;
+      // Note: Points on the outline are considered as inside.
+      if ((planeLayer >= point.startLayer) && (planeLayer <= point.endLayer) &&
+          (ClipperLib::PointInPolygon(pos, fragments.at(index).first) != 0)) {
+        if (lastIds.at(index) >= 0) {
+          builder.addEdge(lastIds.at(index), id);
         }
+        lastIds[index] = id;
       }
     }
   }
 
   // Calculate the airwires and convert them back to the result type.
   const AirWiresBuilder::AirWires airWireIds = builder.buildAirWires();
-  QVector<std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*>> result;
+  AirWires result;
   result.reserve(airWireIds.size());
   foreach (const AirWiresBuilder::AirWire& airWire, airWireIds) {
-    const BI_NetLineAnchor* p1 = anchorMap.key(airWire.first, nullptr);
-    const BI_NetLineAnchor* p2 = anchorMap.key(airWire.second, nullptr);
-    if ((!p1) || (!p2)) {
+    if ((airWire.first < 0) || (airWire.first >= mPoints.count()) ||
+        (airWire.second < 0) || (airWire.second >= mPoints.count())) {
       throw LogicError(__FILE__, __LINE__, "Unknown air wire IDs received.");
     }
-    result.append(std::make_pair(p1, p2));
+    result.append(std::make_pair(mPoints.at(airWire.first).anchor,
+                                 mPoints.at(airWire.second).anchor));
   }
 
   return result;
 }
 
+/*******************************************************************************
+ *  Private Methods
+ ******************************************************************************/
+
+void BoardAirWiresBuilder::addPoint(const BI_NetLineAnchor& anchor,
+                                    const Point& pos, int startLayer,
+                                    int endLayer) noexcept {
+  mPointIndices.insert(&anchor, mPoints.count());
+  mPoints.append(AnchorPoint{&anchor, pos, startLayer, endLayer});
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
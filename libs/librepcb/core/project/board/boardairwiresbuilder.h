@@ -23,6 +23,7 @@
 /*******************************************************************************
  *  Includes
  ******************************************************************************/
+#include "../../geometry/path.h"
 #include "../../types/point.h"
 
 #include <QtCore>
@@ -42,9 +43,18 @@ class NetSignal;
 
 /**
  * @brief The BoardAirWiresBuilder class
+ *
+ * The constructor takes a snapshot of all the data of a net signal needed to
+ * calculate its air wires, so it must be called in the thread owning the
+ * board. Afterwards, #buildAirWires() only works on that snapshot and does
+ * not access the board anymore, thus it can be called in any thread.
  */
 class BoardAirWiresBuilder final {
 public:
+  // Types
+  typedef std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*> AirWire;
+  typedef QVector<AirWire> AirWires;
+
   // Constructors / Destructor
   BoardAirWiresBuilder() = delete;
   BoardAirWiresBuilder(const BoardAirWiresBuilder& other) = delete;
@@ -52,15 +62,35 @@ public:
   ~BoardAirWiresBuilder() noexcept;
 
   // General Methods
-  QVector<std::pair<const BI_NetLineAnchor*, const BI_NetLineAnchor*>>
-      buildAirWires() const;
+
+  /**
+   * @brief Calculate the air wires of the net signal
+   *
+   * @note This method is thread-safe. The returned anchors are taken from
+   *       the snapshot and are not dereferenced by this method.
+   *
+   * @return Pairs of anchors to connect with air wires.
+   */
+  AirWires buildAirWires() const;
 
   // Operator Overloadings
   BoardAirWiresBuilder& operator=(const BoardAirWiresBuilder& rhs) = delete;
 
+private:  // Methods
+  void addPoint(const BI_NetLineAnchor& anchor, const Point& pos,
+                int startLayer, int endLayer) noexcept;
+
 private:  // Data
-  const Board& mBoard;
-  const NetSignal& mNetSignal;
+  struct AnchorPoint {
+    const BI_NetLineAnchor* anchor;
+    Point position;
+    int startLayer;  ///< Copper number
+    int endLayer;  ///< Copper number
+  };
+  QVector<AnchorPoint> mPoints;
+  QHash<const BI_NetLineAnchor*, int> mPointIndices;  ///< Index in #mPoints
+  QVector<std::pair<int, int>> mEdges;  ///< Indices in #mPoints
+  QVector<std::pair<Path, int>> mFragments;  ///< Path, copper number
 };
 
 /*******************************************************************************
@@ -51,6 +51,7 @@
 #include "items/bi_stroketext.h"
 #include "items/bi_via.h"
 
+#include <QtConcurrent>
 #include <QtCore>
 
 /*******************************************************************************
@@ -76,9 +77,7 @@ BoardGerberExport::BoardGerberExport(const Board& board) noexcept
     mBeforeWriteCallback(),
     mCreationDateTime(QDateTime::currentDateTime()),
     mProjectName(*mProject.getName()),
-    mCurrentInnerCopperLayer(0),
-    mCurrentStartLayer(nullptr),
-    mCurrentEndLayer(nullptr) {
+    mThreadCount(0) {
   // If the project contains multiple boards, add the board name to the
   // Gerber file metadata as well to distinguish between the different boards.
   if (mProject.getBoards().count() > 1) {
@@ -111,6 +110,10 @@ void BoardGerberExport::setBeforeWriteCallback(BeforeWriteCallback cb) {
   mBeforeWriteCallback = cb;
 }
 
+void BoardGerberExport::setThreadCount(int count) noexcept {
+  mThreadCount = count;
+}
+
 /*******************************************************************************
  *  General Methods
  ******************************************************************************/
@@ -119,20 +122,50 @@ void BoardGerberExport::exportPcbLayers(
     const BoardFabricationOutputSettings& settings) const {
   mWrittenFiles.clear();
 
-  exportDrillsMerged(settings);
-  exportDrillsNpth(settings);
-  exportDrillsPth(settings);
-  exportDrillsBlindBuried(settings);
-  exportLayerBoardOutlines(settings);
-  exportLayerTopCopper(settings);
-  exportLayerInnerCopper(settings);
-  exportLayerBottomCopper(settings);
-  exportLayerTopSolderMask(settings);
-  exportLayerBottomSolderMask(settings);
-  exportLayerTopSilkscreen(settings);
-  exportLayerBottomSilkscreen(settings);
-  exportLayerTopSolderPaste(settings);
-  exportLayerBottomSolderPaste(settings);
+  QVector<OutputFile> files;
+  exportDrillsMerged(settings, files);
+  exportDrillsNpth(settings, files);
+  exportDrillsPth(settings, files);
+  exportDrillsBlindBuried(settings, files);
+  exportLayerBoardOutlines(settings, files);
+  exportLayerTopCopper(settings, files);
+  exportLayerInnerCopper(settings, files);
+  exportLayerBottomCopper(settings, files);
+  exportLayerTopSolderMask(settings, files);
+  exportLayerBottomSolderMask(settings, files);
+  exportLayerTopSilkscreen(settings, files);
+  exportLayerBottomSilkscreen(settings, files);
+  exportLayerTopSolderPaste(settings, files);
+  exportLayerBottomSolderPaste(settings, files);
+
+  // Track the written files and remove obsolete files in the calling thread
+  // and in a well-defined order, since removing obsolete files depends on
+  // which files are written.
+  for (const OutputFile& file : std::as_const(files)) {
+    if (file.generator) {
+      trackFileBeforeWrite(file.filePath);  // can throw
+    }
+  }
+  for (const OutputFile& file : std::as_const(files)) {
+    if ((!file.generator) && mRemoveObsoleteFiles &&
+        file.filePath.isExistingFile() &&
+        (!mWrittenFiles.contains(file.filePath))) {
+      FileUtils::removeFile(file.filePath);  // can throw
+    }
+  }
+
+  // The files are independent of each other and the generators only read
+  // from the board, so generate them concurrently. Each file is streamed to
+  // disk by its own job to avoid keeping the content of all files in memory.
+  QThreadPool pool;
+  if (mThreadCount > 0) {
+    pool.setMaxThreadCount(mThreadCount);
+  }
+  QtConcurrent::blockingMap(&pool, files, [](const OutputFile& file) {
+    if (file.generator) {
+      FileUtils::writeFile(file.filePath, file.generator);  // can throw
+    }
+  });  // can throw
 }
 
 void BoardGerberExport::exportGlueLayer(BoardSide side,
@@ -149,7 +182,6 @@ void BoardGerberExport::exportGlueLayer(BoardSide side,
                             GerberGenerator::Polarity::Positive);
     drawGlueLayer(gen, Layer::botGlue(), assemblyVariant);
   }
-  gen.generate();
   trackFileBeforeWrite(filePath);  // can throw
   gen.saveToFile(filePath);
 }
@@ -319,7 +351,6 @@ void BoardGerberExport::exportComponentLayer(BoardSide side,
     }
   }
 
-  gen.generate();
   trackFileBeforeWrite(filePath);  // can throw
   gen.saveToFile(filePath);
 }
@@ -329,34 +360,31 @@ void BoardGerberExport::exportComponentLayer(BoardSide side,
  ******************************************************************************/
 
 void BoardGerberExport::exportDrillsMerged(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixDrills());
   if (settings.getMergeDrillFiles()) {
-    std::unique_ptr<ExcellonGenerator> gen =
-        BoardGerberExport::createExcellonGenerator(
-            settings, ExcellonGenerator::Plating::Mixed);
-    drawPthDrills(*gen);
-    drawNpthDrills(*gen);
-    gen->generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen->saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this, &settings](QIODevice& device) {
+      std::unique_ptr<ExcellonGenerator> gen =
+          BoardGerberExport::createExcellonGenerator(
+              settings, ExcellonGenerator::Plating::Mixed);
+      drawPthDrills(*gen);
+      drawNpthDrills(*gen);
+      gen->generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportDrillsNpth(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixDrillsNpth());
   if (!settings.getMergeDrillFiles()) {
-    std::unique_ptr<ExcellonGenerator> gen =
-        BoardGerberExport::createExcellonGenerator(
-            settings, ExcellonGenerator::Plating::No);
-    drawNpthDrills(*gen);
-
     // Note that separate NPTH drill files could lead to issues with some PCB
     // manufacturers, even if it's empty in many cases. However, we generate the
     // NPTH file even if there are no NPTH drills since it could also lead to
@@ -364,246 +392,266 @@ void BoardGerberExport::exportDrillsNpth(
     // https://github.com/LibrePCB/LibrePCB/issues/998. If the PCB manufacturer
     // doesn't support a separate NPTH file, the user shall enable the
     // "merge PTH and NPTH drills"  option.
-    gen->generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen->saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this, &settings](QIODevice& device) {
+      std::unique_ptr<ExcellonGenerator> gen =
+          BoardGerberExport::createExcellonGenerator(
+              settings, ExcellonGenerator::Plating::No);
+      drawNpthDrills(*gen);
+      gen->generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportDrillsPth(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixDrillsPth());
   if (!settings.getMergeDrillFiles()) {
-    std::unique_ptr<ExcellonGenerator> gen =
-        BoardGerberExport::createExcellonGenerator(
-            settings, ExcellonGenerator::Plating::Yes);
-    drawPthDrills(*gen);
-    gen->generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen->saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this, &settings](QIODevice& device) {
+      std::unique_ptr<ExcellonGenerator> gen =
+          BoardGerberExport::createExcellonGenerator(
+              settings, ExcellonGenerator::Plating::Yes);
+      drawPthDrills(*gen);
+      gen->generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportDrillsBlindBuried(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   auto vias = getBlindBuriedVias();
   for (auto it = vias.begin(); it != vias.end(); it++) {
-    mCurrentStartLayer = it.key().first;
-    mCurrentEndLayer = it.key().second;
     const FilePath fp = getOutputFilePath(
-        settings.getOutputBasePath() % settings.getSuffixDrillsBlindBuried());
-    std::unique_ptr<ExcellonGenerator> gen =
-        BoardGerberExport::createExcellonGenerator(
-            settings, ExcellonGenerator::Plating::Yes);
-    foreach (const BI_Via* via, it.value()) {
-      gen->drill(via->getPosition(), via->getActualDrillDiameter(), true,
-                 ExcellonGenerator::Function::ViaDrill);
-    }
-    gen->generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen->saveToFile(fp);
+        settings.getOutputBasePath() % settings.getSuffixDrillsBlindBuried(),
+        0, it.key());
+    const QList<const BI_Via*> spanVias = it.value();
+    auto generator = [this, &settings, spanVias](QIODevice& device) {
+      std::unique_ptr<ExcellonGenerator> gen =
+          BoardGerberExport::createExcellonGenerator(
+              settings, ExcellonGenerator::Plating::Yes);
+      foreach (const BI_Via* via, spanVias) {
+        gen->drill(via->getPosition(), via->getActualDrillDiameter(), true,
+                   ExcellonGenerator::Function::ViaDrill);
+      }
+      gen->generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
   }
 }
 
 void BoardGerberExport::exportLayerBoardOutlines(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                   settings.getSuffixOutlines());
-  GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                      *mProject.getVersion());
-  gen.setFileFunctionOutlines(false);
-  drawLayer(gen, Layer::boardOutlines());
-  drawLayer(gen, Layer::boardCutouts());
-  // Note: Currently the "plated cutouts" layer is exported to the normal board
-  // outlines Gerber file, which is not ideal but unfortunately there doesn't
-  // exist a standardized way of exporting plated cutouts :-( This way may
-  // still work fine if there is copper around the plated cutout polygons,
-  // therefore we have implemented a DRC warning if this is not the case.
-  drawLayer(gen, Layer::boardPlatedCutouts());
-  gen.generate();
-  trackFileBeforeWrite(fp);  // can throw
-  gen.saveToFile(fp);
+  auto generator = [this](QIODevice& device) {
+    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                        *mProject.getVersion());
+    gen.setFileFunctionOutlines(false);
+    drawLayer(gen, Layer::boardOutlines());
+    drawLayer(gen, Layer::boardCutouts());
+    // Note: Currently the "plated cutouts" layer is exported to the normal
+    // board outlines Gerber file, which is not ideal but unfortunately there
+    // doesn't exist a standardized way of exporting plated cutouts :-( This
+    // way may still work fine if there is copper around the plated cutout
+    // polygons, therefore we have implemented a DRC warning if this is not
+    // the case.
+    drawLayer(gen, Layer::boardPlatedCutouts());
+    gen.generate(device);  // can throw
+  };
+  files.append(OutputFile{fp, generator});
 }
 
 void BoardGerberExport::exportLayerTopCopper(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                   settings.getSuffixCopperTop());
-  GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                      *mProject.getVersion());
-  gen.setFileFunctionCopper(1, GerberGenerator::CopperSide::Top,
-                            GerberGenerator::Polarity::Positive);
-  drawLayer(gen, Layer::topCopper());
-  gen.generate();
-  trackFileBeforeWrite(fp);  // can throw
-  gen.saveToFile(fp);
+  auto generator = [this](QIODevice& device) {
+    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                        *mProject.getVersion());
+    gen.setFileFunctionCopper(1, GerberGenerator::CopperSide::Top,
+                              GerberGenerator::Polarity::Positive);
+    drawLayer(gen, Layer::topCopper());
+    gen.generate(device);  // can throw
+  };
+  files.append(OutputFile{fp, generator});
 }
 
 void BoardGerberExport::exportLayerBottomCopper(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                   settings.getSuffixCopperBot());
-  GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                      *mProject.getVersion());
-  gen.setFileFunctionCopper(mBoard.getInnerLayerCount() + 2,
-                            GerberGenerator::CopperSide::Bottom,
-                            GerberGenerator::Polarity::Positive);
-  drawLayer(gen, Layer::botCopper());
-  gen.generate();
-  trackFileBeforeWrite(fp);  // can throw
-  gen.saveToFile(fp);
+  auto generator = [this](QIODevice& device) {
+    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                        *mProject.getVersion());
+    gen.setFileFunctionCopper(mBoard.getInnerLayerCount() + 2,
+                              GerberGenerator::CopperSide::Bottom,
+                              GerberGenerator::Polarity::Positive);
+    drawLayer(gen, Layer::botCopper());
+    gen.generate(device);  // can throw
+  };
+  files.append(OutputFile{fp, generator});
 }
 
 void BoardGerberExport::exportLayerInnerCopper(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   for (int i = 1; i <= mBoard.getInnerLayerCount(); ++i) {
-    mCurrentInnerCopperLayer = i;  // used for attribute provider
-    FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
-                                    settings.getSuffixCopperInner());
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionCopper(i + 1, GerberGenerator::CopperSide::Inner,
-                              GerberGenerator::Polarity::Positive);
-    if (const Layer* layer = Layer::innerCopper(i)) {
-      drawLayer(gen, *layer);
-    } else {
+    FilePath fp = getOutputFilePath(
+        settings.getOutputBasePath() % settings.getSuffixCopperInner(), i);
+    const Layer* layer = Layer::innerCopper(i);
+    if (!layer) {
       throw LogicError(__FILE__, __LINE__, "Unknown inner copper layer.");
     }
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
+    auto generator = [this, i, layer](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionCopper(i + 1, GerberGenerator::CopperSide::Inner,
+                                GerberGenerator::Polarity::Positive);
+      drawLayer(gen, *layer);
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
   }
-  mCurrentInnerCopperLayer = 0;
 }
 
 void BoardGerberExport::exportLayerTopSolderMask(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSolderMaskTop());
   if (mBoard.getSolderResist()) {
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionSolderMask(GerberGenerator::BoardSide::Top,
-                                  GerberGenerator::Polarity::Negative);
-    drawLayer(gen, Layer::topStopMask());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionSolderMask(GerberGenerator::BoardSide::Top,
+                                    GerberGenerator::Polarity::Negative);
+      drawLayer(gen, Layer::topStopMask());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportLayerBottomSolderMask(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSolderMaskBot());
   if (mBoard.getSolderResist()) {
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionSolderMask(GerberGenerator::BoardSide::Bottom,
-                                  GerberGenerator::Polarity::Negative);
-    drawLayer(gen, Layer::botStopMask());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionSolderMask(GerberGenerator::BoardSide::Bottom,
+                                    GerberGenerator::Polarity::Negative);
+      drawLayer(gen, Layer::botStopMask());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportLayerTopSilkscreen(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSilkscreenTop());
-  const QVector<const Layer*>& layers = mBoard.getSilkscreenLayersTop();
+  const QVector<const Layer*> layers = mBoard.getSilkscreenLayersTop();
   if (layers.count() > 0) {  // don't export silkscreen if no layers selected
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionLegend(GerberGenerator::BoardSide::Top,
-                              GerberGenerator::Polarity::Positive);
-    foreach (const Layer* layer, layers) {
-      drawLayer(gen, *layer);
-    }
-    gen.setLayerPolarity(GerberGenerator::Polarity::Negative);
-    drawLayer(gen, Layer::topStopMask());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this, layers](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionLegend(GerberGenerator::BoardSide::Top,
+                                GerberGenerator::Polarity::Positive);
+      foreach (const Layer* layer, layers) {
+        drawLayer(gen, *layer);
+      }
+      gen.setLayerPolarity(GerberGenerator::Polarity::Negative);
+      drawLayer(gen, Layer::topStopMask());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportLayerBottomSilkscreen(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSilkscreenBot());
-  const QVector<const Layer*>& layers = mBoard.getSilkscreenLayersBot();
+  const QVector<const Layer*> layers = mBoard.getSilkscreenLayersBot();
   if (layers.count() > 0) {  // don't export silkscreen if no layers selected
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionLegend(GerberGenerator::BoardSide::Bottom,
-                              GerberGenerator::Polarity::Positive);
-    foreach (const Layer* layer, layers) {
-      drawLayer(gen, *layer);
-    }
-    gen.setLayerPolarity(GerberGenerator::Polarity::Negative);
-    drawLayer(gen, Layer::botStopMask());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this, layers](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionLegend(GerberGenerator::BoardSide::Bottom,
+                                GerberGenerator::Polarity::Positive);
+      foreach (const Layer* layer, layers) {
+        drawLayer(gen, *layer);
+      }
+      gen.setLayerPolarity(GerberGenerator::Polarity::Negative);
+      drawLayer(gen, Layer::botStopMask());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportLayerTopSolderPaste(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSolderPasteTop());
   if (settings.getEnableSolderPasteTop()) {
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionPaste(GerberGenerator::BoardSide::Top,
-                             GerberGenerator::Polarity::Positive);
-    drawLayer(gen, Layer::topSolderPaste());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionPaste(GerberGenerator::BoardSide::Top,
+                               GerberGenerator::Polarity::Positive);
+      drawLayer(gen, Layer::topSolderPaste());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
 void BoardGerberExport::exportLayerBottomSolderPaste(
-    const BoardFabricationOutputSettings& settings) const {
+    const BoardFabricationOutputSettings& settings,
+    QVector<OutputFile>& files) const {
   const FilePath fp = getOutputFilePath(settings.getOutputBasePath() %
                                         settings.getSuffixSolderPasteBot());
   if (settings.getEnableSolderPasteBot()) {
-    GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
-                        *mProject.getVersion());
-    gen.setFileFunctionPaste(GerberGenerator::BoardSide::Bottom,
-                             GerberGenerator::Polarity::Positive);
-    drawLayer(gen, Layer::botSolderPaste());
-    gen.generate();
-    trackFileBeforeWrite(fp);  // can throw
-    gen.saveToFile(fp);
-  } else if (mRemoveObsoleteFiles && fp.isExistingFile() &&
-             (!mWrittenFiles.contains(fp))) {
-    FileUtils::removeFile(fp);
+    auto generator = [this](QIODevice& device) {
+      GerberGenerator gen(mCreationDateTime, mProjectName, mBoard.getUuid(),
+                          *mProject.getVersion());
+      gen.setFileFunctionPaste(GerberGenerator::BoardSide::Bottom,
+                               GerberGenerator::Polarity::Positive);
+      drawLayer(gen, Layer::botSolderPaste());
+      gen.generate(device);  // can throw
+    };
+    files.append(OutputFile{fp, generator});
+  } else {
+    files.append(OutputFile{fp, nullptr});
   }
 }
 
@@ -1113,9 +1161,14 @@ std::unique_ptr<ExcellonGenerator> BoardGerberExport::createExcellonGenerator(
   return gen;
 }
 
-FilePath BoardGerberExport::getOutputFilePath(QString path) const noexcept {
+FilePath BoardGerberExport::getOutputFilePath(
+    QString path, int innerCopperLayer,
+    const LayerPair& drillSpan) const noexcept {
   path = AttributeSubstitutor::substitute(
-      path, [this](const QString& key) { return getAttributeValue(key); },
+      path,
+      [&](const QString& key) {
+        return getAttributeValue(key, innerCopperLayer, drillSpan);
+      },
       [&](const QString& str) {
         return FilePath::cleanFileName(
             str, FilePath::ReplaceSpaces | FilePath::KeepCase);
@@ -1129,7 +1182,8 @@ FilePath BoardGerberExport::getOutputFilePath(QString path) const noexcept {
 }
 
 QString BoardGerberExport::getAttributeValue(
-    const QString& key) const noexcept {
+    const QString& key, int innerCopperLayer,
+    const LayerPair& drillSpan) const noexcept {
   auto getLayerName = [](const Layer* layer) {
     Q_ASSERT(layer && layer->isCopper());
     if (layer->isTop()) {
@@ -1141,16 +1195,18 @@ QString BoardGerberExport::getAttributeValue(
     }
   };
 
-  if ((key == QLatin1String("CU_LAYER")) && (mCurrentInnerCopperLayer > 0)) {
-    return QString::number(mCurrentInnerCopperLayer);
-  } else if ((mCurrentStartLayer) && (key == QLatin1String("START_LAYER"))) {
-    return getLayerName(mCurrentStartLayer);
-  } else if ((mCurrentEndLayer) && (key == QLatin1String("END_LAYER"))) {
-    return getLayerName(mCurrentEndLayer);
-  } else if ((mCurrentStartLayer) && (key == QLatin1String("START_NUMBER"))) {
-    return QString::number(mCurrentStartLayer->getCopperNumber() + 1);
-  } else if ((mCurrentEndLayer) && (key == QLatin1String("END_NUMBER"))) {
-    return QString::number(mCurrentEndLayer->getCopperNumber() + 1);
+  const Layer* startLayer = drillSpan.first;
+  const Layer* endLayer = drillSpan.second;
+  if ((key == QLatin1String("CU_LAYER")) && (innerCopperLayer > 0)) {
+    return QString::number(innerCopperLayer);
+  } else if ((startLayer) && (key == QLatin1String("START_LAYER"))) {
+    return getLayerName(startLayer);
+  } else if ((endLayer) && (key == QLatin1String("END_LAYER"))) {
+    return getLayerName(endLayer);
+  } else if ((startLayer) && (key == QLatin1String("START_NUMBER"))) {
+    return QString::number(startLayer->getCopperNumber() + 1);
+  } else if ((endLayer) && (key == QLatin1String("END_NUMBER"))) {
+    return QString::number(endLayer->getCopperNumber() + 1);
   } else {
     const ProjectAttributeLookup lookup(mBoard, nullptr);
     return lookup(key);
@@ -82,6 +82,14 @@ public:
   void setRemoveObsoleteFiles(bool remove);
   void setBeforeWriteCallback(BeforeWriteCallback cb);
 
+  /**
+   * @brief Set the number of threads used by #exportPcbLayers()
+   *
+   * @param count   Maximum number of files generated concurrently. If zero
+   *                or negative, QThread::idealThreadCount() is used.
+   */
+  void setThreadCount(int count) noexcept;
+
   // General Methods
   void exportPcbLayers(const BoardFabricationOutputSettings& settings) const;
   void exportGlueLayer(BoardSide side, const Uuid& assemblyVariant,
@@ -93,32 +101,51 @@ public:
   BoardGerberExport& operator=(const BoardGerberExport& rhs) = delete;
 
 private:
+  /**
+   * @brief A file to be written by #exportPcbLayers()
+   *
+   * The generator is called from a worker thread and must therefore only
+   * read from the board. It streams the file content into the passed device.
+   * If no generator is set, the file is not exported and an existing file
+   * gets removed (if enabled).
+   */
+  struct OutputFile {
+    FilePath filePath;
+    std::function<void(QIODevice&)> generator;
+  };
+
   // Private Methods
-  void exportDrillsMerged(const BoardFabricationOutputSettings& settings) const;
-  void exportDrillsNpth(const BoardFabricationOutputSettings& settings) const;
-  void exportDrillsPth(const BoardFabricationOutputSettings& settings) const;
-  void exportDrillsBlindBuried(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerBoardOutlines(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerTopCopper(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerInnerCopper(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerBottomCopper(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerTopSolderMask(
-      const BoardFabricationOutputSettings& settings) const;
+  void exportDrillsMerged(const BoardFabricationOutputSettings& settings,
+                          QVector<OutputFile>& files) const;
+  void exportDrillsNpth(const BoardFabricationOutputSettings& settings,
+                        QVector<OutputFile>& files) const;
+  void exportDrillsPth(const BoardFabricationOutputSettings& settings,
+                       QVector<OutputFile>& files) const;
+  void exportDrillsBlindBuried(const BoardFabricationOutputSettings& settings,
+                               QVector<OutputFile>& files) const;
+  void exportLayerBoardOutlines(const BoardFabricationOutputSettings& settings,
+                                QVector<OutputFile>& files) const;
+  void exportLayerTopCopper(const BoardFabricationOutputSettings& settings,
+                            QVector<OutputFile>& files) const;
+  void exportLayerInnerCopper(const BoardFabricationOutputSettings& settings,
+                              QVector<OutputFile>& files) const;
+  void exportLayerBottomCopper(const BoardFabricationOutputSettings& settings,
+                               QVector<OutputFile>& files) const;
+  void exportLayerTopSolderMask(const BoardFabricationOutputSettings& settings,
+                                QVector<OutputFile>& files) const;
   void exportLayerBottomSolderMask(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerTopSilkscreen(
-      const BoardFabricationOutputSettings& settings) const;
+      const BoardFabricationOutputSettings& settings,
+      QVector<OutputFile>& files) const;
+  void exportLayerTopSilkscreen(const BoardFabricationOutputSettings& settings,
+                                QVector<OutputFile>& files) const;
   void exportLayerBottomSilkscreen(
-      const BoardFabricationOutputSettings& settings) const;
-  void exportLayerTopSolderPaste(
-      const BoardFabricationOutputSettings& settings) const;
+      const BoardFabricationOutputSettings& settings,
+      QVector<OutputFile>& files) const;
+  void exportLayerTopSolderPaste(const BoardFabricationOutputSettings& settings,
+                                 QVector<OutputFile>& files) const;
   void exportLayerBottomSolderPaste(
-      const BoardFabricationOutputSettings& settings) const;
+      const BoardFabricationOutputSettings& settings,
+      QVector<OutputFile>& files) const;
 
   int drawNpthDrills(ExcellonGenerator& gen) const;
   int drawPthDrills(ExcellonGenerator& gen) const;
@@ -144,8 +171,11 @@ private:
   std::unique_ptr<ExcellonGenerator> createExcellonGenerator(
       const BoardFabricationOutputSettings& settings,
       ExcellonGenerator::Plating plating) const;
-  FilePath getOutputFilePath(QString path) const noexcept;
-  QString getAttributeValue(const QString& key) const noexcept;
+  FilePath getOutputFilePath(
+      QString path, int innerCopperLayer = 0,
+      const LayerPair& drillSpan = LayerPair(nullptr, nullptr)) const noexcept;
+  QString getAttributeValue(const QString& key, int innerCopperLayer,
+                            const LayerPair& drillSpan) const noexcept;
   void trackFileBeforeWrite(const FilePath& fp) const;
 
   // Static Methods
@@ -159,9 +189,7 @@ private:
   BeforeWriteCallback mBeforeWriteCallback;
   QDateTime mCreationDateTime;
   QString mProjectName;
-  mutable int mCurrentInnerCopperLayer;
-  mutable const Layer* mCurrentStartLayer;
-  mutable const Layer* mCurrentEndLayer;
+  int mThreadCount;
   mutable QVector<FilePath> mWrittenFiles;
 };
 
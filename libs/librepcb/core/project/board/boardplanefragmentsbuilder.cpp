@@ -22,6 +22,7 @@
  ******************************************************************************/
 #include "boardplanefragmentsbuilder.h"
 
+#include "../../algorithm/boundingboxindex.h"
 #include "../../library/pkg/footprint.h"
 #include "../../library/pkg/footprintpad.h"
 #include "../../utils/clipperhelpers.h"
@@ -51,6 +52,104 @@
  ******************************************************************************/
 namespace librepcb {
 
+/*******************************************************************************
+ *  Non-Member Functions
+ ******************************************************************************/
+
+// Prefixes for the obstacle cache keys to get distinct keys for different
+// kinds of areas calculated from the same data.
+enum class ObstacleType : int {
+  Plane,
+  Hole,
+  ViaCopper,
+  ViaClearance,
+  PolygonCopper,
+  PolygonClearance,
+  PadCopper,
+  PadClearance,
+  PadHoles,
+};
+
+// The obstacle cache keys consist of the raw data an area is calculated from
+// rather than of a hash, so different data can never lead to the same key.
+static void addToKey(QByteArray& key, qint64 value) noexcept {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void addToKey(QByteArray& key, const QByteArray& value) noexcept {
+  key.append(value);
+}
+
+static void addToKey(QByteArray& key, const Length& value) noexcept {
+  addToKey(key, value.toNm());
+}
+
+static void addToKey(QByteArray& key, const UnsignedLength& value) noexcept {
+  addToKey(key, value->toNm());
+}
+
+static void addToKey(QByteArray& key, const PositiveLength& value) noexcept {
+  addToKey(key, value->toNm());
+}
+
+static void addToKey(QByteArray& key, const Point& value) noexcept {
+  addToKey(key, value.getX());
+  addToKey(key, value.getY());
+}
+
+static void addToKey(QByteArray& key, const Path& path) noexcept {
+  addToKey(key, static_cast<qint64>(path.getVertices().count()));
+  for (const Vertex& vertex : path.getVertices()) {
+    addToKey(key, vertex.getPos());
+    addToKey(key, static_cast<qint64>(vertex.getAngle().toMicroDeg()));
+  }
+}
+
+static void addToKey(QByteArray& key, const Transform& transform) noexcept {
+  addToKey(key, transform.getPosition());
+  addToKey(key, static_cast<qint64>(transform.getRotation().toMicroDeg()));
+  addToKey(key, static_cast<qint64>(transform.getMirrored()));
+}
+
+static void addToKey(QByteArray& key, const PadGeometry& geometry) noexcept {
+  addToKey(key, static_cast<qint64>(geometry.getShape()));
+  addToKey(key, geometry.getWidth());
+  addToKey(key, geometry.getHeight());
+  addToKey(key, geometry.getCornerRadius());
+  addToKey(key, geometry.getPath());
+  addToKey(key, static_cast<qint64>(geometry.getHoles().count()));
+  for (const PadHole& hole : geometry.getHoles()) {
+    addToKey(key, hole.getDiameter());
+    addToKey(key, *hole.getPath());
+  }
+}
+
+template <typename... Args>
+static QByteArray makeObstacleKey(ObstacleType type,
+                                  const Args&... args) noexcept {
+  QByteArray key;
+  addToKey(key, static_cast<qint64>(type));
+  (addToKey(key, args), ...);
+  return key;
+}
+
+// Plane fragments can be large, thus they are identified by a cryptographic
+// hash instead of their raw data.
+static QByteArray digestPaths(const ClipperLib::Paths& paths) noexcept {
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  for (const ClipperLib::Path& path : paths) {
+    QByteArray data;
+    data.reserve((path.size() * 2 + 1) * sizeof(qint64));
+    addToKey(data, static_cast<qint64>(path.size()));
+    for (const ClipperLib::IntPoint& point : path) {
+      addToKey(data, static_cast<qint64>(point.X));
+      addToKey(data, static_cast<qint64>(point.Y));
+    }
+    hash.addData(data);
+  }
+  return hash.result();
+}
+
 /*******************************************************************************
  *  Class BoardPlaneFragmentsBuilder::Result
  ******************************************************************************/
@@ -89,7 +188,13 @@ bool BoardPlaneFragmentsBuilder::Result::applyToBoard() noexcept {
  ******************************************************************************/
 
 BoardPlaneFragmentsBuilder::BoardPlaneFragmentsBuilder(QObject* parent) noexcept
-  : QObject(parent), mFuture(), mAbort(false) {
+  : QObject(parent),
+    mFuture(),
+    mAbort(false),
+    mObstacleCacheMutex(),
+    mObstacleCache(),
+    mObstacleCacheHits(0),
+    mObstacleCacheMisses(0) {
 }
 
 BoardPlaneFragmentsBuilder::~BoardPlaneFragmentsBuilder() noexcept {
@@ -154,8 +259,11 @@ std::shared_ptr<BoardPlaneFragmentsBuilder::JobData>
     }
   }
 
-  QSet<const Layer*> layers =
-      board.takeScheduledLayersForPlanesRebuild(layersWithPlanes);
+  // For a quick rebuild, layers which are only invalidated within some areas
+  // are rebuilt partially. A full rebuild always rebuilds everything.
+  QHash<const Layer*, QVector<std::pair<Point, Point>>> dirtyAreas;
+  QSet<const Layer*> layers = board.takeScheduledLayersForPlanesRebuild(
+      layersWithPlanes, filter ? &dirtyAreas : nullptr);
   if (!filter) {
     layers |= layersWithPlanes;
   }
@@ -165,6 +273,7 @@ std::shared_ptr<BoardPlaneFragmentsBuilder::JobData>
 
   auto data = std::make_shared<JobData>();
   data->layers = Toolbox::toList(layers);
+  data->dirtyAreas = dirtyAreas;
   layers.insert(&Layer::boardOutlines());
   layers.insert(&Layer::boardCutouts());
   foreach (const BI_Device* device, board.getDeviceInstances()) {
@@ -237,7 +346,7 @@ std::shared_ptr<BoardPlaneFragmentsBuilder::JobData>
                     toOptionalClearance(plane->getMinClearanceToNpth()),
                     plane->getKeepIslands(), plane->getPriority(),
                     plane->getConnectStyle(), plane->getThermalGap(),
-                    plane->getThermalSpokeWidth()});
+                    plane->getThermalSpokeWidth(), plane->getFragments()});
     }
   }
   foreach (const BI_Zone* zone, board.getZones()) {
@@ -374,29 +483,202 @@ BoardPlaneFragmentsBuilder::Result BoardPlaneFragmentsBuilder::run(
                 }
               });
 
-    // Calculate planes for each layer in a separate thread, except the last
-    // one to keep this thread busy too.
-    QList<QFuture<LayerJobResult>> futures;
-    for (int i = 0; i < data->layers.count(); ++i) {
-      const Layer* layer = data->layers.at(i);
-      if (i < data->layers.count() - 1) {
-        // Run in other thread -> Copy JobData for safe concurrent access.
-        futures.append(
-            QtConcurrent::run(&BoardPlaneFragmentsBuilder::runLayer, this,
-                              std::make_shared<const JobData>(*data), layer));
-      } else {
-        // Run in this thread -> no copy of JobData required.
-        const LayerJobResult res = runLayer(data, layer);
-        result.planes.insert(res.planes);
+    // Determine the dependencies between planes. A plane depends on all
+    // planes with higher priority on the same layer but with a different net,
+    // if their areas including clearance might overlap. Since the fragments
+    // of a plane never exceed its outline, comparing the bounding boxes of
+    // the outlines is sufficient. Each outline is expanded by its own
+    // clearance, which covers the maximum clearance of both planes.
+    auto expandRect = [](BoundingBoxIndex::Rect rect, const Length& offset) {
+      rect.minX -= offset.toNm();
+      rect.minY -= offset.toNm();
+      rect.maxX += offset.toNm();
+      rect.maxY += offset.toNm();
+      return rect;
+    };
+    QVector<BoundingBoxIndex::Rect> planeRects;
+    QHash<const Layer*, BoundingBoxIndex> planeIndices;
+    for (int i = 0; i < data->planes.count(); ++i) {
+      const PlaneData& plane = data->planes.at(i);
+      planeRects.append(BoundingBoxIndex::Rect::fromPaths(
+          {ClipperHelpers::convert(plane.outline.toClosedPath(),
+                                   maxArcTolerance())}));
+      planeIndices[plane.layer].insert(
+          i, expandRect(planeRects.last(), *plane.minClearanceToCopper));
+    }
+    data->dependencies.resize(data->planes.count());
+    for (auto it = planeIndices.begin(); it != planeIndices.end(); it++) {
+      for (const BoundingBoxIndex::Pair& pair : it->findOverlappingPairs()) {
+        if (data->planes.at(pair.first).netSignal !=
+            data->planes.at(pair.second).netSignal) {
+          // Lower index = higher priority.
+          data->dependencies[pair.second].append(pair.first);
+        }
+      }
+    }
+
+    // Determine the planes to rebuild. On layers which are invalidated only
+    // within some areas, planes not touching any of these areas (expanded by
+    // the largest clearance) keep their previous fragments. Planes depending
+    // on a rebuilt plane always need to be rebuilt too.
+    Length maxClearance(0);
+    foreach (const PlaneData& plane, data->planes) {
+      maxClearance = std::max(maxClearance, *plane.minClearanceToCopper);
+      maxClearance = std::max(maxClearance, *plane.thermalGap);
+    }
+    foreach (const PadData& pad, data->pads) {
+      maxClearance = std::max(maxClearance, *pad.clearance);
+    }
+    QVector<bool> rebuild(data->planes.count(), true);
+    QHash<int, std::shared_ptr<const PlaneJobResult>> finishedPlanes;
+    for (int i = 0; i < data->planes.count(); ++i) {
+      const PlaneData& plane = data->planes.at(i);
+      auto areasIt = data->dirtyAreas.constFind(plane.layer);
+      if (areasIt == data->dirtyAreas.constEnd()) {
+        continue;  // Layer completely invalidated.
+      }
+      bool affected = false;
+      const BoundingBoxIndex::Rect rect =
+          expandRect(planeRects.at(i), maxClearance);
+      for (const auto& area : *areasIt) {
+        const BoundingBoxIndex::Rect areaRect{
+            area.first.getX().toNm(), area.first.getY().toNm(),
+            area.second.getX().toNm(), area.second.getY().toNm()};
+        affected = affected || rect.overlaps(areaRect);
+      }
+      for (int dependency : data->dependencies.at(i)) {
+        affected = affected || rebuild.at(dependency);
+      }
+      rebuild[i] = affected;
+      if (!affected) {
+        // Pass the previous fragments to the dependent planes.
+        auto res = std::make_shared<PlaneJobResult>();
+        ClipperLib::Paths fragments = ClipperHelpers::convert(
+            plane.previousFragments, maxArcTolerance());
+        res->fragmentsDigest = digestPaths(fragments);
+        res->fragments =
+            std::make_shared<const ClipperLib::Paths>(std::move(fragments));
+        finishedPlanes.insert(i, res);
+      }
+    }
+
+    // Group the planes into levels. Each plane is calculated after all the
+    // planes it depends on. Planes of the same level do not depend on each
+    // other and are thus calculated in parallel, no matter on which layer.
+    QVector<int> planeLevels(data->planes.count(), 0);
+    QVector<QVector<int>> planesPerLevel;
+    int rebuildCount = 0;
+    for (int i = 0; i < data->planes.count(); ++i) {
+      if ((!data->layers.contains(data->planes.at(i).layer)) ||
+          (!rebuild.at(i))) {
+        continue;
+      }
+      ++rebuildCount;
+      for (int dependency : data->dependencies.at(i)) {
+        planeLevels[i] =
+            std::max(planeLevels.at(i), planeLevels.at(dependency) + 1);
+      }
+      if (planeLevels.at(i) >= planesPerLevel.count()) {
+        planesPerLevel.resize(planeLevels.at(i) + 1);
+      }
+      planesPerLevel[planeLevels.at(i)].append(i);
+    }
+    qDebug() << "Rebuilding" << rebuildCount << "plane(s) in"
+             << planesPerLevel.count() << "dependency level(s).";
+
+    // Reset the statistics of the obstacle cache.
+    {
+      QMutexLocker lock(&mObstacleCacheMutex);
+      foreach (const Layer* layer, data->layers) {
+        mObstacleCache[layer].usedKeys.clear();
+      }
+      mObstacleCacheHits = 0;
+      mObstacleCacheMisses = 0;
+    }
+
+    // Calculate the planes level by level. From now on, the job data is
+    // shared read-only between all threads.
+    const std::shared_ptr<const JobData> constData = data;
+    for (const QVector<int>& indices : planesPerLevel) {
+      if (mAbort) {
+        break;
+      }
+
+      // Calculate each plane in a separate thread, except the last one to
+      // keep this thread busy too.
+      QList<QFuture<PlaneJobResult>> futures;
+      for (int i = 0; i < indices.count() - 1; ++i) {
+        futures.append(QtConcurrent::run(&BoardPlaneFragmentsBuilder::runPlane,
+                                         this, constData, indices.at(i),
+                                         finishedPlanes));
+      }
+      QVector<PlaneJobResult> results(indices.count());
+      results.last() = runPlane(constData, indices.last(), finishedPlanes);
+
+      // Fetch result of each thread (blocking until all threads finished).
+      for (int i = 0; i < futures.count(); ++i) {
+        results[i] = futures.at(i).result();
+      }
+      for (int i = 0; i < indices.count(); ++i) {
+        const PlaneJobResult& res = results.at(i);
+        if (res.fragments) {
+          result.planes.insert(data->planes.at(indices.at(i)).uuid,
+                               ClipperHelpers::convert(*res.fragments));
+        }
         result.errors.append(res.errors);
+        finishedPlanes.insert(indices.at(i),
+                              std::make_shared<const PlaneJobResult>(res));
       }
     }
 
-    // Fetch result of each thread (blocking until all threads finished).
-    foreach (const auto& future, futures) {
-      const LayerJobResult res = future.result();
-      result.planes.insert(res.planes);
-      result.errors.append(res.errors);
+    // Remove cached obstacles which were not used anymore, i.e. the
+    // corresponding board items have been modified or removed. On partially
+    // rebuilt layers, unused entries outside the invalidated areas may still
+    // be needed by the planes not rebuilt, so only remove unused entries
+    // overlapping with a dirty area or with a rebuilt plane (which covers
+    // the previous fragments of that plane). Empty areas have no bounding
+    // box but are cheap to calculate, so they are always removed if unused.
+    if (!mAbort) {
+      QMutexLocker lock(&mObstacleCacheMutex);
+      foreach (const Layer* layer, data->layers) {
+        auto areasIt = data->dirtyAreas.constFind(layer);
+        const bool partial = (areasIt != data->dirtyAreas.constEnd());
+        QVector<BoundingBoxIndex::Rect> invalidatedRects;
+        if (partial) {
+          for (const auto& area : *areasIt) {
+            invalidatedRects.append(BoundingBoxIndex::Rect{
+                area.first.getX().toNm(), area.first.getY().toNm(),
+                area.second.getX().toNm(), area.second.getY().toNm()});
+          }
+          for (int i = 0; i < data->planes.count(); ++i) {
+            if ((data->planes.at(i).layer == layer) && rebuild.at(i)) {
+              invalidatedRects.append(planeRects.at(i));
+            }
+          }
+        }
+        auto isInvalidated = [&](const BoundingBoxIndex::Rect& rect) {
+          if ((!partial) || (!rect.isValid())) {
+            return true;
+          }
+          for (const BoundingBoxIndex::Rect& invalidatedRect :
+               invalidatedRects) {
+            if (rect.overlaps(invalidatedRect)) {
+              return true;
+            }
+          }
+          return false;
+        };
+        ObstacleCache& cache = mObstacleCache[layer];
+        for (auto it = cache.areas.begin(); it != cache.areas.end();) {
+          if (cache.usedKeys.contains(it.key()) || (!isInvalidated(it->rect))) {
+            it++;
+          } else {
+            it = cache.areas.erase(it);
+          }
+        }
+      }
+      qDebug() << "Plane obstacle cache:" << mObstacleCacheHits << "hits,"
+               << mObstacleCacheMisses << "misses.";
     }
   } catch (const Exception& e) {
     qCritical() << "Failed to calculate plane fragments:" << e.getMsg();
@@ -416,405 +698,477 @@ BoardPlaneFragmentsBuilder::Result BoardPlaneFragmentsBuilder::run(
   return result;
 }
 
-BoardPlaneFragmentsBuilder::LayerJobResult BoardPlaneFragmentsBuilder::runLayer(
-    std::shared_ptr<const JobData> data, const Layer* layer) noexcept {
-  LayerJobResult result;
-
-  // Build all planes.
-  for (auto it = data->planes.begin(); it != data->planes.end(); it++) {
-    if (it->layer != layer) continue;
-
-    try {
-      ClipperLib::Paths removedAreas;
-      ClipperLib::Paths connectedNetSignalAreas;
-
-      // Start with board outline shrunk by the given clearance and clipped
-      // to the plane outline.
-      // Except if the board clearance is zero, in this case we don't clip the
-      // plane to the board outlines.
-      const ClipperLib::Path planeOutline = ClipperHelpers::convert(
-          it->outline.toClosedPath(), maxArcTolerance());
-      ClipperLib::Paths fragments = *data->boardArea;
-      if (it->minClearanceToBoard) {
-        fragments = *data->boardArea;
-        if (*it->minClearanceToBoard != 0) {
-          ClipperHelpers::offset(fragments, -(*(it->minClearanceToBoard)),
-                                 maxArcTolerance());  // can throw
-        }
-        ClipperHelpers::intersect(fragments, {planeOutline},
-                                  ClipperLib::pftEvenOdd,
-                                  ClipperLib::pftEvenOdd);  // can throw
-      } else {
-        fragments = {planeOutline};
-      }
-      const ClipperLib::Paths fullPlaneArea = fragments;
-      if (mAbort) {
-        break;
-      }
+BoardPlaneFragmentsBuilder::PlaneJobResult BoardPlaneFragmentsBuilder::runPlane(
+    std::shared_ptr<const JobData> data, int index,
+    QHash<int, std::shared_ptr<const PlaneJobResult>> finishedPlanes) noexcept {
+  PlaneJobResult result;
+  const PlaneData& plane = data->planes.at(index);
 
-      // Collect other planes.
-      for (auto otherIt = data->planes.begin(); otherIt != it; otherIt++) {
-        if ((otherIt->layer == it->layer) &&
-            (otherIt->netSignal != it->netSignal)) {
-          const UnsignedLength clearance =
-              std::max(it->minClearanceToCopper, otherIt->minClearanceToCopper);
-          ClipperLib::Paths clipperPaths = ClipperHelpers::convert(
-              result.planes.value(otherIt->uuid), maxArcTolerance());
-          ClipperHelpers::offset(clipperPaths, *clearance,
-                                 maxArcTolerance());  // can throw
-          removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                              clipperPaths.end());
-        }
+  try {
+    ClipperLib::Paths removedAreas;
+    ClipperLib::Paths connectedNetSignalAreas;
+
+    // Start with board outline shrunk by the given clearance and clipped
+    // to the plane outline.
+    // Except if the board clearance is zero, in this case we don't clip the
+    // plane to the board outlines.
+    const ClipperLib::Path planeOutline = ClipperHelpers::convert(
+        plane.outline.toClosedPath(), maxArcTolerance());
+    ClipperLib::Paths fragments = *data->boardArea;
+    if (plane.minClearanceToBoard) {
+      fragments = *data->boardArea;
+      if (*plane.minClearanceToBoard != 0) {
+        ClipperHelpers::offset(fragments, -(*plane.minClearanceToBoard),
+                               maxArcTolerance());  // can throw
       }
-      if (mAbort) {
-        break;
+      ClipperHelpers::intersect(fragments, {planeOutline},
+                                ClipperLib::pftEvenOdd,
+                                ClipperLib::pftEvenOdd);  // can throw
+    } else {
+      fragments = {planeOutline};
+    }
+    const ClipperLib::Paths fullPlaneArea = fragments;
+    if (mAbort) {
+      return result;
+    }
+
+    // Collect other planes with higher priority. Other planes are not
+    // relevant since they cannot overlap with this plane.
+    for (int otherIndex : data->dependencies.at(index)) {
+      const PlaneData& other = data->planes.at(otherIndex);
+      const std::shared_ptr<const PlaneJobResult> otherResult =
+          finishedPlanes.value(otherIndex);
+      if ((!otherResult) || (!otherResult->fragments)) {
+        continue;  // Failed, thus the plane has no fragments.
       }
+      const UnsignedLength clearance =
+          std::max(plane.minClearanceToCopper, other.minClearanceToCopper);
+      const QByteArray key = makeObstacleKey(
+          ObstacleType::Plane, otherResult->fragmentsDigest, clearance);
+      const auto area = getObstacleArea(plane.layer, key, [&]() {
+        ClipperLib::Paths paths = *otherResult->fragments;
+        ClipperHelpers::offset(paths, *clearance,
+                               maxArcTolerance());  // can throw
+        return paths;
+      });
+      removedAreas.insert(removedAreas.end(), area->begin(), area->end());
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Collect keepout zones.
-      foreach (const KeepoutZoneData& zone, data->keepoutZones) {
-        if (zone.boardLayers.contains(it->layer)) {
-          const ClipperLib::Path clipperPath =
-              ClipperHelpers::convert(zone.outline, maxArcTolerance());
-          removedAreas.push_back(clipperPath);
-        }
+    // Collect keepout zones.
+    foreach (const KeepoutZoneData& zone, data->keepoutZones) {
+      if (zone.boardLayers.contains(plane.layer)) {
+        const ClipperLib::Path clipperPath =
+            ClipperHelpers::convert(zone.outline, maxArcTolerance());
+        removedAreas.push_back(clipperPath);
       }
+    }
 
-      // Collect holes, if clearance to holes is enabled
-      if (it->minClearanceToNpth) {
-        foreach (const auto& tuple, data->holes) {
-          const PositiveLength diameter(std::get<1>(tuple) +
-                                        *(it->minClearanceToNpth) * 2);
+    // Collect holes, if clearance to holes is enabled
+    if (plane.minClearanceToNpth) {
+      foreach (const auto& tuple, data->holes) {
+        const PositiveLength diameter(std::get<1>(tuple) +
+                                      *plane.minClearanceToNpth * 2);
+        const QByteArray key =
+            makeObstacleKey(ObstacleType::Hole, diameter, *std::get<2>(tuple));
+        const auto area = getObstacleArea(plane.layer, key, [&]() {
           const QVector<Path> paths =
               std::get<2>(tuple)->toOutlineStrokes(diameter);
-          const ClipperLib::Paths clipperPaths =
-              ClipperHelpers::convert(paths, maxArcTolerance());
-          removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                              clipperPaths.end());
-        }
-      }
-      if (mAbort) {
-        break;
+          return ClipperHelpers::convert(paths, maxArcTolerance());
+        });
+        removedAreas.insert(removedAreas.end(), area->begin(), area->end());
       }
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Collect vias.
-      foreach (const ViaData& via, data->vias) {
-        if ((via.startLayer->getCopperNumber() >
-             it->layer->getCopperNumber()) ||
-            (via.endLayer->getCopperNumber() < it->layer->getCopperNumber())) {
-          continue;
-        }
-        if (it->netSignal && (via.netSignal == it->netSignal)) {
-          // Via has same net as plane -> no cut-out.
-          // Note: Do not respect the plane connect style for vias, but always
-          // connect them with solid style. Since vias are not soldered, heat
-          // dissipation is not an issue or often even desired. See discussion
-          // https://github.com/LibrePCB/LibrePCB/issues/454#issuecomment-1373402172
+    // Collect vias.
+    foreach (const ViaData& via, data->vias) {
+      if ((via.startLayer->getCopperNumber() >
+           plane.layer->getCopperNumber()) ||
+          (via.endLayer->getCopperNumber() < plane.layer->getCopperNumber())) {
+        continue;
+      }
+      if (plane.netSignal && (via.netSignal == plane.netSignal)) {
+        // Via has same net as plane -> no cut-out.
+        // Note: Do not respect the plane connect style for vias, but always
+        // connect them with solid style. Since vias are not soldered, heat
+        // dissipation is not an issue or often even desired. See discussion
+        // https://github.com/LibrePCB/LibrePCB/issues/454#issuecomment-1373402172
+        const QByteArray key = makeObstacleKey(ObstacleType::ViaCopper,
+                                               via.position, via.diameter);
+        const auto area = getObstacleArea(plane.layer, key, [&]() {
           const Path path = Path::circle(via.diameter).translated(via.position);
-          connectedNetSignalAreas.push_back(
-              ClipperHelpers::convert(path, maxArcTolerance()));
-        } else {
-          // Vias has different net than plane -> subtract with clearance.
-          const Path path =
-              Path::circle(
-                  PositiveLength(via.diameter + it->minClearanceToCopper * 2))
-                  .translated(via.position);
-          const ClipperLib::Path clipperPath =
-              ClipperHelpers::convert(path, maxArcTolerance());
-          removedAreas.push_back(clipperPath);
-        }
+          return ClipperLib::Paths{
+              ClipperHelpers::convert(path, maxArcTolerance())};
+        });
+        connectedNetSignalAreas.insert(connectedNetSignalAreas.end(),
+                                       area->begin(), area->end());
+      } else {
+        // Vias has different net than plane -> subtract with clearance.
+        const PositiveLength diameter(via.diameter +
+                                      plane.minClearanceToCopper * 2);
+        const QByteArray key = makeObstacleKey(ObstacleType::ViaClearance,
+                                               via.position, diameter);
+        const auto area = getObstacleArea(plane.layer, key, [&]() {
+          const Path path = Path::circle(diameter).translated(via.position);
+          return ClipperLib::Paths{
+              ClipperHelpers::convert(path, maxArcTolerance())};
+        });
+        removedAreas.insert(removedAreas.end(), area->begin(), area->end());
       }
-      if (mAbort) {
-        break;
+    }
+    if (mAbort) {
+      return result;
+    }
+
+    // Collect traces & other strokes.
+    foreach (const PolygonData& polygon, data->polygons) {
+      if (polygon.layer != plane.layer) {
+        continue;
+      }
+      if (plane.netSignal && (polygon.netSignal == plane.netSignal)) {
+        // Same net signal -> memorize as connected area.
+        const QByteArray key =
+            makeObstacleKey(ObstacleType::PolygonCopper, polygon.path,
+                            polygon.width, qint64(polygon.filled));
+        const auto area = getObstacleArea(plane.layer, key, [&]() {
+          ClipperLib::Paths paths;
+          if (polygon.filled) {
+            // Area.
+            paths.push_back(
+                ClipperHelpers::convert(polygon.path, maxArcTolerance()));
+          }
+          if ((!polygon.filled) || (polygon.width > 0)) {
+            // Outline strokes.
+            const ClipperLib::Paths clipperPaths = ClipperHelpers::convert(
+                polygon.path.toOutlineStrokes(
+                    PositiveLength(std::max(*polygon.width, Length(1)))),
+                maxArcTolerance());
+            paths.insert(paths.end(), clipperPaths.begin(),
+                         clipperPaths.end());
+          }
+          return paths;
+        });
+        connectedNetSignalAreas.insert(connectedNetSignalAreas.end(),
+                                       area->begin(), area->end());
+      } else {
+        // Different net signal -> subtract with clearance.
+        const QByteArray key = makeObstacleKey(
+            ObstacleType::PolygonClearance, polygon.path, polygon.width,
+            qint64(polygon.filled), plane.minClearanceToCopper);
+        const auto area = getObstacleArea(plane.layer, key, [&]() {
+          ClipperLib::Paths paths;
+          if (polygon.filled) {
+            // Area.
+            paths.push_back(
+                ClipperHelpers::convert(polygon.path, maxArcTolerance()));
+            ClipperHelpers::offset(paths, *plane.minClearanceToCopper,
+                                   maxArcTolerance());  // can throw
+          }
+          if ((!polygon.filled) || (polygon.width > 0)) {
+            // Outline strokes.
+            const ClipperLib::Paths clipperPaths = ClipperHelpers::convert(
+                polygon.path.toOutlineStrokes(PositiveLength(
+                    std::max(*polygon.width + plane.minClearanceToCopper * 2,
+                             Length(1)))),
+                maxArcTolerance());
+            paths.insert(paths.end(), clipperPaths.begin(),
+                         clipperPaths.end());
+          }
+          return paths;
+        });
+        removedAreas.insert(removedAreas.end(), area->begin(), area->end());
       }
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Collect traces & other strokes.
-      foreach (const PolygonData& polygon, data->polygons) {
-        if (polygon.layer == it->layer) {
-          if (it->netSignal && (polygon.netSignal == it->netSignal)) {
-            // Same net signal -> memorize as connected area.
-            if (polygon.filled) {
-              // Area.
-              const ClipperLib::Path clipperPath =
-                  ClipperHelpers::convert(polygon.path, maxArcTolerance());
-              connectedNetSignalAreas.push_back(clipperPath);
-            }
-            if ((!polygon.filled) || (polygon.width > 0)) {
-              // Outline strokes.
-              const QVector<Path> paths = polygon.path.toOutlineStrokes(
-                  PositiveLength(std::max(*polygon.width, Length(1))));
-              const ClipperLib::Paths clipperPaths =
-                  ClipperHelpers::convert(paths, maxArcTolerance());
-              connectedNetSignalAreas.insert(connectedNetSignalAreas.end(),
-                                             clipperPaths.begin(),
-                                             clipperPaths.end());
+    // Collect pads.
+    ClipperLib::Paths thermalPadAreas;
+    ClipperLib::Paths thermalPadAreasShrunk;
+    ClipperLib::Paths thermalPadClearanceAreas;
+    foreach (const PadData& pad, data->pads) {
+      const bool sameNet =
+          plane.netSignal && (pad.netSignal == plane.netSignal);
+      foreach (const PadGeometry& geometry, pad.geometries.value(plane.layer)) {
+        QByteArray padKey;
+        addToKey(padKey, pad.transform);
+        addToKey(padKey, geometry);
+        if (sameNet) {
+          // Same net signal -> memorize as connected area.
+          const QByteArray key =
+              makeObstacleKey(ObstacleType::PadCopper, padKey);
+          const auto area = getObstacleArea(plane.layer, key, [&]() {
+            return ClipperHelpers::convert(
+                pad.transform.map(geometry.toOutlines()), maxArcTolerance());
+          });
+          connectedNetSignalAreas.insert(connectedNetSignalAreas.end(),
+                                         area->begin(), area->end());
+        }
+        if ((!sameNet) ||
+            (plane.connectStyle != BI_Plane::ConnectStyle::Solid)) {
+          // Determine required clearance. For connection style 'none' for
+          // pads of the same net, use the thermal gap clearance since usually
+          // it is smaller than the planes clearance, so it leads to a higher
+          // plane area.
+          const Length clearance = std::max(
+              sameNet ? *plane.thermalGap : *plane.minClearanceToCopper,
+              *pad.clearance);
+          const QByteArray key =
+              makeObstacleKey(ObstacleType::PadClearance, padKey, clearance);
+          ClipperLib::Paths clipperPaths =
+              *getObstacleArea(plane.layer, key, [&]() {
+                return ClipperHelpers::convert(
+                    pad.transform.map(
+                        geometry.withOffset(clearance).toOutlines()),
+                    maxArcTolerance());
+              });
+
+          // For thermal relief connection, subtract the spokes from the
+          // cutout.
+          if (sameNet &&
+              (plane.connectStyle == BI_Plane::ConnectStyle::ThermalRelief) &&
+              ClipperHelpers::anyPointsInside(clipperPaths, planeOutline)) {
+            // Note: Make spokes *slightly* thicker to avoid them to be
+            // removed due to numerical inaccuary of minimum width procedure.
+            // Note 2: Do not accept a spoke width smaller than the minimum
+            // copper width because this will effectively break all thermal
+            // pads, see https://github.com/LibrePCB/LibrePCB/issues/1682.
+            const PositiveLength spokeWidth(
+                std::max(*plane.thermalSpokeWidth, *plane.minWidth) + 10);
+            const Length spokeLength(100000000);  // Maximum spoke length.
+            foreach (const auto& spokeConfig,
+                     determineThermalSpokes(geometry)) {
+              const Point p1 =
+                  spokeConfig.first.rotated(pad.transform.getRotation()) +
+                  pad.transform.getPosition();
+              const Point p2 =
+                  (Point(spokeLength, 0).rotated(spokeConfig.second) +
+                   spokeConfig.first)
+                      .rotated(pad.transform.getRotation()) +
+                  pad.transform.getPosition();
+              const ClipperLib::Paths spokePaths{ClipperHelpers::convert(
+                  Path::obround(p1, p2, spokeWidth), maxArcTolerance())};
+              ClipperHelpers::subtract(clipperPaths, spokePaths,
+                                       ClipperLib::pftEvenOdd,
+                                       ClipperLib::pftNonZero);  // can throw
             }
-          } else {
-            // Different net signal -> subtract with clearance.
-            if (polygon.filled) {
-              // Area.
-              ClipperLib::Paths clipperPaths{
-                  ClipperHelpers::convert(polygon.path, maxArcTolerance())};
-              ClipperHelpers::offset(clipperPaths, *it->minClearanceToCopper,
-                                     maxArcTolerance());  // can throw
-              removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                                  clipperPaths.end());
+            // Memorize copper area for later removal of unconnected
+            // thermal spokes,
+            ClipperLib::Paths tmp = ClipperHelpers::convert(
+                pad.transform.map(geometry.toOutlines()), maxArcTolerance());
+            if (tmp.size() > 1) {
+              ClipperHelpers::unite(tmp,
+                                    ClipperLib::pftNonZero);  // can throw
             }
-            if ((!polygon.filled) || (polygon.width > 0)) {
-              // Outline strokes.
-              const QVector<Path> paths =
-                  polygon.path.toOutlineStrokes(PositiveLength(
-                      std::max(*polygon.width + it->minClearanceToCopper * 2,
-                               Length(1))));
-              const ClipperLib::Paths clipperPaths =
-                  ClipperHelpers::convert(paths, maxArcTolerance());
-              removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                                  clipperPaths.end());
+            thermalPadAreas.insert(thermalPadAreas.end(), tmp.begin(),
+                                   tmp.end());
+            // Memorize clearance area for later removal of unconnected
+            // thermal spokes,
+            Length offset = clearance + plane.minWidth - maxArcTolerance() - 10;
+            tmp = ClipperHelpers::convert(
+                pad.transform.map(geometry.withOffset(offset).toOutlines()),
+                maxArcTolerance());
+            if (tmp.size() > 1) {
+              ClipperHelpers::unite(tmp,
+                                    ClipperLib::pftNonZero);  // can throw
             }
+            thermalPadClearanceAreas.insert(thermalPadClearanceAreas.end(),
+                                            tmp.begin(), tmp.end());
+            // Memorize slightly shrunk copper area for later removal of
+            // unconnected thermal spokes,
+            offset = -maxArcTolerance() - 10;
+            tmp = ClipperHelpers::convert(
+                pad.transform.map(geometry.withOffset(offset).toOutlines()),
+                maxArcTolerance());
+            thermalPadAreasShrunk.insert(thermalPadAreasShrunk.end(),
+                                         tmp.begin(), tmp.end());
           }
-        }
-      }
-      if (mAbort) {
-        break;
-      }
-
-      // Collect pads.
-      ClipperLib::Paths thermalPadAreas;
-      ClipperLib::Paths thermalPadAreasShrunk;
-      ClipperLib::Paths thermalPadClearanceAreas;
-      foreach (const PadData& pad, data->pads) {
-        const bool sameNet = it->netSignal && (pad.netSignal == it->netSignal);
-        foreach (const PadGeometry& geometry, pad.geometries.value(it->layer)) {
-          if (sameNet) {
-            // Same net signal -> memorize as connected area.
-            const QVector<Path> paths =
-                pad.transform.map(geometry.toOutlines());
-            const ClipperLib::Paths clipperPaths =
-                ClipperHelpers::convert(paths, maxArcTolerance());
-            connectedNetSignalAreas.insert(connectedNetSignalAreas.end(),
-                                           clipperPaths.begin(),
-                                           clipperPaths.end());
-          }
-          if ((!sameNet) ||
-              (it->connectStyle != BI_Plane::ConnectStyle::Solid)) {
-            // Determine required clearance. For connection style 'none' for
-            // pads of the same net, use the thermal gap clearance since usually
-            // it is smaller than the planes clearance, so it leads to a higher
-            // plane area.
-            const Length clearance =
-                std::max(sameNet ? *it->thermalGap : *it->minClearanceToCopper,
-                         *pad.clearance);
-            QVector<Path> paths =
-                pad.transform.map(geometry.withOffset(clearance).toOutlines());
-            ClipperLib::Paths clipperPaths =
-                ClipperHelpers::convert(paths, maxArcTolerance());
-
-            // For thermal relief connection, subtract the spokes from the
-            // cutout.
-            if (sameNet &&
-                (it->connectStyle == BI_Plane::ConnectStyle::ThermalRelief) &&
-                ClipperHelpers::anyPointsInside(clipperPaths, planeOutline)) {
-              // Note: Make spokes *slightly* thicker to avoid them to be
-              // removed due to numerical inaccuary of minimum width procedure.
-              // Note 2: Do not accept a spoke width smaller than the minimum
-              // copper width because this will effectively break all thermal
-              // pads, see https://github.com/LibrePCB/LibrePCB/issues/1682.
-              const PositiveLength spokeWidth(
-                  std::max(*it->thermalSpokeWidth, *it->minWidth) + 10);
-              const Length spokeLength(100000000);  // Maximum spoke length.
-              foreach (const auto& spokeConfig,
-                       determineThermalSpokes(geometry)) {
-                const Point p1 =
-                    spokeConfig.first.rotated(pad.transform.getRotation()) +
-                    pad.transform.getPosition();
-                const Point p2 =
-                    (Point(spokeLength, 0).rotated(spokeConfig.second) +
-                     spokeConfig.first)
-                        .rotated(pad.transform.getRotation()) +
-                    pad.transform.getPosition();
-                const ClipperLib::Paths spokePaths{ClipperHelpers::convert(
-                    Path::obround(p1, p2, spokeWidth), maxArcTolerance())};
-                ClipperHelpers::subtract(clipperPaths, spokePaths,
-                                         ClipperLib::pftEvenOdd,
-                                         ClipperLib::pftNonZero);  // can throw
-              }
-              // Memorize copper area for later removal of unconnected
-              // thermal spokes,
-              ClipperLib::Paths tmp = ClipperHelpers::convert(
-                  pad.transform.map(geometry.toOutlines()), maxArcTolerance());
-              if (tmp.size() > 1) {
-                ClipperHelpers::unite(tmp,
-                                      ClipperLib::pftNonZero);  // can throw
-              }
-              thermalPadAreas.insert(thermalPadAreas.end(), tmp.begin(),
-                                     tmp.end());
-              // Memorize clearance area for later removal of unconnected
-              // thermal spokes,
-              Length offset = clearance + it->minWidth - maxArcTolerance() - 10;
-              tmp = ClipperHelpers::convert(
-                  pad.transform.map(geometry.withOffset(offset).toOutlines()),
-                  maxArcTolerance());
-              if (tmp.size() > 1) {
-                ClipperHelpers::unite(tmp,
-                                      ClipperLib::pftNonZero);  // can throw
-              }
-              thermalPadClearanceAreas.insert(thermalPadClearanceAreas.end(),
-                                              tmp.begin(), tmp.end());
-              // Memorize slightly shrunk copper area for later removal of
-              // unconnected thermal spokes,
-              offset = -maxArcTolerance() - 10;
-              tmp = ClipperHelpers::convert(
-                  pad.transform.map(geometry.withOffset(offset).toOutlines()),
-                  maxArcTolerance());
-              thermalPadAreasShrunk.insert(thermalPadAreasShrunk.end(),
-                                           tmp.begin(), tmp.end());
-            }
-            removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                                clipperPaths.end());
+          removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
+                              clipperPaths.end());
 
-            // Also create cut-outs for each hole to ensure correct clearance
-            // even if the pad outline is too small or invalid.
-            if (!sameNet) {
+          // Also create cut-outs for each hole to ensure correct clearance
+          // even if the pad outline is too small or invalid.
+          if (!sameNet) {
+            const QByteArray key =
+                makeObstacleKey(ObstacleType::PadHoles, padKey, clearance);
+            const auto area = getObstacleArea(plane.layer, key, [&]() {
+              ClipperLib::Paths paths;
               for (const PadHole& hole : geometry.getHoles()) {
                 const PositiveLength width(hole.getDiameter() +
                                            (clearance * 2));
-                paths =
-                    pad.transform.map(hole.getPath()->toOutlineStrokes(width));
-                clipperPaths =
-                    ClipperHelpers::convert(paths, maxArcTolerance());
-                removedAreas.insert(removedAreas.end(), clipperPaths.begin(),
-                                    clipperPaths.end());
+                const ClipperLib::Paths holePaths = ClipperHelpers::convert(
+                    pad.transform.map(hole.getPath()->toOutlineStrokes(width)),
+                    maxArcTolerance());
+                paths.insert(paths.end(), holePaths.begin(), holePaths.end());
               }
-            }
+              return paths;
+            });
+            removedAreas.insert(removedAreas.end(), area->begin(),
+                                area->end());
           }
         }
-        if (mAbort) {
-          break;
-        }
       }
       if (mAbort) {
-        break;
+        return result;
       }
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Subtract all the collected areas to remove.
-      ClipperHelpers::subtract(fragments, removedAreas, ClipperLib::pftEvenOdd,
-                               ClipperLib::pftNonZero);
-      if (mAbort) {
-        break;
-      }
+    // Subtract all the collected areas to remove.
+    ClipperHelpers::subtract(fragments, removedAreas, ClipperLib::pftEvenOdd,
+                             ClipperLib::pftNonZero);
+    if (mAbort) {
+      return result;
+    }
 
-      // Ensure minimum width. Reduce minWidth by 1nm to ensure plane areas
-      // do not disappear between two objects with a distance of *exactly*
-      // 2*minClearance+minWidth (e.g. two 0.5mm traces on a 1.0mm grid).
-      const Length minWidthOffset = (it->minWidth / 2) - 1;
-      if (minWidthOffset > 0) {
-        ClipperHelpers::offset(fragments, -minWidthOffset,
-                               maxArcTolerance());  // can throw
-        ClipperHelpers::offset(fragments, minWidthOffset,
-                               maxArcTolerance());  // can throw
-      }
-      if (mAbort) {
-        break;
-      }
+    // Ensure minimum width. Reduce minWidth by 1nm to ensure plane areas
+    // do not disappear between two objects with a distance of *exactly*
+    // 2*minClearance+minWidth (e.g. two 0.5mm traces on a 1.0mm grid).
+    const Length minWidthOffset = (plane.minWidth / 2) - 1;
+    if (minWidthOffset > 0) {
+      ClipperHelpers::offset(fragments, -minWidthOffset,
+                             maxArcTolerance());  // can throw
+      ClipperHelpers::offset(fragments, minWidthOffset,
+                             maxArcTolerance());  // can throw
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Split thermal spokes and flatten result for detecting unconnected
-      // thermal spokes.
-      std::unique_ptr<ClipperLib::PolyTree> tree =
-          ClipperHelpers::subtractToTree(fragments, thermalPadAreasShrunk,
-                                         ClipperLib::pftEvenOdd,
-                                         ClipperLib::pftNonZero);  // can throw
-      fragments = ClipperHelpers::flattenTree(*tree);  // can throw
-      if (mAbort) {
-        break;
-      }
+    // Split thermal spokes and flatten result for detecting unconnected
+    // thermal spokes.
+    std::unique_ptr<ClipperLib::PolyTree> tree =
+        ClipperHelpers::subtractToTree(fragments, thermalPadAreasShrunk,
+                                       ClipperLib::pftEvenOdd,
+                                       ClipperLib::pftNonZero);  // can throw
+    fragments = ClipperHelpers::flattenTree(*tree);  // can throw
+    if (mAbort) {
+      return result;
+    }
 
-      // Remove unconnected thermal spokes.
-      if (thermalPadAreas.size() != thermalPadClearanceAreas.size()) {
-        throw LogicError(
-            __FILE__, __LINE__,
-            "Thermal pads inconsistency, please open a bug report.");
-      }
-      auto isUnconnectedSpoke = [&](const ClipperLib::Path& fragment) {
-        std::optional<std::size_t> padIndex;
-        for (std::size_t i = 0; i < thermalPadAreas.size(); ++i) {
-          if (ClipperHelpers::anyPointsInside(fragment,
-                                              thermalPadAreas.at(i))) {
-            if (padIndex) {
-              return false;
-            } else {
-              padIndex = i;
-            }
+    // Remove unconnected thermal spokes.
+    if (thermalPadAreas.size() != thermalPadClearanceAreas.size()) {
+      throw LogicError(
+          __FILE__, __LINE__,
+          "Thermal pads inconsistency, please open a bug report.");
+    }
+    auto isUnconnectedSpoke = [&](const ClipperLib::Path& fragment) {
+      std::optional<std::size_t> padIndex;
+      for (std::size_t i = 0; i < thermalPadAreas.size(); ++i) {
+        if (ClipperHelpers::anyPointsInside(fragment,
+                                            thermalPadAreas.at(i))) {
+          if (padIndex) {
+            return false;
+          } else {
+            padIndex = i;
           }
         }
-        return padIndex &&
-            ClipperHelpers::allPointsInside(
-                   fragment, thermalPadClearanceAreas.at(*padIndex));
-      };
-      fragments.erase(std::remove_if(fragments.begin(), fragments.end(),
-                                     isUnconnectedSpoke),
-                      fragments.end());
-      if (mAbort) {
-        break;
-      }
-
-      // Fill thermal pads.
-      ClipperHelpers::intersect(thermalPadAreas, fullPlaneArea,
-                                ClipperLib::pftNonZero,
-                                ClipperLib::pftEvenOdd);  // can throw
-      tree = ClipperHelpers::uniteToTree(fragments, thermalPadAreas,
-                                         ClipperLib::pftEvenOdd,
-                                         ClipperLib::pftNonZero);  // can throw
-      fragments = ClipperHelpers::flattenTree(*tree);  // can throw
-      if (mAbort) {
-        break;
       }
+      return padIndex &&
+          ClipperHelpers::allPointsInside(
+                 fragment, thermalPadClearanceAreas.at(*padIndex));
+    };
+    fragments.erase(std::remove_if(fragments.begin(), fragments.end(),
+                                   isUnconnectedSpoke),
+                    fragments.end());
+    if (mAbort) {
+      return result;
+    }
 
-      // If requested, remove unconnected fragments (islands).
-      if (it->netSignal && (!it->keepIslands)) {
-        auto isIsland = [&](const ClipperLib::Path& p) {
-          ClipperLib::Paths intersections{p};
-          ClipperHelpers::intersect(intersections, connectedNetSignalAreas,
-                                    ClipperLib::pftNonZero,
-                                    ClipperLib::pftNonZero);  // can throw
-          return intersections.empty();
-        };
-        fragments.erase(
-            std::remove_if(fragments.begin(), fragments.end(), isIsland),
-            fragments.end());
-      }
-      if (mAbort) {
-        break;
-      }
+    // Fill thermal pads.
+    ClipperHelpers::intersect(thermalPadAreas, fullPlaneArea,
+                              ClipperLib::pftNonZero,
+                              ClipperLib::pftEvenOdd);  // can throw
+    tree = ClipperHelpers::uniteToTree(fragments, thermalPadAreas,
+                                       ClipperLib::pftEvenOdd,
+                                       ClipperLib::pftNonZero);  // can throw
+    fragments = ClipperHelpers::flattenTree(*tree);  // can throw
+    if (mAbort) {
+      return result;
+    }
 
-      // Make result canonical for a reproducible output by rotating and
-      // sorting the fragments.
-      auto cmp = [](const ClipperLib::IntPoint& a,
-                    const ClipperLib::IntPoint& b) {
-        return (a.X < b.X) || ((a.X == b.X) && (a.Y < b.Y));
+    // If requested, remove unconnected fragments (islands).
+    if (plane.netSignal && (!plane.keepIslands)) {
+      auto isIsland = [&](const ClipperLib::Path& p) {
+        ClipperLib::Paths intersections{p};
+        ClipperHelpers::intersect(intersections, connectedNetSignalAreas,
+                                  ClipperLib::pftNonZero,
+                                  ClipperLib::pftNonZero);  // can throw
+        return intersections.empty();
       };
-      for (ClipperLib::Path& path : fragments) {
-        Q_ASSERT(!path.empty());
-        auto minIt = std::min_element(path.begin(), path.end(), cmp);
-        std::rotate(path.begin(), minIt, path.end());
-      }
-      std::sort(fragments.begin(), fragments.end(),
-                [&cmp](const ClipperLib::Path& a, const ClipperLib::Path& b) {
-                  return cmp(a.front(), b.front());
-                });
-      if (mAbort) {
-        break;
-      }
+      fragments.erase(
+          std::remove_if(fragments.begin(), fragments.end(), isIsland),
+          fragments.end());
+    }
+    if (mAbort) {
+      return result;
+    }
 
-      // Memorize fragments for this plane.
-      result.planes[it->uuid] = ClipperHelpers::convert(fragments);
-    } catch (const Exception& e) {
-      qCritical() << "Failed to calculate plane areas, leaving empty:"
-                  << e.getMsg();
-      result.errors.append(e.getMsg());
+    // Make result canonical for a reproducible output by rotating and
+    // sorting the fragments.
+    auto cmp = [](const ClipperLib::IntPoint& a,
+                  const ClipperLib::IntPoint& b) {
+      return (a.X < b.X) || ((a.X == b.X) && (a.Y < b.Y));
+    };
+    for (ClipperLib::Path& path : fragments) {
+      Q_ASSERT(!path.empty());
+      auto minIt = std::min_element(path.begin(), path.end(), cmp);
+      std::rotate(path.begin(), minIt, path.end());
+    }
+    std::sort(fragments.begin(), fragments.end(),
+              [&cmp](const ClipperLib::Path& a, const ClipperLib::Path& b) {
+                return cmp(a.front(), b.front());
+              });
+    if (mAbort) {
+      return result;
     }
+
+    // Memorize fragments for this plane.
+    result.fragmentsDigest = digestPaths(fragments);
+    result.fragments =
+        std::make_shared<const ClipperLib::Paths>(std::move(fragments));
+  } catch (const Exception& e) {
+    qCritical() << "Failed to calculate plane areas, leaving empty:"
+                << e.getMsg();
+    result.errors.append(e.getMsg());
   }
   return result;
 }
 
+std::shared_ptr<const ClipperLib::Paths>
+    BoardPlaneFragmentsBuilder::getObstacleArea(
+        const Layer* layer, const QByteArray& key,
+        const std::function<ClipperLib::Paths()>& calculator) {
+  {
+    QMutexLocker lock(&mObstacleCacheMutex);
+    ObstacleCache& cache = mObstacleCache[layer];
+    cache.usedKeys.insert(key);
+    auto it = cache.areas.constFind(key);
+    if (it != cache.areas.constEnd()) {
+      ++mObstacleCacheHits;
+      return it->area;
+    }
+    ++mObstacleCacheMisses;
+  }
+
+  // Calculate the area without holding the lock. If another thread calculates
+  // the same area concurrently, both get the same result anyway.
+  auto area = std::make_shared<const ClipperLib::Paths>(calculator());
+  const ObstacleCache::Entry entry{area,
+                                   BoundingBoxIndex::Rect::fromPaths(*area)};
+  QMutexLocker lock(&mObstacleCacheMutex);
+  mObstacleCache[layer].areas.insert(key, entry);
+  return area;
+}
+
 QVector<std::pair<Point, Angle>>
     BoardPlaneFragmentsBuilder::determineThermalSpokes(
         const PadGeometry& geometry) noexcept {
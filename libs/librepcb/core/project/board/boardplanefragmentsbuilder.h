@@ -23,6 +23,7 @@
 /*******************************************************************************
  *  Includes
  ******************************************************************************/
+#include "../../algorithm/boundingboxindex.h"
 #include "../../geometry/path.h"
 #include "../../geometry/zone.h"
 #include "../../types/uuid.h"
@@ -33,6 +34,7 @@
 
 #include <QtCore>
 
+#include <functional>
 #include <memory>
 
 /*******************************************************************************
@@ -157,6 +159,7 @@ private:  // Methods
     BI_Plane::ConnectStyle connectStyle;
     PositiveLength thermalGap;
     PositiveLength thermalSpokeWidth;
+    QVector<Path> previousFragments;  // Kept if not affected by the rebuild.
   };
 
   struct KeepoutZoneData {
@@ -199,14 +202,14 @@ private:  // Methods
   };
 
   struct JobData {
-    // NOTE: We create a `const` copy of this structure for each thread to
-    // ensure thread-safety. For the implicitly shared Qt containers this is
-    // a lightweight operation, but for ClipperLib::Paths we share it with a
-    // shared_ptr to avoid deep copying the whole container. This is safe
-    // because the underlying std::vector is thread-safe for read-only
-    // operations.
+    // NOTE: After preprocessing, this structure is shared read-only
+    // (`const`) between all threads. This is thread-safe as long as only
+    // const methods are used, thus it must not be modified anymore then.
 
     QList<const Layer*> layers;
+    // Layers which are only invalidated within some areas. Not contained
+    // layers are completely invalidated.
+    QHash<const Layer*, QVector<std::pair<Point, Point>>> dirtyAreas;
     QList<PlaneData> planes;
     QList<KeepoutZoneData> keepoutZones;
     QList<PolygonData> polygons;
@@ -215,18 +218,43 @@ private:  // Methods
     QList<std::tuple<Transform, PositiveLength, NonEmptyPath>> holes;
     QList<TraceData> traces;  // Converted to polygons after preprocessing.
     std::shared_ptr<ClipperLib::Paths> boardArea;  // Populated in preprocessing
+    QVector<QVector<int>> dependencies;  // Populated in preprocessing
   };
 
-  struct LayerJobResult {
-    QHash<Uuid, QVector<Path>> planes;
+  struct PlaneJobResult {
+    // Calculated fragments, or nullptr on failure or abort. Kept in Clipper
+    // format for the dependent planes to avoid converting them back.
+    std::shared_ptr<const ClipperLib::Paths> fragments;
+    QByteArray fragmentsDigest;  // Used as cache key by dependent planes.
     QStringList errors;  // Empty on success.
   };
 
+  /**
+   * Cached areas of obstacles on a particular layer, shared between all planes
+   * of that layer and between successive rebuilds. The keys contain all the
+   * data an area is calculated from, so modifying a board item just leads to
+   * a new key instead of a stale entry. Entries not used anymore are
+   * removed after each successful rebuild of the layer (for partial
+   * rebuilds, only those within the invalidated areas).
+   */
+  struct ObstacleCache {
+    struct Entry {
+      std::shared_ptr<const ClipperLib::Paths> area;
+      BoundingBoxIndex::Rect rect;  // Used to invalidate partially.
+    };
+    QHash<QByteArray, Entry> areas;
+    QSet<QByteArray> usedKeys;  // Keys accessed during the current run.
+  };
+
   std::shared_ptr<JobData> createJob(Board& board,
                                      const QSet<const Layer*>* filter) noexcept;
   Result run(QPointer<Board> board, std::shared_ptr<JobData> data) noexcept;
-  LayerJobResult runLayer(std::shared_ptr<const JobData> data,
-                          const Layer* layer) noexcept;
+  PlaneJobResult runPlane(std::shared_ptr<const JobData> data, int index,
+                          QHash<int, std::shared_ptr<const PlaneJobResult>>
+                              finishedPlanes) noexcept;
+  std::shared_ptr<const ClipperLib::Paths> getObstacleArea(
+      const Layer* layer, const QByteArray& key,
+      const std::function<ClipperLib::Paths()>& calculator);
   static QVector<std::pair<Point, Angle>> determineThermalSpokes(
       const PadGeometry& geometry) noexcept;
 
@@ -242,6 +270,12 @@ private:  // Methods
 private:  // Data
   QFuture<Result> mFuture;
   bool mAbort;
+
+  // Obstacle cache, accessed concurrently by the plane jobs.
+  QMutex mObstacleCacheMutex;
+  QHash<const Layer*, ObstacleCache> mObstacleCache;
+  int mObstacleCacheHits;
+  int mObstacleCacheMisses;
 };
 
 /*******************************************************************************
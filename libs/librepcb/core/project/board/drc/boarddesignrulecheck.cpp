@@ -22,6 +22,7 @@
  ******************************************************************************/
 #include "boarddesignrulecheck.h"
 
+#include "../../../algorithm/boundingboxindex.h"
 #include "../../../geometry/padgeometry.h"
 #include "../../../geometry/via.h"
 #include "../../../types/layer.h"
@@ -40,6 +41,100 @@
  ******************************************************************************/
 namespace librepcb {
 
+/*******************************************************************************
+ *  Non-Member Functions
+ ******************************************************************************/
+
+/**
+ * @brief Order-independent hash key for a pair of objects
+ *
+ * Used to merge violations of the same object pair in O(1), no matter in
+ * which order the two objects were reported.
+ */
+template <typename T>
+struct UnorderedPair {
+  T first;
+  T second;
+
+  bool operator==(const UnorderedPair& rhs) const noexcept {
+    return ((first == rhs.first) && (second == rhs.second)) ||
+        ((first == rhs.second) && (second == rhs.first));
+  }
+};
+
+template <typename T>
+static std::size_t qHash(const UnorderedPair<T>& key,
+                         std::size_t seed = 0) noexcept {
+  return qHashMultiCommutative(seed, key.first, key.second);
+}
+
+/*******************************************************************************
+ *  Struct BoardDesignRuleCheck::CopperClearanceJobData
+ ******************************************************************************/
+
+/**
+ * Data of the copper clearance check, prepared by a stage 1 job and then
+ * processed by several stage 2 jobs in parallel (one per layer and tile).
+ *
+ * After a run, it is kept to reuse the results of unchanged objects in the
+ * next run. Note that #Item::object must not be accessed anymore then since
+ * the referenced board data does not exist anymore.
+ */
+struct BoardDesignRuleCheck::CopperClearanceJobData {
+  struct Item {
+    DrcMsgCopperCopperClearanceViolation::Object object;
+    const Layer* startLayer;
+    const Layer* endLayer;
+    std::optional<Uuid> net;  // nullopt = no net
+    Length clearance;  // Either from object, net class or DRC settings.
+    ClipperLib::Paths copperArea;  // Exact copper outlines
+    ClipperLib::Paths clearanceArea;  // Copper outlines + clearance - tolerance
+    std::size_t hash = 0;  // Hash of all properties above, except object
+    bool unchanged = false;  // Whether it is identical in the previous run
+  };
+  struct Offset {
+    ClipperLib::Paths area;
+    Length offset;
+    ClipperLib::Paths result;
+  };
+  struct Candidate {
+    int item1;  // Index in #items
+    int item2;  // Index in #items
+    QSet<const Layer*> layers;  // Copper layers both items have in common
+  };
+  typedef QVector<Candidate> Group;  // All candidates of one object pair
+  typedef std::pair<std::size_t, std::size_t> HashPair;  // Sorted item hashes
+
+  // Filled by the stage 1 job.
+  std::shared_ptr<const CopperClearanceJobData> previous;  // Previous run
+  QVector<Item> items;
+  QHash<std::size_t, int> itemIndices;  // Key: Item::hash
+  QHash<std::size_t, Offset> offsets;  // Offsetted planes & polygons
+  QHash<const Layer*, QVector<QVector<Group>>> tiles;  // Work of stage 2 jobs
+
+  // Filled by the stage 2 jobs.
+  QMutex mutex;
+  QHash<HashPair, QVector<Path>> locations;  // Locations of violations
+};
+
+static std::size_t hashCopperItem(
+    const BoardDesignRuleCheck::CopperClearanceJobData::Item& item) noexcept {
+  std::size_t seed = qHashMulti(0, item.startLayer, item.endLayer, item.net,
+                                item.clearance);
+  seed = ClipperHelpers::hash(item.copperArea, seed);
+  return ClipperHelpers::hash(item.clearanceArea, seed);
+}
+
+static bool isSameCopperItem(
+    const BoardDesignRuleCheck::CopperClearanceJobData::Item& item1,
+    const BoardDesignRuleCheck::CopperClearanceJobData::Item& item2) noexcept {
+  return (item1.startLayer == item2.startLayer) &&
+      (item1.endLayer == item2.endLayer) && (item1.net == item2.net) &&
+      (item1.clearance == item2.clearance) &&
+      (item1.copperArea == item2.copperArea) &&
+      (item1.clearanceArea == item2.clearanceArea);
+}
+
 /*******************************************************************************
  *  Constructors / Destructor
  ******************************************************************************/
@@ -68,17 +163,23 @@ void BoardDesignRuleCheck::start(Board& board,
   // Start time measurement.
   auto timer = std::make_shared<QElapsedTimer>();
   timer->start();
+  QElapsedTimer stepTimer;
+  Result result;
+  result.quick = quick;
 
   // Force rebuilding planes. Not parallelized with DRC check yet because
   // it's very tricky. Planes haven an impact on air wires which we have
   // to collect right now as the board cannot be accessed later from a thread.
   if (!quick) {
     emitStatus(tr("Rebuild planes..."));
+    stepTimer.start();
     BoardPlaneFragmentsBuilder builder;
     if (builder.start(board)) {
-      BoardPlaneFragmentsBuilder::Result result = builder.waitForFinished();
-      result.applyToBoard();
+      BoardPlaneFragmentsBuilder::Result planesResult =
+          builder.waitForFinished();
+      planesResult.applyToBoard();
     }
+    result.planesRebuildTimeMs = stepTimer.elapsed();
   }
   emitProgress(7);
 
@@ -86,16 +187,23 @@ void BoardDesignRuleCheck::start(Board& board,
   // but this has not been parallelized yet so we have to run it synchronously
   // in the main thread now.
   if (!quick) {
+    stepTimer.start();
     board.forceAirWiresRebuild();
+    result.airWiresRebuildTimeMs = stepTimer.elapsed();
   }
   emitProgress(10);
 
-  // Copy all relevant data for thread-safe access.
-  std::shared_ptr<Data> data = std::make_shared<Data>(board, settings, quick);
+  // Copy all relevant data for thread-safe access. This is the only copy,
+  // all jobs will share it read-only.
+  stepTimer.start();
+  std::shared_ptr<const Data> data =
+      std::make_shared<const Data>(board, settings, quick);
+  result.dataCopyTimeMs = stepTimer.elapsed();
   emitProgress(12);
 
   // Pass data to new thread.
-  mFuture = QtConcurrent::run(&BoardDesignRuleCheck::run, this, data, timer);
+  mFuture =
+      QtConcurrent::run(&BoardDesignRuleCheck::run, this, data, timer, result);
 }
 
 bool BoardDesignRuleCheck::isRunning() const noexcept {
@@ -125,8 +233,11 @@ void BoardDesignRuleCheck::cancel() noexcept {
  ******************************************************************************/
 
 BoardDesignRuleCheck::Result BoardDesignRuleCheck::tryRunJob(
-    JobFunc function, int weight) noexcept {
+    const QString& name, JobFunc function, int weight) noexcept {
   BoardDesignRuleCheck::Result result;
+  QElapsedTimer timer;
+  timer.start();
+  const quint64 clipperOperations = ClipperHelpers::getOperationCount();
   try {
     result.messages = function();
   } catch (const Exception& e) {
@@ -136,6 +247,9 @@ BoardDesignRuleCheck::Result BoardDesignRuleCheck::tryRunJob(
     qCritical() << "DRC check failed with exception:" << e.what();
     result.errors.append(e.what());
   }
+  result.jobs.append(JobStatistics{
+      name, timer.elapsed(),
+      ClipperHelpers::getOperationCount() - clipperOperations});
 
   {
     QMutexLocker lock(&mMutex);
@@ -147,10 +261,33 @@ BoardDesignRuleCheck::Result BoardDesignRuleCheck::tryRunJob(
 }
 
 BoardDesignRuleCheck::Result BoardDesignRuleCheck::run(
-    std::shared_ptr<const Data> data,
-    std::shared_ptr<QElapsedTimer> timer) noexcept {
+    std::shared_ptr<const Data> data, std::shared_ptr<QElapsedTimer> timer,
+    Result result) noexcept {
   emitProgress(15);
 
+  // Count the checked items, for profiling.
+  int padCount = 0;
+  int viaCount = 0;
+  int traceCount = 0;
+  for (const Data::Segment& ns : data->segments) {
+    padCount += ns.pads.count();
+    viaCount += ns.vias.count();
+    traceCount += ns.traces.count();
+  }
+  for (const Data::Device& dev : data->devices) {
+    padCount += dev.pads.count();
+  }
+  result.itemCounts = {
+      {"devices", data->devices.count()},
+      {"pads", padCount},
+      {"vias", viaCount},
+      {"traces", traceCount},
+      {"planes", data->planes.count()},
+      {"polygons", data->polygons.count()},
+      {"holes", data->holes.count()},
+      {"air wires", data->airWires.count()},
+  };
+
   // Prepare calculated job data.
   std::shared_ptr<CalculatedJobData> calcData =
       std::make_shared<CalculatedJobData>();
@@ -189,107 +326,168 @@ BoardDesignRuleCheck::Result BoardDesignRuleCheck::run(
   enum class Stage { Independent, Stage1, Stage2, Sequential };
   struct Job {
     BoardDesignRuleCheck* drc;
+    QString name;
     JobFunc function;
     Stage stage;
     int weight = 1;
     QFuture<Result> future;
 
-    Job(BoardDesignRuleCheck* drc, JobFunc function, Stage stage, int weight)
-      : drc(drc), function(function), stage(stage), weight(weight), future() {}
+    Job(BoardDesignRuleCheck* drc, const QString& name, JobFunc function,
+        Stage stage, int weight)
+      : drc(drc),
+        name(name),
+        function(function),
+        stage(stage),
+        weight(weight),
+        future() {}
     void run(Result& result) {
-      const Result jobResult = drc->tryRunJob(function, weight);
+      const Result jobResult = drc->tryRunJob(name, function, weight);
       result.messages.append(jobResult.messages);
       result.errors.append(jobResult.errors);
+      result.jobs.append(jobResult.jobs);
     }
     void start() {
-      future = QtConcurrent::run(
-          std::bind(&BoardDesignRuleCheck::tryRunJob, drc, function, weight));
+      future = QtConcurrent::run(std::bind(&BoardDesignRuleCheck::tryRunJob,
+                                           drc, name, function, weight));
     }
     void fetchResult(Result& result) {
       const Result jobResult = future.result();
       result.messages.append(jobResult.messages);
       result.errors.append(jobResult.errors);
+      result.jobs.append(jobResult.jobs);
     }
   };
   QList<Job> jobs;
-  auto addToStage1 = [&](Stage1Func func, int weight) {
-    // Run in other thread, so we have to copy the whole data structure.
-    auto jobData = std::make_shared<const Data>(*data);
+  // All jobs share the same immutable input data, no matter in which thread
+  // they are run. See the note in BoardDesignRuleCheckData about thread-safety.
+  auto addToStage1 = [&](const QString& name, Stage1Func func, int weight) {
     jobs.append(Job(
-        this,
-        [func, jobData, calcData]() {
-          func(*jobData, *calcData);
+        this, name,
+        [func, data, calcData]() {
+          func(*data, *calcData);
           return RuleCheckMessageList();
         },
         Stage::Stage1, weight));
   };
-  auto addToStage2 = [&](Stage2Func func, int weight) {
-    // Run in other thread, so we have to copy the whole data structure.
-    auto jobData = std::make_shared<const Data>(*data);
+  auto addToStage2 = [&](const QString& name, Stage2Func func, int weight) {
     jobs.append(Job(
-        this,
-        [this, func, jobData, calcData]() {
-          return (this->*func)(*jobData, *calcData);
+        this, name,
+        [this, func, data, calcData]() {
+          return (this->*func)(*data, *calcData);
         },
         Stage::Stage2, weight));
   };
-  auto addIndependent = [&](IndependentStageFunc func, int weight) {
-    // Run in other thread, so we have to copy the whole data structure.
-    auto jobData = std::make_shared<const Data>(*data);
+  auto addIndependent = [&](const QString& name, IndependentStageFunc func,
+                            int weight) {
     jobs.append(Job(
-        this, [this, func, jobData]() { return (this->*func)(*jobData); },
+        this, name, [this, func, data]() { return (this->*func)(*data); },
         Stage::Independent, weight));
   };
-  auto addSequential = [&](IndependentStageFunc func) {
-    // Run synchronously, so we don't need to copy the data structure.
+  auto addSequential = [&](const QString& name, IndependentStageFunc func) {
     jobs.append(Job(
-        this, [this, func, data]() { return (this->*func)(*data); },
+        this, name, [this, func, data]() { return (this->*func)(*data); },
         Stage::Sequential, 1));
   };
 
+  // The copper clearance check is the most expensive one, thus it is split
+  // into several stage 2 jobs to make use of all available CPU cores. Each
+  // copper layer is split into tiles of similar workload.
+  QList<const Layer*> copperLayers = data->copperLayers.values();
+  std::sort(copperLayers.begin(), copperLayers.end(),
+            [](const Layer* a, const Layer* b) {
+              return a->getCopperNumber() < b->getCopperNumber();
+            });
+  const int tilesPerLayer =
+      qBound(1,
+             (QThreadPool::globalInstance()->maxThreadCount() * 2) /
+                 std::max(copperLayers.count(), 1),
+             16);
+
   // Determine jobs to execute, in the order how they should be started.
+  addToStage1(
+      "prepareCopperCopperClearances",
+      [this, tilesPerLayer](const Data& data, CalculatedJobData& calcData) {
+        prepareCopperCopperClearances(data, calcData, tilesPerLayer);
+      },
+      3);
   for (const Layer* layer : data->copperLayers) {
     // Calculate copper paths for each layer.
     addToStage1(
+        QString("prepareCopperPaths(%1)").arg(layer->getId()),
         [this, layer](const Data& data, CalculatedJobData& calcData) {
           prepareCopperPaths(data, calcData, *layer);
         },
         3);
   }
 
-  addToStage2(&BoardDesignRuleCheck::checkCopperHoleClearances, 3);
+  for (const Layer* layer : copperLayers) {
+    for (int tile = 0; tile < tilesPerLayer; ++tile) {
+      jobs.append(Job(
+          this,
+          QString("checkCopperCopperClearances(%1, %2)")
+              .arg(layer->getId())
+              .arg(tile),
+          [this, calcData, layer, tile]() {
+            return checkCopperCopperClearances(*calcData, *layer, tile);
+          },
+          Stage::Stage2, 1));
+    }
+  }
+  addToStage2("checkCopperHoleClearances",
+              &BoardDesignRuleCheck::checkCopperHoleClearances, 3);
   if (!data->quick) {
-    addToStage2(&BoardDesignRuleCheck::checkMinimumPthAnnularRing, 2);
-    addToStage2(&BoardDesignRuleCheck::checkBoardCutouts, 3);
+    addToStage2("checkMinimumPthAnnularRing",
+                &BoardDesignRuleCheck::checkMinimumPthAnnularRing, 2);
+    addToStage2("checkBoardCutouts", &BoardDesignRuleCheck::checkBoardCutouts,
+                3);
   }
-  addIndependent(&BoardDesignRuleCheck::checkCopperCopperClearances, 5);
-  addIndependent(&BoardDesignRuleCheck::checkCopperBoardClearances, 3);
+  addIndependent("checkCopperBoardClearances",
+                 &BoardDesignRuleCheck::checkCopperBoardClearances, 3);
   if (!data->quick) {
-    addIndependent(&BoardDesignRuleCheck::checkDrillDrillClearances, 2);
-    addIndependent(&BoardDesignRuleCheck::checkDrillBoardClearances, 2);
-    addIndependent(&BoardDesignRuleCheck::checkSilkscreenStopmaskClearances, 2);
-    addIndependent(&BoardDesignRuleCheck::checkZones, 2);
-    addIndependent(&BoardDesignRuleCheck::checkInvalidPadConnections, 2);
-    addIndependent(&BoardDesignRuleCheck::checkDeviceClearances, 2);
-    addIndependent(&BoardDesignRuleCheck::checkBoardOutline, 1);
-    addIndependent(&BoardDesignRuleCheck::checkVias, 1);
-  }
-  addSequential(&BoardDesignRuleCheck::checkMinimumCopperWidth);
+    addIndependent("checkDrillDrillClearances",
+                   &BoardDesignRuleCheck::checkDrillDrillClearances, 2);
+    addIndependent("checkDrillBoardClearances",
+                   &BoardDesignRuleCheck::checkDrillBoardClearances, 2);
+    addIndependent("checkSilkscreenStopmaskClearances",
+                   &BoardDesignRuleCheck::checkSilkscreenStopmaskClearances, 2);
+    addIndependent("checkZones", &BoardDesignRuleCheck::checkZones, 2);
+    addIndependent("checkInvalidPadConnections",
+                   &BoardDesignRuleCheck::checkInvalidPadConnections, 2);
+    addIndependent("checkDeviceClearances",
+                   &BoardDesignRuleCheck::checkDeviceClearances, 2);
+    addIndependent("checkBoardOutline",
+                   &BoardDesignRuleCheck::checkBoardOutline, 1);
+    addIndependent("checkVias", &BoardDesignRuleCheck::checkVias, 1);
+  }
+  addSequential("checkMinimumCopperWidth",
+                &BoardDesignRuleCheck::checkMinimumCopperWidth);
   if (!data->quick) {
-    addSequential(&BoardDesignRuleCheck::checkPlanes);
-    addSequential(&BoardDesignRuleCheck::checkAllowedNpthSlots);
-    addSequential(&BoardDesignRuleCheck::checkAllowedPthSlots);
-    addSequential(&BoardDesignRuleCheck::checkUsedLayers);
-    addSequential(&BoardDesignRuleCheck::checkForUnplacedComponents);
-    addSequential(&BoardDesignRuleCheck::checkForMissingConnections);
-    addSequential(&BoardDesignRuleCheck::checkForImpossibleConnections);
-    addSequential(&BoardDesignRuleCheck::checkForStaleObjects);
-    addSequential(&BoardDesignRuleCheck::checkMinimumSilkscreenWidth);
-    addSequential(&BoardDesignRuleCheck::checkMinimumSilkscreenTextHeight);
-    addSequential(&BoardDesignRuleCheck::checkMinimumNpthDrillDiameter);
-    addSequential(&BoardDesignRuleCheck::checkMinimumNpthSlotWidth);
-    addSequential(&BoardDesignRuleCheck::checkMinimumPthDrillDiameter);
-    addSequential(&BoardDesignRuleCheck::checkMinimumPthSlotWidth);
+    addSequential("checkPlanes", &BoardDesignRuleCheck::checkPlanes);
+    addSequential("checkAllowedNpthSlots",
+                  &BoardDesignRuleCheck::checkAllowedNpthSlots);
+    addSequential("checkAllowedPthSlots",
+                  &BoardDesignRuleCheck::checkAllowedPthSlots);
+    addSequential("checkUsedLayers", &BoardDesignRuleCheck::checkUsedLayers);
+    addSequential("checkForUnplacedComponents",
+                  &BoardDesignRuleCheck::checkForUnplacedComponents);
+    addSequential("checkForMissingConnections",
+                  &BoardDesignRuleCheck::checkForMissingConnections);
+    addSequential("checkForImpossibleConnections",
+                  &BoardDesignRuleCheck::checkForImpossibleConnections);
+    addSequential("checkForStaleObjects",
+                  &BoardDesignRuleCheck::checkForStaleObjects);
+    addSequential("checkMinimumSilkscreenWidth",
+                  &BoardDesignRuleCheck::checkMinimumSilkscreenWidth);
+    addSequential("checkMinimumSilkscreenTextHeight",
+                  &BoardDesignRuleCheck::checkMinimumSilkscreenTextHeight);
+    addSequential("checkMinimumNpthDrillDiameter",
+                  &BoardDesignRuleCheck::checkMinimumNpthDrillDiameter);
+    addSequential("checkMinimumNpthSlotWidth",
+                  &BoardDesignRuleCheck::checkMinimumNpthSlotWidth);
+    addSequential("checkMinimumPthDrillDiameter",
+                  &BoardDesignRuleCheck::checkMinimumPthDrillDiameter);
+    addSequential("checkMinimumPthSlotWidth",
+                  &BoardDesignRuleCheck::checkMinimumPthSlotWidth);
   }
 
   // Calculate total jobs weight. After this, progress is determined by the
@@ -310,8 +508,6 @@ BoardDesignRuleCheck::Result BoardDesignRuleCheck::run(
   }
 
   // Collect results of stage 1 jobs.
-  Result result;
-  result.quick = data->quick;
   for (Job& job : jobs) {
     if (job.stage == Stage::Stage1) {
       job.fetchResult(result);  // Blocks until finished.
@@ -339,11 +535,20 @@ BoardDesignRuleCheck::Result BoardDesignRuleCheck::run(
     }
   }
 
+  // Keep the copper clearance data for the next run. The reference to the
+  // previous run must be released to avoid keeping all runs in memory.
+  if (calcData->copperClearances) {
+    calcData->copperClearances->previous.reset();
+    calcData->copperClearances->tiles.clear();
+  }
+  mPreviousCopperClearances = calcData->copperClearances;
+
   // Finished!
   result.elapsedTimeMs = timer->elapsed();
   qDebug() << (data->quick ? "Quick check" : "DRC")
            << (result.errors.isEmpty() ? "succeeded" : "failed") << "after"
-           << result.elapsedTimeMs << "ms.";
+           << result.elapsedTimeMs << "ms (copying board data took"
+           << result.dataCopyTimeMs << "ms).";
   emitStatus(tr("Finished with %1 message(s)!", "Count of messages",
                 result.messages.count())
                  .arg(result.messages.count()));
@@ -362,10 +567,8 @@ void BoardDesignRuleCheck::prepareCopperPaths(const Data& data,
   calcData.copperPathsPerLayer[&layer] = gen.getPaths();
 }
 
-RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
-    const Data& data) {
-  RuleCheckMessageList messages;
-
+void BoardDesignRuleCheck::prepareCopperCopperClearances(
+    const Data& data, CalculatedJobData& calcData, int tilesPerLayer) {
   // Skip this check if no minimum copper clearances are configured.
   bool anyClearanceSet = data.settings.getMinCopperCopperClearance() > 0;
   for (const auto& nc : data.netClasses) {
@@ -374,7 +577,7 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
     }
   }
   if (!anyClearanceSet) {
-    return messages;
+    return;
   }
 
   emitStatus(tr("Check copper clearances..."));
@@ -382,18 +585,36 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
   // Subtract a tolerance to avoid false-positives due to inaccuracies.
   const Length tolerance = maxArcTolerance() + Length(1);
 
-  // Determine the area of each copper object.
-  struct Item {
-    DrcMsgCopperCopperClearanceViolation::Object object;
-    const Layer* startLayer;
-    const Layer* endLayer;
-    std::optional<Uuid> net;  // nullopt = no net
-    Length clearance;  // Either from object, net class or DRC settings.
-    ClipperLib::Paths copperArea;  // Exact copper outlines
-    ClipperLib::Paths clearanceArea;  // Copper outlines + clearance - tolerance
+  // Data of the previous run, and the new data to be filled now.
+  typedef CopperClearanceJobData::Item Item;
+  typedef CopperClearanceJobData::Candidate Candidate;
+  typedef CopperClearanceJobData::Group Group;
+  const std::shared_ptr<const CopperClearanceJobData> previous =
+      mPreviousCopperClearances
+      ? mPreviousCopperClearances
+      : std::make_shared<const CopperClearanceJobData>();
+  std::shared_ptr<CopperClearanceJobData> jobData =
+      std::make_shared<CopperClearanceJobData>();
+  jobData->previous = previous;
+  QVector<Item>& items = jobData->items;
+
+  // Helper to offset the copper area of an item by its clearance. Since this
+  // is expensive for large areas like planes, the result is cached.
+  auto offsetClearanceArea = [&](Item& item) {
+    const Length offset = std::max(item.clearance - tolerance, Length(0));
+    const std::size_t key = ClipperHelpers::hash(item.copperArea, qHash(offset));
+    auto cached = previous->offsets.constFind(key);
+    if ((cached != previous->offsets.constEnd()) &&
+        (cached->offset == offset) && (cached->area == item.copperArea)) {
+      item.clearanceArea = cached->result;
+    } else {
+      item.clearanceArea = item.copperArea;
+      ClipperHelpers::offset(item.clearanceArea, offset, maxArcTolerance());
+    }
+    jobData->offsets.insert(key, CopperClearanceJobData::Offset{
+                                     item.copperArea, offset,
+                                     item.clearanceArea});
   };
-  typedef QList<Item> Items;
-  Items items;
 
   // Helper for pads.
   BoardClipperPathGenerator gen(maxArcTolerance());
@@ -478,10 +699,7 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
                  {}});
         gen.addPlane(plane.fragments);
         gen.takePathsTo(it->copperArea);
-        it->clearanceArea = it->copperArea;
-        ClipperHelpers::offset(it->clearanceArea,
-                               std::max(clearance - tolerance, Length(0)),
-                               maxArcTolerance());
+        offsetClearanceArea(*it);
       }
     }
   }
@@ -503,10 +721,7 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
                {}});
       gen.addPolygon(polygon.path, polygon.lineWidth, polygon.filled);
       gen.takePathsTo(it->copperArea);
-      it->clearanceArea = it->copperArea;
-      ClipperHelpers::offset(it->clearanceArea,
-                             std::max(clearance - tolerance, Length(0)),
-                             maxArcTolerance());
+      offsetClearanceArea(*it);
     }
   }
 
@@ -562,10 +777,7 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
         gen.addPolygon(transform.map(polygon.path), polygon.lineWidth,
                        polygon.filled);
         gen.takePathsTo(it->copperArea);
-        it->clearanceArea = it->copperArea;
-        ClipperHelpers::offset(it->clearanceArea,
-                               std::max(clearance - tolerance, Length(0)),
-                               maxArcTolerance());
+        offsetClearanceArea(*it);
       }
     }
 
@@ -617,91 +829,208 @@ RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
     }
   }
 
-  // Helper to check for overlapping layer spans.
-  QSet<const Layer*> overlappingLayers;
-  auto layersOverlap = [&data, &overlappingLayers](
-                           const Layer* start1, const Layer* end1,
-                           const Layer* start2, const Layer* end2) {
-    overlappingLayers.clear();
-    const int first =
-        std::max(start1->getCopperNumber(), start2->getCopperNumber());
-    const int last = std::min(end1->getCopperNumber(), end2->getCopperNumber());
+  // Determine which items are unchanged since the previous run. Only pairs
+  // of unchanged items can reuse the previous results.
+  for (int i = 0; i < items.count(); ++i) {
+    Item& item = items[i];
+    item.hash = hashCopperItem(item);
+    const int previousIndex = previous->itemIndices.value(item.hash, -1);
+    item.unchanged = (previousIndex >= 0) &&
+        isSameCopperItem(previous->items.at(previousIndex), item);
+    jobData->itemIndices.insert(item.hash, i);
+  }
+
+  // Helper to determine the copper layers two items have in common, sorted
+  // from top to bottom.
+  auto getCommonLayers = [&data](const Item& item1, const Item& item2) {
+    QVector<const Layer*> layers;
+    const int first = std::max(item1.startLayer->getCopperNumber(),
+                               item2.startLayer->getCopperNumber());
+    const int last = std::min(item1.endLayer->getCopperNumber(),
+                              item2.endLayer->getCopperNumber());
     for (int i = first; i <= last; ++i) {
       const Layer* layer = Layer::copper(i);
       if (data.copperLayers.contains(layer)) {
-        overlappingLayers.insert(layer);
+        layers.append(layer);
       }
     }
-    return !overlappingLayers.isEmpty();
+    return layers;
   };
 
+  // Build a spatial index of the clearance areas for each copper layer, so
+  // only items with overlapping bounding boxes need to be checked by Clipper.
+  // Since the clearance area always contains the copper area, items whose
+  // clearance areas do not overlap can never violate the clearance.
+  QVector<BoundingBoxIndex::Rect> rects;
+  QHash<const Layer*, BoundingBoxIndex> indices;
+  for (int i = 0; i < items.count(); ++i) {
+    const Item& item = items.at(i);
+    rects.append(BoundingBoxIndex::Rect::fromPaths(item.clearanceArea));
+    for (int n = item.startLayer->getCopperNumber();
+         n <= item.endLayer->getCopperNumber(); ++n) {
+      const Layer* layer = Layer::copper(n);
+      if (data.copperLayers.contains(layer)) {
+        indices[layer].insert(i, rects.last());
+      }
+    }
+  }
+
+  // Collect all candidate pairs. Items spanning multiple layers (e.g. vias)
+  // are reported by the index of each layer, so only keep the pair from the
+  // first layer both items have in common. The pairs are sorted to get the
+  // same (deterministic) order of messages as with a nested loop.
+  QVector<BoundingBoxIndex::Pair> pairs;
+  for (auto it = indices.begin(); it != indices.end(); it++) {
+    for (const BoundingBoxIndex::Pair& pair : it->findOverlappingPairs()) {
+      const QVector<const Layer*> layers =
+          getCommonLayers(items.at(pair.first), items.at(pair.second));
+      if ((!layers.isEmpty()) && (layers.first() == it.key())) {
+        pairs.append(pair);
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+
+  // Group the candidates by object pair since all violations of the same
+  // object pair are merged into a single message. Thus each group must be
+  // checked by the same stage 2 job.
+  struct GroupInfo {
+    const Layer* layer;  // Layer of the first candidate
+    qint64 x;  // Left edge of the overlapping area of the first candidate
+  };
+  QVector<Group> groups;
+  QVector<GroupInfo> groupInfos;
+  QHash<UnorderedPair<DrcMsgCopperCopperClearanceViolation::Object>, int>
+      groupIndices;
+  for (const BoundingBoxIndex::Pair& pair : pairs) {
+    const Item& item1 = items.at(pair.first);
+    const Item& item2 = items.at(pair.second);
+    if (((item1.clearance > 0) || (item2.clearance > 0)) &&
+        ((item1.net != item2.net) || (!item1.net) || (!item2.net))) {
+      const QVector<const Layer*> layers = getCommonLayers(item1, item2);
+      const Candidate candidate{pair.first, pair.second,
+                                QSet<const Layer*>(layers.begin(),
+                                                   layers.end())};
+      const UnorderedPair<DrcMsgCopperCopperClearanceViolation::Object> key{
+          item1.object, item2.object};
+      auto it = groupIndices.find(key);
+      if (it != groupIndices.end()) {
+        groups[*it].append(candidate);
+      } else {
+        groupIndices.insert(key, groups.count());
+        groups.append(Group{candidate});
+        groupInfos.append(GroupInfo{
+            layers.first(),
+            std::max(rects.at(pair.first).minX, rects.at(pair.second).minX)});
+      }
+    }
+  }
+
+  // Split each layer into vertical stripes (tiles) containing the same
+  // number of groups, to distribute the work evenly across the stage 2 jobs.
+  // Since each group is assigned to exactly one tile, pairs crossing tile
+  // borders are still checked only once.
+  QHash<const Layer*, QVector<int>> groupsPerLayer;
+  for (int i = 0; i < groups.count(); ++i) {
+    groupsPerLayer[groupInfos.at(i).layer].append(i);
+  }
+  for (auto it = groupsPerLayer.begin(); it != groupsPerLayer.end(); it++) {
+    QVector<int>& indices = it.value();
+    std::stable_sort(indices.begin(), indices.end(), [&](int a, int b) {
+      return groupInfos.at(a).x < groupInfos.at(b).x;
+    });
+    QVector<QVector<Group>>& tiles = jobData->tiles[it.key()];
+    tiles.resize(tilesPerLayer);
+    const int groupsPerTile = (indices.count() + tilesPerLayer - 1) /
+        tilesPerLayer;  // Round up.
+    for (int i = 0; i < indices.count(); ++i) {
+      tiles[i / groupsPerTile].append(groups.at(indices.at(i)));
+    }
+  }
+
+  QMutexLocker lock(&calcData.mutex);
+  calcData.copperClearances = jobData;
+}
+
+RuleCheckMessageList BoardDesignRuleCheck::checkCopperCopperClearances(
+    const CalculatedJobData& calcData, const Layer& layer, int tile) {
+  RuleCheckMessageList messages;
+
+  // The data is null if the check is disabled.
+  const std::shared_ptr<CopperClearanceJobData> jobData =
+      calcData.copperClearances;
+  if (!jobData) {
+    return messages;
+  }
+  typedef CopperClearanceJobData::Item Item;
+  typedef CopperClearanceJobData::HashPair HashPair;
+  const CopperClearanceJobData& d = *jobData;  // Shared by all stage 2 jobs!
+  const CopperClearanceJobData& previous = *d.previous;
+  const QVector<CopperClearanceJobData::Group> groups =
+      d.tiles.value(&layer).value(tile);
+
   // Helper to check for intersections.
-  auto checkForIntersections = [](Items::Iterator& it1, Items::Iterator& it2,
+  auto checkForIntersections = [](const Item& item1, const Item& item2,
                                   QVector<Path>& locations) {
     const std::unique_ptr<ClipperLib::PolyTree> intersections =
-        ClipperHelpers::intersectToTree(it1->copperArea, it2->clearanceArea,
+        ClipperHelpers::intersectToTree(item1.copperArea, item2.clearanceArea,
                                         ClipperLib::pftEvenOdd,
                                         ClipperLib::pftEvenOdd);
     locations.append(
         ClipperHelpers::convert(ClipperHelpers::flattenTree(*intersections)));
   };
 
-  // Structure to memorize violations since we want to
-  // emit messages only once per object1<->object2 pair.
-  struct Violation {
-    DrcMsgCopperCopperClearanceViolation::Object obj1;
-    DrcMsgCopperCopperClearanceViolation::Object obj2;
+  // Check each object pair and emit one message per pair.
+  QHash<HashPair, QVector<Path>> newLocations;
+  for (const CopperClearanceJobData::Group& group : groups) {
+    const Item* obj1 = nullptr;
+    const Item* obj2 = nullptr;
     QSet<const Layer*> layers;
-    Length clearance;
+    Length clearance(0);
     QVector<Path> locations;
-  };
-  QVector<Violation> violations;
-  auto addViolation = [&violations](const Violation& violation) {
-    for (Violation& v : violations) {
-      if (((violation.obj1 == v.obj1) && (violation.obj2 == v.obj2)) ||
-          ((violation.obj1 == v.obj2) && (violation.obj2 == v.obj1))) {
-        // Merge with existing violation.
-        v.layers |= violation.layers;
-        v.clearance = std::max(v.clearance, violation.clearance);
-        v.locations += violation.locations;
-        return;
-      }
-    }
-    violations.append(violation);
-  };
-
-  // Now check for intersections.
-  auto lastItem = items.isEmpty() ? items.end() : std::prev(items.end());
-  for (auto it1 = items.begin(); it1 != lastItem; it1++) {
-    for (auto it2 = it1 + 1; it2 != items.end(); it2++) {
-      if (((it1->clearance > 0) || (it2->clearance > 0)) &&
-          ((it1->net != it2->net) || (!it1->net) || (!it2->net)) &&
-          layersOverlap(it1->startLayer, it1->endLayer, it2->startLayer,
-                        it2->endLayer)) {
-        QVector<Path> locations;
-        checkForIntersections(it1, it2, locations);
+    for (const CopperClearanceJobData::Candidate& candidate : group) {
+      const Item& item1 = d.items.at(candidate.item1);
+      const Item& item2 = d.items.at(candidate.item2);
+      const HashPair key = std::make_pair(std::min(item1.hash, item2.hash),
+                                          std::max(item1.hash, item2.hash));
+      auto cached = previous.locations.constEnd();
+      if (item1.unchanged && item2.unchanged) {
+        cached = previous.locations.constFind(key);
+      }
+      QVector<Path> pairLocations;
+      if (cached != previous.locations.constEnd()) {
+        pairLocations = *cached;
+      } else {
+        checkForIntersections(item1, item2, pairLocations);
         // Perform the check the other way around only if:
         //  - Either the two items have individual clearances
         //  - Or there are any intersections -> show both violations in UI
-        if ((it1->clearance != it2->clearance) || (!locations.isEmpty())) {
-          checkForIntersections(it2, it1, locations);
+        if ((item1.clearance != item2.clearance) ||
+            (!pairLocations.isEmpty())) {
+          checkForIntersections(item2, item1, pairLocations);
         }
-        if (!locations.isEmpty()) {
-          addViolation(Violation{it1->object, it2->object, overlappingLayers,
-                                 std::max(it1->clearance, it2->clearance),
-                                 locations});
+      }
+      newLocations.insert(key, pairLocations);
+      if (!pairLocations.isEmpty()) {
+        if (!obj1) {
+          obj1 = &item1;
+          obj2 = &item2;
         }
+        layers |= candidate.layers;
+        clearance = std::max(clearance, item1.clearance);
+        clearance = std::max(clearance, item2.clearance);
+        locations += pairLocations;
       }
     }
+    if (obj1 && obj2) {
+      messages.append(std::make_shared<DrcMsgCopperCopperClearanceViolation>(
+          obj1->object, obj2->object, layers, clearance, locations));
+    }
   }
 
-  // Emit messages.
-  for (const Violation& violation : violations) {
-    messages.append(std::make_shared<DrcMsgCopperCopperClearanceViolation>(
-        violation.obj1, violation.obj2, violation.layers, violation.clearance,
-        violation.locations));
-  }
-
+  // Memorize the results for the next run.
+  QMutexLocker lock(&jobData->mutex);
+  jobData->locations.insert(newLocations);
   return messages;
 }
 
@@ -50,6 +50,7 @@ class BoardDesignRuleCheck final : public QObject {
 public:
   // Types
   using Data = BoardDesignRuleCheckData;
+  struct CopperClearanceJobData;  // Defined in the source file.
   struct CalculatedJobData {
     // This structure is filled by stage 1 jobs and read by stage 2 jobs.
     // Each stage 2 job gets a copy of this structure, so no synchronization
@@ -59,6 +60,13 @@ public:
     mutable QMutex mutex;  // To be used by stage 1 jobs.
 
     QHash<const Layer*, ClipperLib::Paths> copperPathsPerLayer;
+    std::shared_ptr<CopperClearanceJobData> copperClearances;
+  };
+
+  struct JobStatistics {
+    QString name;
+    qint64 elapsedTimeMs = 0;
+    quint64 clipperOperations = 0;  // See ClipperHelpers::getOperationCount()
   };
 
   struct Result {
@@ -66,6 +74,11 @@ public:
     QStringList errors;  // Empty on success.
     bool quick = false;
     qint64 elapsedTimeMs = 0;
+    qint64 planesRebuildTimeMs = 0;  // Part of elapsedTimeMs.
+    qint64 airWiresRebuildTimeMs = 0;  // Part of elapsedTimeMs.
+    qint64 dataCopyTimeMs = 0;  // Part of elapsedTimeMs.
+    QVector<std::pair<QString, int>> itemCounts;  // Number of checked items.
+    QVector<JobStatistics> jobs;  // All executed jobs, in parallel or not.
   };
 
   // Constructors / Destructor
@@ -104,12 +117,16 @@ private:  // Methods
   typedef RuleCheckMessageList (BoardDesignRuleCheck::*IndependentStageFunc)(
       const Data&);
 
-  Result tryRunJob(JobFunc function, int weight) noexcept;
+  Result tryRunJob(const QString& name, JobFunc function, int weight) noexcept;
   Result run(std::shared_ptr<const Data> data,
-             std::shared_ptr<QElapsedTimer> timer) noexcept;
+             std::shared_ptr<QElapsedTimer> timer, Result result) noexcept;
   void prepareCopperPaths(const Data& data, CalculatedJobData& calcData,
                           const Layer& layer);
-  RuleCheckMessageList checkCopperCopperClearances(const Data& data);
+  void prepareCopperCopperClearances(const Data& data,
+                                     CalculatedJobData& calcData,
+                                     int tilesPerLayer);
+  RuleCheckMessageList checkCopperCopperClearances(
+      const CalculatedJobData& calcData, const Layer& layer, int tile);
   RuleCheckMessageList checkCopperBoardClearances(const Data& data);
   RuleCheckMessageList checkCopperHoleClearances(
       const Data& data, const CalculatedJobData& calcData);
@@ -178,6 +195,19 @@ private:  // Data
   int mProgressCounter = 0;  // 0..mProgressTotal
   QFuture<Result> mFuture;
   bool mAbort = false;
+
+  /**
+   * @brief Copper clearance data of the previous run
+   *
+   * Used as a result cache for the copper clearance check: Pairs of objects
+   * which are unchanged since the previous run reuse their results. Runs never
+   * overlap since #start() waits for the previous run to finish.
+   *
+   * @note This is not an incremental DRC. The data snapshot is still taken
+   *       from the whole board, all other checks always run on all objects
+   *       and the resulting message list is built from scratch.
+   */
+  std::shared_ptr<const CopperClearanceJobData> mPreviousCopperClearances;
 };
 
 /*******************************************************************************
@@ -286,10 +286,15 @@ BoardDesignRuleCheckData::BoardDesignRuleCheckData(
     }
     return ret;
   };
-  foreach (const BI_AirWire* aw, board.getAirWires()) {
-    airWires.append(AirWire{convertAnchor(aw->getP1()),
-                            convertAnchor(aw->getP2()),
-                            *aw->getNetSignal().getName()});
+  // Only needed for the full check, which rebuilds the air wires before. In
+  // the quick check, the anchors of outdated air wires might not exist
+  // anymore.
+  if (!quickCheck) {
+    foreach (const BI_AirWire* aw, board.getAirWires()) {
+      airWires.append(AirWire{convertAnchor(aw->getP1()),
+                              convertAnchor(aw->getP2()),
+                              *aw->getNetSignal().getName()});
+    }
   }
   foreach (const ComponentInstance* cmp,
            board.getProject().getCircuit().getComponentInstances()) {
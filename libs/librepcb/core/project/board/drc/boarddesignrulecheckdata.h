@@ -184,9 +184,13 @@ struct BoardDesignRuleCheckData final {
     QList<ImpossibleConnection> impossibleSignalConnections;
   };
 
-  // NOTE: We create a `const` copy of this structure for each thread to
-  // ensure thread-safety. For the implicitly shared Qt containers this is
-  // a lightweight operation.
+  // NOTE: This structure is created once per DRC run and then shared
+  // read-only (`const`) between all worker threads. Concurrent access is
+  // thread-safe as long as only const methods are used, thus it must never
+  // be modified after construction. Copying is not allowed to avoid
+  // accidentally detaching the contained containers. Be careful with
+  // `Path::toQPainterPathPx()` which lazily fills a cache, so it must be
+  // called on the same path by only one job.
   BoardDesignRuleCheckSettings settings;
   bool quick = false;
   QSet<const Layer*> copperLayers;  // All board copper layers.
@@ -204,10 +208,16 @@ struct BoardDesignRuleCheckData final {
   QMap<Uuid, QString> unplacedComponents;  // UUID and name.
 
   // Constructors / Destructor
+  BoardDesignRuleCheckData() = delete;
+  BoardDesignRuleCheckData(const BoardDesignRuleCheckData& other) = delete;
   BoardDesignRuleCheckData(const Board& board,
                            const BoardDesignRuleCheckSettings& drcSettings,
                            bool quickCheck) noexcept;
 
+  // Operator Overloadings
+  BoardDesignRuleCheckData& operator=(const BoardDesignRuleCheckData& rhs) =
+      delete;
+
   // Helper Methods
   UnsignedLength getMinCopperCopperClearance(
       const std::optional<Uuid>& netClass) const noexcept {
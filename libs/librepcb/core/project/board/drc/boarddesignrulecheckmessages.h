@@ -609,12 +609,25 @@ public:
       return obj;
     }
 
-    bool operator==(const Object& rhs) const {
-      std::unique_ptr<SExpression> obj1 = SExpression::createList("object");
-      serialize(*obj1);
-      std::unique_ptr<SExpression> obj2 = SExpression::createList("object");
-      rhs.serialize(*obj2);
-      return (*obj1) == (*obj2);
+    // Objects always refer to items of the same (immutable) DRC input data,
+    // thus comparing and hashing the pointers identifies them uniquely. This
+    // is much faster than comparing their serialization, which is important
+    // when merging thousands of violations.
+    bool operator==(const Object& rhs) const noexcept {
+      return (mPad == rhs.mPad) && (mTrace == rhs.mTrace) &&
+          (mVia == rhs.mVia) && (mPlane == rhs.mPlane) &&
+          (mPolygon == rhs.mPolygon) && (mCircle == rhs.mCircle) &&
+          (mStrokeText == rhs.mStrokeText) && (mSegment == rhs.mSegment) &&
+          (mDevice == rhs.mDevice);
+    }
+    bool operator!=(const Object& rhs) const noexcept {
+      return !(*this == rhs);
+    }
+    friend std::size_t qHash(const Object& key,
+                             std::size_t seed = 0) noexcept {
+      return qHashMulti(seed, key.mPad, key.mTrace, key.mVia, key.mPlane,
+                        key.mPolygon, key.mCircle, key.mStrokeText,
+                        key.mSegment, key.mDevice);
     }
 
   private:
@@ -37,7 +37,12 @@ namespace librepcb {
 
 BI_AirWire::BI_AirWire(Board& board, const NetSignal& netsignal,
                        const BI_NetLineAnchor& p1, const BI_NetLineAnchor& p2)
-  : BI_Base(board), mNetSignal(netsignal), mP1(p1), mP2(p2) {
+  : BI_Base(board),
+    mNetSignal(netsignal),
+    mP1(p1),
+    mP2(p2),
+    mPosition1(p1.getPosition()),
+    mPosition2(p2.getPosition()) {
 }
 
 BI_AirWire::~BI_AirWire() noexcept {
@@ -48,7 +53,7 @@ BI_AirWire::~BI_AirWire() noexcept {
  ******************************************************************************/
 
 bool BI_AirWire::isVertical() const noexcept {
-  return (mP1.getPosition() == mP2.getPosition());
+  return (mPosition1 == mPosition2);
 }
 
 /*******************************************************************************
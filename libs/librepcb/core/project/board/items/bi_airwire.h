@@ -23,6 +23,7 @@
 /*******************************************************************************
  *  Includes
  ******************************************************************************/
+#include "../../../types/point.h"
 #include "bi_base.h"
 
 #include <QtCore>
@@ -55,8 +56,18 @@ public:
 
   // Getters
   const NetSignal& getNetSignal() const noexcept { return mNetSignal; }
+
+  /**
+   * @brief Get the anchors of the air wire
+   *
+   * @warning Outdated air wires are kept until the rebuilt ones are available,
+   *          i.e. the anchors are only valid as long as no air wires rebuild
+   *          is pending. Use #getPosition1() and #getPosition2() for drawing.
+   */
   const BI_NetLineAnchor& getP1() const noexcept { return mP1; }
   const BI_NetLineAnchor& getP2() const noexcept { return mP2; }
+  const Point& getPosition1() const noexcept { return mPosition1; }
+  const Point& getPosition2() const noexcept { return mPosition2; }
   bool isVertical() const noexcept;
 
   // General Methods
@@ -70,6 +81,8 @@ private:
   const NetSignal& mNetSignal;
   const BI_NetLineAnchor& mP1;
   const BI_NetLineAnchor& mP2;
+  const Point mPosition1;  ///< Position of #mP1 at construction time
+  const Point mPosition2;  ///< Position of #mP2 at construction time
 };
 
 /*******************************************************************************
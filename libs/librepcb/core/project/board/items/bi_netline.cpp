@@ -164,9 +164,12 @@ void BI_NetLine::setLayer(const Layer& layer) {
 }
 
 void BI_NetLine::setWidth(const PositiveLength& width) noexcept {
+  const PositiveLength oldWidth = mTrace.getWidth();
   if (mTrace.setWidth(width)) {
     onEdited.notify(Event::WidthChanged);
-    mBoard.invalidatePlanes(&mTrace.getLayer());
+    mBoard.invalidatePlanes({mP1->getPosition(), mP2->getPosition()},
+                            UnsignedLength(std::max(oldWidth, width) / 2),
+                            &mTrace.getLayer());
   }
 }
 
@@ -186,7 +189,9 @@ void BI_NetLine::addToBoard() {
   BI_Base::addToBoard();
   sg.dismiss();
 
-  mBoard.invalidatePlanes(&mTrace.getLayer());
+  mBoard.invalidatePlanes({mP1->getPosition(), mP2->getPosition()},
+                          UnsignedLength(mTrace.getWidth() / 2),
+                          &mTrace.getLayer());
 
   if (const NetSignal* netsignal = mNetSegment.getNetSignal()) {
     mNetSignalNameChangedConnection =
@@ -207,7 +212,9 @@ void BI_NetLine::removeFromBoard() {
   BI_Base::removeFromBoard();
   sg.dismiss();
 
-  mBoard.invalidatePlanes(&mTrace.getLayer());
+  mBoard.invalidatePlanes({mP1->getPosition(), mP2->getPosition()},
+                          UnsignedLength(mTrace.getWidth() / 2),
+                          &mTrace.getLayer());
 
   if (mNetSignalNameChangedConnection) {
     disconnect(mNetSignalNameChangedConnection);
@@ -215,8 +222,11 @@ void BI_NetLine::removeFromBoard() {
   }
 }
 
-void BI_NetLine::updatePositions() noexcept {
+void BI_NetLine::updatePositions(const Point& oldAnchorPosition) noexcept {
   onEdited.notify(Event::PositionsChanged);
+  mBoard.invalidatePlanes(
+      {mP1->getPosition(), mP2->getPosition(), oldAnchorPosition},
+      UnsignedLength(mTrace.getWidth() / 2), &mTrace.getLayer());
 }
 
 /*******************************************************************************
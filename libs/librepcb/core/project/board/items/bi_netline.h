@@ -110,7 +110,16 @@ public:
   // General Methods
   void addToBoard() override;
   void removeFromBoard() override;
-  void updatePositions() noexcept;
+
+  /**
+   * @brief Notify about a moved anchor
+   *
+   * Must be called by the anchors after they have been moved. Schedules a
+   * rebuild of the planes around the old and new location of this trace.
+   *
+   * @param oldAnchorPosition   The anchor position before the move.
+   */
+  void updatePositions(const Point& oldAnchorPosition) noexcept;
 
   // Operator Overloadings
   BI_NetLine& operator=(const BI_NetLine& rhs) = delete;
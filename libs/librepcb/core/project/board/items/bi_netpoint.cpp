@@ -64,10 +64,10 @@ TraceAnchor BI_NetPoint::toTraceAnchor() const noexcept {
  ******************************************************************************/
 
 void BI_NetPoint::setPosition(const Point& position) noexcept {
+  const Point oldPosition = mJunction.getPosition();
   if (mJunction.setPosition(position)) {
     foreach (BI_NetLine* netLine, mRegisteredNetLines) {
-      netLine->updatePositions();
-      mBoard.invalidatePlanes(&netLine->getLayer());
+      netLine->updatePositions(oldPosition);
     }
     onEdited.notify(Event::PositionChanged);
     if (NetSignal* netsignal = mNetSegment.getNetSignal()) {
@@ -448,11 +448,12 @@ void BI_Pad::updateTransform() noexcept {
   }
 
   if (position != mPosition) {
+    const Point oldPosition = mPosition;
     mPosition = position;
     mBoard.scheduleAirWiresRebuild(getNetSignal());
     onEdited.notify(Event::PositionChanged);
     foreach (BI_NetLine* netLine, mRegisteredNetLines) {
-      netLine->updatePositions();
+      netLine->updatePositions(oldPosition);
     }
     invalidatePlanes();
   }
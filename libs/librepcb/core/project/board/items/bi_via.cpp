@@ -122,11 +122,13 @@ void BI_Via::setLayers(const Layer& from, const Layer& to) {
 }
 
 void BI_Via::setPosition(const Point& position) noexcept {
+  const Point oldPosition = mVia.getPosition();
   if (mVia.setPosition(position)) {
     foreach (BI_NetLine* netLine, mRegisteredNetLines) {
-      netLine->updatePositions();
+      netLine->updatePositions(oldPosition);
     }
-    mBoard.invalidatePlanes();
+    mBoard.invalidatePlanes({oldPosition, position},
+                            UnsignedLength(mActualSize / 2));
     if (NetSignal* netsignal = mNetSegment.getNetSignal()) {
       mBoard.scheduleAirWiresRebuild(netsignal);
     }
@@ -136,11 +138,13 @@ void BI_Via::setPosition(const Point& position) noexcept {
 
 void BI_Via::setDrillAndSize(const std::optional<PositiveLength>& drill,
                              const std::optional<PositiveLength>& size) {
+  const PositiveLength oldSize = mActualSize;
   if (mVia.setDrillAndSize(drill, size)) {
     onEdited.notify(Event::DrillOrSizeChanged);
     updateActualDrillAndSize();
     updateStopMaskDiameters();
-    mBoard.invalidatePlanes();
+    mBoard.invalidatePlanes({mVia.getPosition()},
+                            UnsignedLength(std::max(oldSize, mActualSize) / 2));
   }
 }
 
@@ -161,7 +165,8 @@ void BI_Via::addToBoard() {
   BI_Base::addToBoard();
   updateActualDrillAndSize();
   updateStopMaskDiameters();
-  mBoard.invalidatePlanes();
+  mBoard.invalidatePlanes({mVia.getPosition()},
+                          UnsignedLength(mActualSize / 2));
   mConnections.append(
       connect(&mBoard, &Board::designRulesModified, this, [this]() {
         updateActualDrillAndSize();
@@ -180,7 +185,8 @@ void BI_Via::removeFromBoard() {
     throw LogicError(__FILE__, __LINE__);
   }
   BI_Base::removeFromBoard();
-  mBoard.invalidatePlanes();
+  mBoard.invalidatePlanes({mVia.getPosition()},
+                          UnsignedLength(mActualSize / 2));
   if (NetSignal* netsignal = mNetSegment.getNetSignal()) {
     mBoard.scheduleAirWiresRebuild(netsignal);
   }
@@ -54,7 +54,7 @@ namespace librepcb {
  *   librepcb::SExpression.
  * - Iterators (for example to use in C++11 range based for loops).
  * - Methods to find elements by UUID and/or name (if supported by template type
- *   `T`).
+ *   `T`). Lookups by UUID use a lazily built hash index on larger lists.
  * - Method #sortedByUuid() to create a copy of the list with elements sorted by
  *   UUID.
  * - Signals to get notified about added, removed and modified elements.
@@ -225,6 +225,13 @@ public:
     return -1;
   }
   int indexOf(const Uuid& key) const noexcept {
+    if (count() >= sUuidIndexMinCount) {
+      QMutexLocker lock(&mUuidIndexMutex);
+      updateUuidIndex();
+      const int index = mUuidIndex.value(key, -1);
+      Q_ASSERT((index < 0) || (mObjects[index]->getUuid() == key));
+      return index;
+    }
     for (int i = 0; i < count(); ++i) {
       if (mObjects[i]->getUuid() == key) {
         return i;
@@ -276,9 +283,9 @@ public:
   std::shared_ptr<const T> at(int index) const noexcept {
     return std::const_pointer_cast<const T>(mObjects.at(index));
   }  // always read-only!
-  std::shared_ptr<T>& first() noexcept { return mObjects.first(); }
+  std::shared_ptr<T> first() noexcept { return mObjects.first(); }
   std::shared_ptr<const T> first() const noexcept { return mObjects.first(); }
-  std::shared_ptr<T>& last() noexcept { return mObjects.last(); }
+  std::shared_ptr<T> last() noexcept { return mObjects.last(); }
   std::shared_ptr<const T> last() const noexcept { return mObjects.last(); }
   std::shared_ptr<T> get(const T* obj) {
     std::shared_ptr<T> ptr = find(obj);
@@ -456,11 +463,25 @@ public:
 
 protected:  // Methods
   void insertElement(int index, const std::shared_ptr<T>& obj) noexcept {
+    {
+      // Appended elements are added to the index lazily, but inserting in
+      // between shifts the indices of all following elements.
+      QMutexLocker lock(&mUuidIndexMutex);
+      if (index < mUuidIndexCount) {
+        resetUuidIndex();
+      }
+    }
     mObjects.insert(index, obj);
     obj->onEdited.attach(mOnEditedSlot);
     onEdited.notify(index, obj, Event::ElementAdded);
   }
   std::shared_ptr<T> takeElement(int index) noexcept {
+    {
+      QMutexLocker lock(&mUuidIndexMutex);
+      if (index < mUuidIndexCount) {
+        resetUuidIndex();
+      }
+    }
     std::shared_ptr<T> obj = mObjects.takeAt(index);
     obj->onEdited.detach(mOnEditedSlot);
     onEdited.notify(index, obj, Event::ElementRemoved);
@@ -468,6 +489,14 @@ protected:  // Methods
   }
   void elementEditedHandler(const T& obj, OnEditedArgs... args) noexcept {
     int index = indexOf(&obj);
+    if constexpr (requires { obj.getUuid(); }) {
+      QMutexLocker lock(&mUuidIndexMutex);
+      if ((index >= 0) && (index < mUuidIndexCount) &&
+          (mUuidIndex.value(obj.getUuid(), -1) != index)) {
+        // The UUID of the element has been changed (or it is a duplicate).
+        resetUuidIndex();
+      }
+    }
     if (contains(index)) {
       onElementEdited.notify(index, at(index), args...);
       onEdited.notify(index, at(index), Event::ElementEdited);
@@ -495,6 +524,27 @@ protected:  // Methods
   }
 
 private:  // Internal Helper Methods
+  /**
+   * @brief Add all elements appended since the last call to the UUID index
+   *
+   * @note The caller must hold #mUuidIndexMutex.
+   */
+  void updateUuidIndex() const noexcept {
+    mUuidIndex.reserve(mObjects.count());
+    for (int i = mUuidIndexCount; i < mObjects.count(); ++i) {
+      // In case of duplicate UUIDs, the first element wins (as in a linear
+      // search).
+      const Uuid& uuid = mObjects[i]->getUuid();
+      if (!mUuidIndex.contains(uuid)) {
+        mUuidIndex.insert(uuid, i);
+      }
+    }
+    mUuidIndexCount = mObjects.count();
+  }
+  void resetUuidIndex() const noexcept {
+    mUuidIndex.clear();
+    mUuidIndexCount = 0;
+  }
   std::shared_ptr<T> copyObject(const T& other,
                                 std::true_type copyConstructable) noexcept {
     Q_UNUSED(copyConstructable);
@@ -514,6 +564,22 @@ private:  // Internal Helper Methods
 protected:  // Data
   QVector<std::shared_ptr<T>> mObjects;
   Slot<T, OnEditedArgs...> mOnEditedSlot;
+
+private:  // Data
+  /**
+   * Lazily built index for fast lookup by UUID, only used for lists with at
+   * least this number of elements. For smaller lists, a linear search is
+   * faster anyway.
+   */
+  static constexpr int sUuidIndexMinCount = 16;
+
+  /**
+   * Guards the UUID index since it is also modified by const lookups, which
+   * might be called concurrently from different threads.
+   */
+  mutable QMutex mUuidIndexMutex;
+  mutable QHash<Uuid, int> mUuidIndex;  ///< UUID -> index in #mObjects
+  mutable int mUuidIndexCount = 0;  ///< Number of elements in the index
 };
 
 }  // namespace librepcb
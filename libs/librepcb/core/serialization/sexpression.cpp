@@ -60,18 +60,23 @@ SExpression::~SExpression() noexcept {
  *  Getters
  ******************************************************************************/
 
+const FilePath& SExpression::getFilePath() const noexcept {
+  static const FilePath empty;
+  return mFilePath ? *mFilePath : empty;
+}
+
 const QString& SExpression::getName() const {
   if (isList()) {
     return mValue;
   } else {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, QString(),
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), QString(),
                          "Node is not a list.");
   }
 }
 
 const QString& SExpression::getValue() const {
   if (!isToken() && !isString()) {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, mValue,
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), mValue,
                          "Node is not a token or string.");
   }
   return mValue;
@@ -140,7 +145,7 @@ SExpression& SExpression::getChild(const QString& path) {
   if (child) {
     return *child;
   } else {
-    throw FileParseError(__FILE__, __LINE__, mFilePath, QString(),
+    throw FileParseError(__FILE__, __LINE__, getFilePath(), QString(),
                          QString("Child not found: %1").arg(path));
   }
 }
@@ -260,11 +265,14 @@ void SExpression::replaceRecursive(const SExpression& search,
 }
 
 QByteArray SExpression::toByteArray(Mode mode) const {
-  QString str = toString(0, mode);  // can throw
-  if (!str.endsWith('\n')) {
-    str += '\n';  // newline at end of file
+  // Note: The whole tree is written in a single pass into one UTF-8 buffer,
+  // without any intermediate (QString) copies of subtrees.
+  QByteArray output;
+  write(output, 0, mode);  // can throw
+  if (!output.endsWith('\n')) {
+    output += '\n';  // newline at end of file
   }
-  return str.toUtf8();
+  return output;
 }
 
 /*******************************************************************************
@@ -311,27 +319,54 @@ SExpression& SExpression::operator=(const SExpression& rhs) noexcept {
  *  Private Methods
  ******************************************************************************/
 
-QString SExpression::escapeString(const QString& string) noexcept {
-  static QHash<QChar, QString> replacements;
-  if (replacements.isEmpty()) {
-    replacements = {
-        {'"', "\\\""},  // Double quote *must* be escaped
-        {'\\', "\\\\"},  // Backslash *must* be escaped
-        {'\b', "\\b"},  // Escape backspace to increase readability
-        {'\f', "\\f"},  // Escape form feed to increase readability
-        {'\n', "\\n"},  // Escape line feed to increase readability
-        {'\r', "\\r"},  // Escape carriage return to increase readability
-        {'\t', "\\t"},  // Escape horizontal tab to increase readability
-        {'\v', "\\v"},  // Escape vertical tab to increase readability
-    };
-  }
-
-  QString escaped;
-  escaped.reserve(string.length() + (string.length() / 10));
-  foreach (const QChar& c, string) {
-    escaped += replacements.value(c, c);
+void SExpression::appendUtf8(QByteArray& output,
+                             QStringView string) noexcept {
+  // Encode directly into the output buffer to avoid a temporary QByteArray.
+  QStringEncoder encoder(QStringEncoder::Utf8);
+  const qsizetype oldSize = output.size();
+  output.resize(oldSize + encoder.requiredSpace(string.size()));
+  char* end = encoder.appendToBuffer(output.data() + oldSize, string);
+  output.resize(end - output.constData());
+}
+
+void SExpression::appendEscaped(QByteArray& output,
+                                const QString& string) noexcept {
+  qsizetype begin = 0;  // Start of the characters not written yet.
+  for (qsizetype i = 0; i < string.size(); ++i) {
+    const char* replacement = nullptr;
+    switch (string.at(i).unicode()) {
+      case '"':  // Double quote *must* be escaped
+        replacement = "\\\"";
+        break;
+      case '\\':  // Backslash *must* be escaped
+        replacement = "\\\\";
+        break;
+      case '\b':  // Escape backspace to increase readability
+        replacement = "\\b";
+        break;
+      case '\f':  // Escape form feed to increase readability
+        replacement = "\\f";
+        break;
+      case '\n':  // Escape line feed to increase readability
+        replacement = "\\n";
+        break;
+      case '\r':  // Escape carriage return to increase readability
+        replacement = "\\r";
+        break;
+      case '\t':  // Escape horizontal tab to increase readability
+        replacement = "\\t";
+        break;
+      case '\v':  // Escape vertical tab to increase readability
+        replacement = "\\v";
+        break;
+      default:
+        continue;
+    }
+    appendUtf8(output, QStringView(string).mid(begin, i - begin));
+    output += replacement;
+    begin = i + 1;
   }
-  return escaped;
+  appendUtf8(output, QStringView(string).mid(begin));
 }
 
 bool SExpression::isValidToken(const QString& token, Mode mode) noexcept {
@@ -354,20 +389,32 @@ bool SExpression::isValidTokenChar(const QChar& c, Mode mode) noexcept {
        (!c.isSpace()));
 }
 
-QString SExpression::toString(int indent, Mode mode) const {
+bool SExpression::isValidTokenChar(char c, Mode mode) noexcept {
+  // Note: Bytes of multibyte UTF-8 characters are >= 0x80, thus only valid in
+  // permissive mode.
+  return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+      ((c >= '0') && (c <= '9')) || (c == '\\') || (c == '.') || (c == ':') ||
+      (c == '_') || (c == '-') ||
+      ((mode == Mode::Permissive) && (c != '(') && (c != ')') && (c != ' ') &&
+       (c != '\f') && (c != '\n') && (c != '\r') && (c != '\t') &&
+       (c != '\v'));
+}
+
+void SExpression::write(QByteArray& output, int indent, Mode mode) const {
   if (mType == Type::List) {
     if (!isValidToken(mValue, mode)) {
       throw LogicError(
           __FILE__, __LINE__,
           QString("Invalid S-Expression list name: %1").arg(mValue));
     }
-    QString str = '(' + mValue;
+    output += '(';
+    appendUtf8(output, mValue);
     bool lastCharIsSpace = false;
     const std::size_t lastIndex = mChildren.size() - 1;
     for (std::size_t i = 0; i < mChildren.size(); ++i) {
       const SExpression& child = *mChildren.at(i);
       if ((!lastCharIsSpace) && (!child.isLineBreak())) {
-        str += ' ';
+        output += ' ';
       }
       const bool nextChildIsLineBreak =
           (i < lastIndex) && mChildren.at(i + 1)->isLineBreak();
@@ -377,19 +424,22 @@ QString SExpression::toString(int indent, Mode mode) const {
       if (lastCharIsSpace && (i == lastIndex)) {
         --currentIndent;
       }
-      str += child.toString(currentIndent, mode);
+      child.write(output, currentIndent, mode);
     }
-    return str + ')';
+    output += ')';
   } else if (mType == Type::Token) {
     if (!isValidToken(mValue, mode)) {
       throw LogicError(__FILE__, __LINE__,
                        QString("Invalid S-Expression token: %1").arg(mValue));
     }
-    return mValue;
+    appendUtf8(output, mValue);
   } else if (mType == Type::String) {
-    return '"' + escapeString(mValue) + '"';
+    output += '"';
+    appendEscaped(output, mValue);
+    output += '"';
   } else if (mType == Type::LineBreak) {
-    return '\n' + QString(' ').repeated(indent);
+    output += '\n';
+    output.append(indent, ' ');
   } else {
     throw LogicError(__FILE__, __LINE__);
   }
@@ -416,19 +466,80 @@ std::unique_ptr<SExpression> SExpression::createLineBreak() {
       new SExpression(Type::LineBreak, QString()));
 }
 
-std::unique_ptr<SExpression> SExpression::parse(const QByteArray& content,
-                                                const FilePath& filePath,
-                                                Mode mode) {
-  int index = 0;
-  QString contentStr = QString::fromUtf8(content);
-  skipWhitespaceAndComments(contentStr, index, true);  // Skip newlines as well.
-  if (index >= contentStr.length()) {
+std::unique_ptr<SExpression> SExpression::parse(
+    const QByteArray& content, const FilePath& filePath, Mode mode,
+    const QSet<QString>& skippedLists) {
+  // Note: The parser works directly on the UTF-8 encoded bytes, only the
+  // values of the nodes get decoded. All syntax characters are ASCII, so they
+  // cannot occur within multibyte characters. It is not implemented
+  // recursively to avoid stack overflows with deeply nested input.
+  const char* pos = content.constData();
+  const char* const end = pos + content.size();
+  skipWhitespaceAndComments(pos, end, true);  // Skip newlines as well.
+  if (pos >= end) {
     throw FileParseError(__FILE__, __LINE__, filePath, QString(),
                          "No S-Expression node found.");
   }
-  std::unique_ptr<SExpression> root = parse(contentStr, index, filePath, mode);
-  skipWhitespaceAndComments(contentStr, index, true);  // Skip newlines as well.
-  if (index < contentStr.length()) {
+
+  // All nodes share the same file path object, and list names are interned
+  // since there are typically only a few different names, but many lists.
+  const auto sharedFilePath = std::make_shared<const FilePath>(filePath);
+  QHash<QByteArrayView, QString> listNames;
+
+  std::unique_ptr<SExpression> root;
+  std::vector<SExpression*> openLists;
+  do {
+    if (!openLists.empty()) {
+      if (pos >= end) {
+        throw FileParseError(__FILE__, __LINE__, filePath, QString(),
+                             "S-Expression node ended without closing ')'.");
+      } else if (*pos == ')') {
+        ++pos;  // consume the ')'
+        skipWhitespaceAndComments(pos, end);  // consume following spaces
+        openLists.pop_back();
+        continue;
+      }
+    }
+
+    std::unique_ptr<SExpression> node;
+    if (*pos == '\n') {
+      ++pos;  // consume the '\n'
+      skipWhitespaceAndComments(pos, end);  // consume following spaces
+      node = createLineBreak();
+    } else if (*pos == '(') {
+      ++pos;  // consume the '('
+      const QByteArrayView name = parseToken(pos, end, filePath, mode);
+      auto it = listNames.constFind(name);
+      if (it == listNames.constEnd()) {
+        it = listNames.insert(name, QString::fromUtf8(name));
+      }
+      if ((mode == Mode::LibrePCB) && (openLists.size() == 1) &&
+          skippedLists.contains(*it)) {
+        skipList(pos, end, filePath);
+        continue;
+      }
+      node = createList(*it);
+    } else if (*pos == '"') {
+      node = createString(parseString(pos, end, filePath));
+    } else {
+      node = createToken(
+          QString::fromUtf8(parseToken(pos, end, filePath, mode)));
+    }
+    node->mFilePath = sharedFilePath;
+
+    SExpression* nodePtr = node.get();
+    if (openLists.empty()) {
+      root = std::move(node);
+    } else {
+      openLists.back()->mChildren.emplace_back(std::move(node));
+    }
+    if (nodePtr->isList()) {
+      openLists.push_back(nodePtr);
+    }
+  } while (!openLists.empty());
+
+  skipWhitespaceAndComments(pos, end, true);  // Skip newlines as well.
+  if (pos < end) {
     throw FileParseError(__FILE__, __LINE__, filePath, QString(),
                          "File contains more than one root node.");
   }
@@ -439,19 +550,6 @@ std::unique_ptr<SExpression> SExpression::parse(const QByteArray& content,
  *  Private Methods
  ******************************************************************************/
 
-bool SExpression::isMultiLine() const noexcept {
-  if (isLineBreak()) {
-    return true;
-  } else if (isList()) {
-    for (const auto& child : mChildren) {
-      if (child->isMultiLine()) {
-        return true;
-      }
-    }
-  }
-  return false;
-}
-
 bool SExpression::skipLineBreaks(
     const std::vector<std::unique_ptr<SExpression> >& children,
     int& index) noexcept {
@@ -465,145 +563,170 @@ bool SExpression::skipLineBreaks(
   return false;
 }
 
-std::unique_ptr<SExpression> SExpression::parse(const QString& content,
-                                                int& index,
-                                                const FilePath& filePath,
-                                                Mode mode) {
-  Q_ASSERT(index < content.length());
-
-  if (content.at(index) == '\n') {
-    ++index;  // consume the '\n'
-    skipWhitespaceAndComments(content, index);  // consume following spaces
-    return createLineBreak();
-  } else if (content.at(index) == '(') {
-    return parseList(content, index, filePath, mode);
-  } else if (content.at(index) == '"') {
-    return createString(parseString(content, index, filePath));
-  } else {
-    return createToken(parseToken(content, index, filePath, mode));
-  }
-}
-
-std::unique_ptr<SExpression> SExpression::parseList(const QString& content,
-                                                    int& index,
-                                                    const FilePath& filePath,
-                                                    Mode mode) {
-  Q_ASSERT((index < content.length()) && (content.at(index) == '('));
-
-  ++index;  // consume the '('
-
-  std::unique_ptr<SExpression> list =
-      createList(parseToken(content, index, filePath, mode));
-
-  while (true) {
-    if (index >= content.length()) {
-      throw FileParseError(__FILE__, __LINE__, filePath, QString(),
-                           "S-Expression node ended without closing ')'.");
-    }
-    if (content.at(index) == ')') {
-      ++index;  // consume the ')'
-      skipWhitespaceAndComments(content, index);  // consume following spaces
+QByteArrayView SExpression::parseToken(const char*& pos, const char* end,
+                                      const FilePath& filePath, Mode mode) {
+  const char* const begin = pos;
+  while ((pos < end) && isValidTokenChar(*pos, mode)) {
+    // Like QChar::isSpace(), stop at non-ASCII whitespace (e.g. U+00A0) too.
+    if ((static_cast<uchar>(*pos) >= 0xC0) && isNonAsciiSpace(pos, end)) {
       break;
-    } else {
-      list->mChildren.emplace_back(parse(content, index, filePath, mode));
     }
+    ++pos;
   }
-
-  return list;
-}
-
-QString SExpression::parseToken(const QString& content, int& index,
-                                const FilePath& filePath, Mode mode) {
-  int oldIndex = index;
-  while ((index < content.length()) &&
-         (isValidTokenChar(content.at(index), mode))) {
-    ++index;
-  }
-  QString token = content.mid(oldIndex, index - oldIndex);
+  const QByteArrayView token(begin, pos - begin);
   if (token.isEmpty()) {
-    throw FileParseError(
-        __FILE__, __LINE__, filePath, QString(),
-        QString("Invalid token character detected: '%1'")
-            .arg(index < content.length() ? content.at(index) : QChar()));
+    throw FileParseError(__FILE__, __LINE__, filePath, QString(),
+                         QString("Invalid token character detected: '%1'")
+                             .arg(decodeChar(pos, end)));
   }
-  skipWhitespaceAndComments(content, index);  // consume following spaces
+  skipWhitespaceAndComments(pos, end);  // consume following spaces
   return token;
 }
 
-QString SExpression::parseString(const QString& content, int& index,
+QString SExpression::parseString(const char*& pos, const char* end,
                                  const FilePath& filePath) {
-  ++index;  // consume the '"'
+  ++pos;  // consume the '"'
 
   // Note: Until LibrePCB 0.1.5 we used the sexpresso library for escaping
   // strings. This library escaped more characters than we do now. To still
   // support reading the file format 0.1, we have to keep support for the
   // old escaping behavior.
-  static QHash<QChar, QChar> escapedChars = {
-      {'\'', '\''},  // Single quote
-      {'"', '"'},  // Double quote
-      {'?', '\?'},  // Question mark
-      {'\\', '\\'},  // Backslash
-      {'a', '\a'},  // Audible bell
-      {'b', '\b'},  // Backspace
-      {'f', '\f'},  // Form feed
-      {'n', '\n'},  // Line feed
-      {'r', '\r'},  // Carriage return
-      {'t', '\t'},  // Horizontal tab
-      {'v', '\v'},  // Vertical tab
+  auto unescape = [](char c) -> char {
+    switch (c) {
+      case '\'':  // Single quote
+      case '"':  // Double quote
+      case '?':  // Question mark
+      case '\\':  // Backslash
+        return c;
+      case 'a':  // Audible bell
+        return '\a';
+      case 'b':  // Backspace
+        return '\b';
+      case 'f':  // Form feed
+        return '\f';
+      case 'n':  // Line feed
+        return '\n';
+      case 'r':  // Carriage return
+        return '\r';
+      case 't':  // Horizontal tab
+        return '\t';
+      case 'v':  // Vertical tab
+        return '\v';
+      default:
+        return '\0';
+    }
   };
 
-  QString string;
-  bool escaped = false;
+  // Most strings contain no escape sequences, so they can be decoded directly
+  // from the input buffer. Only strings with escape sequences are copied.
+  const char* begin = pos;
+  QByteArray unescaped;
+  bool hasEscapeSequences = false;
   while (true) {
-    if (index >= content.length()) {
+    if (pos >= end) {
       throw FileParseError(__FILE__, __LINE__, filePath, QString(),
                            "String ended without quote.");
     }
-    const QChar& c = content.at(index);
-    if (escaped) {
-      if (escapedChars.contains(c)) {
-        string += escapedChars[c];
-        ++index;
-        escaped = false;
+    const char c = *pos;
+    if (c == '"') {
+      QString string;
+      if (hasEscapeSequences) {
+        unescaped.append(begin, pos - begin);
+        string = QString::fromUtf8(unescaped);
       } else {
-        throw FileParseError(__FILE__, __LINE__, filePath, QString(),
-                             QString("Illegal escape sequence: '\\%1'").arg(c));
+        string = QString::fromUtf8(begin, pos - begin);
       }
-    } else if (c == '"') {
-      ++index;  // consume the '"'
-      skipWhitespaceAndComments(content, index);  // consume following spaces
-      break;
+      ++pos;  // consume the '"'
+      skipWhitespaceAndComments(pos, end);  // consume following spaces
+      return string;
     } else if (c == '\\') {
-      escaped = true;
-      ++index;
+      unescaped.append(begin, pos - begin);
+      hasEscapeSequences = true;
+      ++pos;  // consume the backslash
+      const char replacement = (pos < end) ? unescape(*pos) : '\0';
+      if (replacement != '\0') {
+        unescaped.append(replacement);
+        ++pos;
+      } else if (pos < end) {
+        throw FileParseError(__FILE__, __LINE__, filePath, QString(),
+                             QString("Illegal escape sequence: '\\%1'")
+                                 .arg(decodeChar(pos, end)));
+      }
+      begin = pos;
     } else {
-      string += c;
-      ++index;
+      ++pos;
     }
   }
-  return string;
 }
 
-void SExpression::skipWhitespaceAndComments(const QString& content, int& index,
-                                            bool skipNewline) {
-  static QSet<QChar> spaces = {' ', '\f', '\r', '\t', '\v'};
-
+void SExpression::skipWhitespaceAndComments(const char*& pos, const char* end,
+                                            bool skipNewline) noexcept {
   bool isComment = false;
-  while (index < content.length()) {
-    const QChar& c = content.at(index);
+  while (pos < end) {
+    const char c = *pos;
     if (c == ';') {  // Line-comment of the Lisp language
       isComment = true;
     } else if (c == '\n') {
       isComment = false;
     }
-    if (isComment || ((skipNewline) && (c == '\n')) || spaces.contains(c)) {
-      ++index;
+    if (isComment || ((skipNewline) && (c == '\n')) || (c == ' ') ||
+        (c == '\f') || (c == '\r') || (c == '\t') || (c == '\v')) {
+      ++pos;
     } else {
       break;
     }
   }
 }
 
+void SExpression::skipList(const char*& pos, const char* end,
+                           const FilePath& filePath) {
+  // Skip the content of a list whose opening parenthesis and name have
+  // already been consumed. Only strings and comments need special care, as
+  // they may contain parentheses.
+  int depth = 1;
+  while (pos < end) {
+    const char c = *pos;
+    ++pos;
+    if (c == '"') {
+      while ((pos < end) && (*pos != '"')) {
+        if ((*pos == '\\') && ((end - pos) > 1)) {
+          ++pos;  // consume the escape character
+        }
+        ++pos;
+      }
+      if (pos < end) {
+        ++pos;  // consume the closing '"'
+      }
+    } else if (c == ';') {
+      while ((pos < end) && (*pos != '\n')) {
+        ++pos;
+      }
+    } else if (c == '(') {
+      ++depth;
+    } else if ((c == ')') && (--depth == 0)) {
+      skipWhitespaceAndComments(pos, end);  // consume following spaces
+      return;
+    }
+  }
+  throw FileParseError(__FILE__, __LINE__, filePath, QString(),
+                       "S-Expression node ended without closing ')'.");
+}
+
+QString SExpression::decodeChar(const char* pos, const char* end) noexcept {
+  // Decode a single (possibly multibyte) UTF-8 character for error messages.
+  int length = 0;
+  if (pos < end) {
+    const uchar c = static_cast<uchar>(*pos);
+    length = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+  }
+  return QString::fromUtf8(pos, std::min<qsizetype>(length, end - pos));
+}
+
+bool SExpression::isNonAsciiSpace(const char* pos, const char* end) noexcept {
+  const QString c = decodeChar(pos, end);
+  return (!c.isEmpty()) && c.at(0).isSpace();
+}
+
 /*******************************************************************************
  *  serialize() Specializations for C++/Qt Types
  ******************************************************************************/
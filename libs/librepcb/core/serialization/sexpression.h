@@ -89,7 +89,7 @@ public:
   ~SExpression() noexcept;
 
   // Getters
-  const FilePath& getFilePath() const noexcept { return mFilePath; }
+  const FilePath& getFilePath() const noexcept;
   Type getType() const noexcept { return mType; }
   bool isList() const noexcept { return mType == Type::List; }
   bool isToken() const noexcept { return mType == Type::Token; }
@@ -202,41 +202,54 @@ public:
   static std::unique_ptr<SExpression> createToken(const QString& token);
   static std::unique_ptr<SExpression> createString(const QString& string);
   static std::unique_ptr<SExpression> createLineBreak();
-  static std::unique_ptr<SExpression> parse(const QByteArray& content,
-                                            const FilePath& filePath,
-                                            Mode mode = Mode::LibrePCB);
+
+  /**
+   * @brief Parse a S-Expression from a byte array
+   *
+   * @param content       UTF-8 encoded content to parse.
+   * @param filePath      File path of the content, used for error messages.
+   * @param mode          Parser mode.
+   * @param skippedLists  Names of lists within the root node to skip. They
+   *                      are not added to the returned node at all, and their
+   *                      content is only scanned for the closing parenthesis.
+   *                      This allows to quickly load only some metadata of
+   *                      large files. Ignored in permissive mode.
+   *
+   * @return The root node.
+   */
+  static std::unique_ptr<SExpression> parse(
+      const QByteArray& content, const FilePath& filePath,
+      Mode mode = Mode::LibrePCB, const QSet<QString>& skippedLists = {});
 
 private:  // Methods
   SExpression(Type type, const QString& value);
 
-  bool isMultiLine() const noexcept;
   static bool skipLineBreaks(
       const std::vector<std::unique_ptr<SExpression>>& children,
       int& index) noexcept;
-  static std::unique_ptr<SExpression> parse(const QString& content, int& index,
-                                            const FilePath& filePath,
-                                            Mode mode);
-  static std::unique_ptr<SExpression> parseList(const QString& content,
-                                                int& index,
-                                                const FilePath& filePath,
-                                                Mode mode);
-  static QString parseToken(const QString& content, int& index,
-                            const FilePath& filePath, Mode mode);
-  static QString parseString(const QString& content, int& index,
+  static QByteArrayView parseToken(const char*& pos, const char* end,
+                                   const FilePath& filePath, Mode mode);
+  static QString parseString(const char*& pos, const char* end,
                              const FilePath& filePath);
-  static void skipWhitespaceAndComments(const QString& content, int& index,
-                                        bool skipNewline = false);
-  static QString escapeString(const QString& string) noexcept;
+  static void skipWhitespaceAndComments(const char*& pos, const char* end,
+                                        bool skipNewline = false) noexcept;
+  static void skipList(const char*& pos, const char* end,
+                       const FilePath& filePath);
+  static QString decodeChar(const char* pos, const char* end) noexcept;
+  static bool isNonAsciiSpace(const char* pos, const char* end) noexcept;
+  static void appendUtf8(QByteArray& output, QStringView string) noexcept;
+  static void appendEscaped(QByteArray& output, const QString& string) noexcept;
   static bool isValidToken(const QString& token, Mode mode) noexcept;
   static bool isValidTokenChar(const QChar& c, Mode mode) noexcept;
-  QString toString(int indent, Mode mode) const;
+  static bool isValidTokenChar(char c, Mode mode) noexcept;
+  void write(QByteArray& output, int indent, Mode mode) const;
 
 private:  // Data
   Type mType;
   QString mValue;  ///< either a list name, a token or a string
   // Note: For memory-safe removal operations we don't use a Qt container class!
   std::vector<std::unique_ptr<SExpression>> mChildren;
-  FilePath mFilePath;
+  std::shared_ptr<const FilePath> mFilePath;  ///< Shared by the whole document
 
   // qHash() needs access to mChildrenNew.
   friend uint qHash(const SExpression& node, uint seed) noexcept;
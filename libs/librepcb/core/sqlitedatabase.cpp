@@ -93,6 +93,7 @@ SQLiteDatabase::SQLiteDatabase(const FilePath& filepath, QObject* parent)
 }
 
 SQLiteDatabase::~SQLiteDatabase() noexcept {
+  mQueryCache.clear();  // Queries must be released before closing.
   mDb.close();
 }
 
@@ -152,6 +153,52 @@ QSqlQuery SQLiteDatabase::prepareQuery(QString query,
   return q;
 }
 
+QSqlQuery& SQLiteDatabase::prepareCachedQuery(
+    QString query, const Replacements& replacements) {
+  for (auto it = replacements.begin(); it != replacements.end(); it++) {
+    query.replace(it->first, it->second);
+  }
+
+  auto it = mQueryCache.find(query);
+  if (it == mQueryCache.end()) {
+    it = mQueryCache.insert(
+        query, std::make_shared<QSqlQuery>(prepareQuery(query)));  // can throw
+  } else {
+    (*it)->finish();  // Reset the statement, but keep it prepared.
+  }
+  return **it;
+}
+
+void SQLiteDatabase::insertMultiple(const QString& table,
+                                    const QStringList& columns,
+                                    const QVector<QVariantList>& rows) {
+  if (columns.isEmpty()) {
+    throw LogicError(__FILE__, __LINE__, "No columns specified.");
+  }
+
+  // SQLite versions before 3.32.0 allow only 999 parameters per query.
+  const int rowsPerQuery = std::max(999 / int(columns.count()), 1);
+  const QString rowPlaceholders =
+      "(" % QStringList(columns.count(), "?").join(", ") % ")";
+  for (int start = 0; start < rows.count(); start += rowsPerQuery) {
+    const int count = std::min(rowsPerQuery, int(rows.count()) - start);
+    QSqlQuery& query = prepareCachedQuery(
+        "INSERT INTO " % table % " (" % columns.join(", ") % ") VALUES " %
+        QStringList(count, rowPlaceholders).join(", "));  // can throw
+    int index = 0;
+    for (int i = start; i < (start + count); ++i) {
+      const QVariantList& row = rows.at(i);
+      if (row.count() != columns.count()) {
+        throw LogicError(__FILE__, __LINE__, "Invalid number of values.");
+      }
+      for (const QVariant& value : row) {
+        query.bindValue(index++, value);
+      }
+    }
+    exec(query);  // can throw
+  }
+}
+
 int SQLiteDatabase::count(QSqlQuery& query) {
   exec(query);  // can throw
 
@@ -195,6 +242,38 @@ void SQLiteDatabase::exec(const QString& query) {
   exec(q);
 }
 
+void SQLiteDatabase::setSynchronousMode(SynchronousMode mode) {
+  switch (mode) {
+    case SynchronousMode::Off:
+      exec("PRAGMA synchronous = OFF");  // can throw
+      break;
+    case SynchronousMode::Normal:
+      exec("PRAGMA synchronous = NORMAL");  // can throw
+      break;
+    case SynchronousMode::Full:
+      exec("PRAGMA synchronous = FULL");  // can throw
+      break;
+    default:
+      throw LogicError(__FILE__, __LINE__);
+  }
+}
+
+void SQLiteDatabase::setCacheSize(int kibibytes) {
+  // Negative values are interpreted as KiB rather than number of pages.
+  exec("PRAGMA cache_size = " % QString::number(-kibibytes));  // can throw
+}
+
+bool SQLiteDatabase::isFullTextSearchSupported() const noexcept {
+  // Just try to create a temporary table, this also covers the SQLite version.
+  QSqlQuery query(mDb);
+  if (!query.exec("CREATE VIRTUAL TABLE temp.fts_check "
+                  "USING fts5(value, tokenize='trigram')")) {
+    return false;
+  }
+  query.exec("DROP TABLE temp.fts_check");
+  return true;
+}
+
 /*******************************************************************************
  *  Private Methods
  ******************************************************************************/
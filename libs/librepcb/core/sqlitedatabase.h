@@ -28,6 +28,8 @@
 #include <QtCore>
 #include <QtSql>
 
+#include <memory>
+
 /*******************************************************************************
  *  Namespace / Forward Declarations
  ******************************************************************************/
@@ -46,6 +48,7 @@ class SQLiteDatabase final : public QObject {
 public:
   // Types
   typedef QVector<std::pair<QString, QString>> Replacements;
+  enum class SynchronousMode { Off, Normal, Full };
   class TransactionScopeGuard final {
   public:
     TransactionScopeGuard() = delete;
@@ -75,11 +78,74 @@ public:
   // General Methods
   QSqlQuery prepareQuery(QString query,
                          const Replacements& replacements = {}) const;
+
+  /**
+   * @brief Get a prepared query from the statement cache
+   *
+   * Same as #prepareQuery(), but the query is prepared only the first time
+   * and then kept for subsequent calls with the same query (after applying
+   * the replacements), so SQLite doesn't need to compile it again. Use this
+   * for queries executed many times, e.g. inserts during a library scan.
+   *
+   * @attention The returned query is shared between all callers and its
+   *            previous result is discarded on every call, so it must not be
+   *            used anymore after calling this method again with the same
+   *            query. It is valid until the database object is destroyed.
+   *
+   * @param query         The SQL query.
+   * @param replacements  Placeholders to be replaced in the query.
+   *
+   * @return The prepared query.
+   */
+  QSqlQuery& prepareCachedQuery(QString query,
+                                const Replacements& replacements = {});
+
+  /**
+   * @brief Insert multiple rows into a table with as few queries as possible
+   *
+   * Builds multi-row `INSERT INTO ... VALUES (...), (...), ...` statements
+   * (taken from the statement cache) instead of executing one query per row.
+   *
+   * @param table     Table name.
+   * @param columns   Column names.
+   * @param rows      Values to insert, each with the same size as `columns`.
+   */
+  void insertMultiple(const QString& table, const QStringList& columns,
+                      const QVector<QVariantList>& rows);
   int count(QSqlQuery& query);
   int insert(QSqlQuery& query);
   void exec(QSqlQuery& query);
   void exec(const QString& query);
 
+  /**
+   * @brief Set how often SQLite syncs written data to disk
+   *
+   * @param mode  The new synchronous mode of this connection.
+   *
+   * @see https://sqlite.org/pragma.html#pragma_synchronous
+   */
+  void setSynchronousMode(SynchronousMode mode);
+
+  /**
+   * @brief Set the maximum size of the page cache of this connection
+   *
+   * @param kibibytes   Maximum cache size in KiB.
+   *
+   * @see https://sqlite.org/pragma.html#pragma_cache_size
+   */
+  void setCacheSize(int kibibytes);
+
+  /**
+   * @brief Check whether FTS5 full-text search with trigrams is available
+   *
+   * The trigram tokenizer requires SQLite 3.34.0 or later and FTS5 being
+   * compiled in, which is not the case for every system SQLite library.
+   *
+   * @return True if `fts5` virtual tables with `tokenize='trigram'` can be
+   *         created, false otherwise.
+   */
+  bool isFullTextSearchSupported() const noexcept;
+
   // Operator Overloadings
   SQLiteDatabase& operator=(const SQLiteDatabase& rhs) = delete;
 
@@ -106,6 +172,7 @@ private:  // Methods
 
 private:  // Data
   QSqlDatabase mDb;
+  QHash<QString, std::shared_ptr<QSqlQuery>> mQueryCache;
 };
 
 /*******************************************************************************
@@ -29,6 +29,9 @@
  ******************************************************************************/
 namespace librepcb {
 
+// Counter for profiling, see getOperationCount().
+static thread_local quint64 sOperationCount = 0;
+
 /*******************************************************************************
  *  General Methods
  ******************************************************************************/
@@ -88,6 +91,7 @@ void ClipperHelpers::unite(ClipperLib::Paths& paths,
   try {
     ClipperLib::Clipper c;
     c.AddPaths(paths, ClipperLib::ptSubject, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctUnion, paths, fillType, ClipperLib::pftEvenOdd);
   } catch (const std::exception& e) {
     throw LogicError(__FILE__, __LINE__,
@@ -103,6 +107,7 @@ void ClipperHelpers::unite(ClipperLib::Paths& subject,
     ClipperLib::Clipper c;
     c.AddPaths(subject, ClipperLib::ptSubject, true);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctUnion, subject, subjectFillType, clipFillType);
   } catch (const std::exception& e) {
     throw LogicError(__FILE__, __LINE__,
@@ -118,6 +123,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::uniteToTree(
     std::unique_ptr<ClipperLib::PolyTree> result(new ClipperLib::PolyTree());
     ClipperLib::Clipper c;
     c.AddPaths(paths, ClipperLib::ptSubject, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctUnion, *result, fillType, ClipperLib::pftEvenOdd);
     return result;
   } catch (const std::exception& e) {
@@ -137,6 +143,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::uniteToTree(
     ClipperLib::Clipper c;
     c.AddPaths(paths, ClipperLib::ptSubject, true);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctUnion, *result, subjectFillType, clipFillType);
     return result;
   } catch (const std::exception& e) {
@@ -153,6 +160,7 @@ void ClipperHelpers::intersect(ClipperLib::Paths& subject,
     ClipperLib::Clipper c;
     c.AddPaths(subject, ClipperLib::ptSubject, true);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctIntersection, subject, subjectFillType,
               clipFillType);
   } catch (const std::exception& e) {
@@ -172,6 +180,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::intersectToTree(
     ClipperLib::Clipper c;
     c.AddPaths(subject, ClipperLib::ptSubject, closed);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctIntersection, *result, subjectFillType,
               clipFillType);
     return result;
@@ -204,6 +213,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::intersectToTree(
         c.AddPaths(intermediateSubject, ClipperLib::ptSubject, true);
       }
       c.AddPaths(paths.at(i), ClipperLib::ptClip, true);
+      ++sOperationCount;
       c.Execute(ClipperLib::ctIntersection, *result, ClipperLib::pftEvenOdd,
                 ClipperLib::pftEvenOdd);
     }
@@ -222,6 +232,7 @@ void ClipperHelpers::subtract(ClipperLib::Paths& subject,
     ClipperLib::Clipper c;
     c.AddPaths(subject, ClipperLib::ptSubject, true);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctDifference, subject, subjectFillType, clipFillType);
   } catch (const std::exception& e) {
     throw LogicError(__FILE__, __LINE__,
@@ -240,6 +251,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::subtractToTree(
     ClipperLib::Clipper c;
     c.AddPaths(subject, ClipperLib::ptSubject, closed);
     c.AddPaths(clip, ClipperLib::ptClip, true);
+    ++sOperationCount;
     c.Execute(ClipperLib::ctDifference, *result, subjectFillType, clipFillType);
     return result;
   } catch (const std::exception& e) {
@@ -254,6 +266,7 @@ void ClipperHelpers::offset(ClipperLib::Paths& paths, const Length& offset,
   try {
     ClipperLib::ClipperOffset o(2.0, maxArcTolerance->toNm());
     o.AddPaths(paths, joinType, ClipperLib::etClosedPolygon);
+    ++sOperationCount;
     o.Execute(paths, offset.toNm());
   } catch (const std::exception& e) {
     throw LogicError(__FILE__, __LINE__,
@@ -270,6 +283,7 @@ std::unique_ptr<ClipperLib::PolyTree> ClipperHelpers::offsetToTree(
     std::unique_ptr<ClipperLib::PolyTree> result(new ClipperLib::PolyTree());
     ClipperLib::ClipperOffset o(2.0, maxArcTolerance->toNm());
     o.AddPaths(paths, ClipperLib::jtRound, ClipperLib::etClosedPolygon);
+    ++sOperationCount;
     o.Execute(*result, offset.toNm());
     return result;
   } catch (const std::exception& e) {
@@ -311,6 +325,25 @@ ClipperLib::Paths ClipperHelpers::flattenTree(
   return paths;
 }
 
+std::size_t ClipperHelpers::hash(const ClipperLib::Paths& paths,
+                                 std::size_t seed) noexcept {
+  for (const ClipperLib::Path& path : paths) {
+    seed = qHash(path.size(), seed);
+    for (const ClipperLib::IntPoint& p : path) {
+      seed = qHashMulti(seed, p.X, p.Y);
+    }
+  }
+  return seed;
+}
+
+/*******************************************************************************
+ *  Statistics
+ ******************************************************************************/
+
+quint64 ClipperHelpers::getOperationCount() noexcept {
+  return sOperationCount;
+}
+
 /*******************************************************************************
  *  Conversion Methods
  ******************************************************************************/
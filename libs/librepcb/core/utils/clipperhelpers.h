@@ -96,6 +96,30 @@ public:
   static ClipperLib::Paths treeToPaths(const ClipperLib::PolyTree& tree);
   static ClipperLib::Paths flattenTree(const ClipperLib::PolyNode& node);
 
+  /**
+   * @brief Calculate a hash over all points of the given paths
+   *
+   * @param paths   The paths to hash.
+   * @param seed    Seed to combine the hash with.
+   *
+   * @return The calculated hash, e.g. to be used as a cache key.
+   */
+  static std::size_t hash(const ClipperLib::Paths& paths,
+                          std::size_t seed = 0) noexcept;
+
+  // Statistics
+
+  /**
+   * @brief Get the number of Clipper operations executed in the calling thread
+   *
+   * Every boolean or offset operation increments a thread-local counter, so
+   * the number of operations executed by a particular task can be determined
+   * by comparing the counter before and after executing it.
+   *
+   * @return Number of operations executed in the calling thread so far.
+   */
+  static quint64 getOperationCount() noexcept;
+
   // Type Conversions
   static const QVector<Path> convert(const ClipperLib::Paths& paths) noexcept;
   static Path convert(const ClipperLib::Path& path) noexcept;
@@ -22,6 +22,7 @@
  ******************************************************************************/
 #include "workspace.h"
 
+#include "../3d/tesselationcache.h"
 #include "../application.h"
 #include "../exceptions.h"
 #include "../fileio/filepath.h"
@@ -56,7 +57,8 @@ Workspace::Workspace(const FilePath& wsPath, const QString& dataDirName,
     mLibrariesPath(mDataPath.getPathTo("libraries")),
     mFileSystem(),
     mWorkspaceSettings(),
-    mLibraryDb() {
+    mLibraryDb(),
+    mTesselationCache() {
   qDebug().nospace() << "Open workspace data directory " << mDataPath.toNative()
                      << "...";
 
@@ -125,6 +127,10 @@ Workspace::Workspace(const FilePath& wsPath, const QString& dataDirName,
   FileUtils::makePath(mLibrariesPath);  // can throw
   mLibraryDb.reset(new WorkspaceLibraryDb(mLibrariesPath));  // can throw
 
+  // Initialize 3D model cache (directory is created on demand).
+  mTesselationCache.reset(
+      new TesselationCache(mDataPath.getPathTo("cache/tesselation")));
+
   // Done!
   qDebug("Successfully opened workspace.");
 }
@@ -36,6 +36,7 @@
 namespace librepcb {
 
 class Project;
+class TesselationCache;
 class TransactionalFileSystem;
 class WorkspaceLibraryDb;
 class WorkspaceSettings;
@@ -130,6 +131,11 @@ public:
    */
   WorkspaceLibraryDb& getLibraryDb() const { return *mLibraryDb; }
 
+  /**
+   * @brief Get the cache for tesselated 3D models
+   */
+  TesselationCache& getTesselationCache() const { return *mTesselationCache; }
+
   // General Methods
 
   /**
@@ -245,6 +251,9 @@ private:  // Data
 
   /// the library database
   QScopedPointer<WorkspaceLibraryDb> mLibraryDb;
+
+  /// the cache for tesselated 3D models (stored in "data/cache")
+  QScopedPointer<TesselationCache> mTesselationCache;
 };
 
 /*******************************************************************************
@@ -61,7 +61,8 @@ WorkspaceLibraryDb::WorkspaceLibraryDb(const FilePath& librariesPath)
   : QObject(nullptr),
     mLibrariesPath(librariesPath),
     mFilePath(mLibrariesPath.getPathTo(
-        QString("cache_v%1.sqlite").arg(sCurrentDbVersion))) {
+        QString("cache_v%1.sqlite").arg(sCurrentDbVersion))),
+    mFullTextSearch(false) {
   qDebug("Load workspace library database...");
 
   // open SQLite database
@@ -75,7 +76,15 @@ WorkspaceLibraryDb::WorkspaceLibraryDb(const FilePath& librariesPath)
     qWarning() << "Library database version" << dbVersion
                << "is outdated or not supported, reinitializing...";
     reset();  // can throw
+  } else if (hasFullTextIndex() != mDb->isFullTextSearchSupported()) {
+    // The database might have been created by a different SQLite library.
+    qWarning() << "Library database full-text search support has changed, "
+                  "reinitializing...";
+    reset();  // can throw
   }
+  mFullTextSearch = hasFullTextIndex();
+  qDebug() << "Library database full-text search available:"
+           << mFullTextSearch;
 
   // create library scanner object
   mLibraryScanner.reset(new WorkspaceLibraryScanner(mLibrariesPath, mFilePath));
@@ -127,6 +136,43 @@ template QList<Uuid> WorkspaceLibraryDb::find<Device>(
 template <>
 QList<Uuid> WorkspaceLibraryDb::find<Package>(const QString& keyword) const {
   // ATTENTION: Keep SQL in sync with the generic find() method below!
+  const QString match = mFullTextSearch ? toFullTextQuery(keyword) : QString();
+  if (!match.isEmpty()) {
+    QSqlQuery query = mDb->prepareQuery(
+        "SELECT uuid FROM ("
+        "SELECT packages.uuid AS uuid, 0 AS uuid_match, "
+        "packages_tr_fts.rank AS rank, packages_tr.name AS name "
+        "FROM packages_tr_fts "
+        "INNER JOIN packages_tr "
+        "ON packages_tr.id = packages_tr_fts.rowid "
+        "INNER JOIN packages "
+        "ON packages.id = packages_tr.element_id "
+        "WHERE packages_tr_fts MATCH :match "
+        "UNION ALL "
+        "SELECT packages.uuid, 0, packages_alt_fts.rank, NULL "
+        "FROM packages_alt_fts "
+        "INNER JOIN packages_alt "
+        "ON packages_alt.id = packages_alt_fts.rowid "
+        "INNER JOIN packages "
+        "ON packages.id = packages_alt.package_id "
+        "WHERE packages_alt_fts MATCH :match "
+        "UNION ALL "
+        "SELECT uuid, 1, NULL, NULL FROM packages "
+        "WHERE uuid = :keyword"
+        ") "
+        "GROUP BY uuid "
+        "ORDER BY MAX(uuid_match) DESC, MIN(rank) ASC, MIN(name) ASC");
+    query.bindValue(":keyword", keyword);
+    query.bindValue(":match", match);
+    mDb->exec(query);
+
+    QList<Uuid> uuids;
+    while (query.next()) {
+      uuids.append(Uuid::fromString(query.value(0).toString()));  // can throw
+    }
+    return uuids;
+  }
+
   QSqlQuery query = mDb->prepareQuery(
       "SELECT packages.uuid FROM packages "
       "LEFT JOIN packages_tr "
@@ -152,17 +198,31 @@ QList<Uuid> WorkspaceLibraryDb::find<Package>(const QString& keyword) const {
 
 QList<Uuid> WorkspaceLibraryDb::findDevicesOfParts(
     const QString& keyword) const {
-  QSqlQuery query = mDb->prepareQuery(
-      "SELECT devices.uuid FROM devices "
-      "LEFT JOIN parts "
-      "ON devices.id = parts.device_id "
-      "LEFT JOIN devices_tr "
-      "ON devices.id = devices_tr.element_id "
-      "WHERE parts.manufacturer LIKE :keyword "
-      "OR parts.mpn LIKE :keyword "
-      "GROUP BY devices.uuid "
-      "ORDER BY devices_tr.name ASC");
-  query.bindValue(":keyword", "%" + keyword + "%");
+  const QString match = mFullTextSearch ? toFullTextQuery(keyword) : QString();
+  QSqlQuery query = match.isEmpty()
+      ? mDb->prepareQuery(
+            "SELECT devices.uuid FROM devices "
+            "LEFT JOIN parts "
+            "ON devices.id = parts.device_id "
+            "LEFT JOIN devices_tr "
+            "ON devices.id = devices_tr.element_id "
+            "WHERE parts.manufacturer LIKE :keyword "
+            "OR parts.mpn LIKE :keyword "
+            "GROUP BY devices.uuid "
+            "ORDER BY devices_tr.name ASC")
+      : mDb->prepareQuery(
+            "SELECT devices.uuid FROM parts_fts "
+            "INNER JOIN parts "
+            "ON parts.id = parts_fts.rowid "
+            "INNER JOIN devices "
+            "ON devices.id = parts.device_id "
+            "LEFT JOIN devices_tr "
+            "ON devices.id = devices_tr.element_id "
+            "WHERE parts_fts MATCH :keyword "
+            "GROUP BY devices.uuid "
+            "ORDER BY MIN(parts_fts.rank) ASC, MIN(devices_tr.name) ASC");
+  query.bindValue(":keyword",
+                  match.isEmpty() ? QString("%" + keyword + "%") : match);
   mDb->exec(query);
 
   QList<Uuid> uuids;
@@ -393,6 +453,10 @@ QList<WorkspaceLibraryDb::Organization>
  *  General Methods
  ******************************************************************************/
 
+void WorkspaceLibraryDb::setScanThreadCount(int count) noexcept {
+  mLibraryScanner->setThreadCount(count);
+}
+
 void WorkspaceLibraryDb::resetAndRescan() noexcept {
   try {
     reset();  // can throw
@@ -421,6 +485,7 @@ void WorkspaceLibraryDb::reset() {
   WorkspaceLibraryDbWriter writer(mLibrariesPath, *mDb);
   writer.createAllTables();  // can throw
   writer.addInternalData("version", sCurrentDbVersion);  // can throw
+  mFullTextSearch = hasFullTextIndex();
 }
 
 QMultiMap<Version, FilePath> WorkspaceLibraryDb::getAll(
@@ -509,6 +574,38 @@ FilePath WorkspaceLibraryDb::getLatestVersionFilePath(
 QList<Uuid> WorkspaceLibraryDb::find(const QString& elementsTable,
                                      const QString& keyword) const {
   // ATTENTION: Keep SQL in sync with the find<Package>() method above!
+  const QString match = mFullTextSearch ? toFullTextQuery(keyword) : QString();
+  if (!match.isEmpty()) {
+    QSqlQuery query = mDb->prepareQuery(
+        "SELECT uuid FROM ("
+        "SELECT %elements.uuid AS uuid, 0 AS uuid_match, "
+        "%elements_tr_fts.rank AS rank, %elements_tr.name AS name "
+        "FROM %elements_tr_fts "
+        "INNER JOIN %elements_tr "
+        "ON %elements_tr.id = %elements_tr_fts.rowid "
+        "INNER JOIN %elements "
+        "ON %elements.id = %elements_tr.element_id "
+        "WHERE %elements_tr_fts MATCH :match "
+        "UNION ALL "
+        "SELECT uuid, 1, NULL, NULL FROM %elements "
+        "WHERE uuid = :keyword"
+        ") "
+        "GROUP BY uuid "
+        "ORDER BY MAX(uuid_match) DESC, MIN(rank) ASC, MIN(name) ASC",
+        {
+            {"%elements", elementsTable},
+        });
+    query.bindValue(":keyword", keyword);
+    query.bindValue(":match", match);
+    mDb->exec(query);
+
+    QList<Uuid> uuids;
+    while (query.next()) {
+      uuids.append(Uuid::fromString(query.value(0).toString()));  // can throw
+    }
+    return uuids;
+  }
+
   QSqlQuery query = mDb->prepareQuery(
       "SELECT %elements.uuid FROM %elements "
       "LEFT JOIN %elements_tr "
@@ -796,6 +893,31 @@ int WorkspaceLibraryDb::getDbVersion() const noexcept {
   }
 }
 
+bool WorkspaceLibraryDb::hasFullTextIndex() const noexcept {
+  try {
+    QSqlQuery query = mDb->prepareQuery(
+        "SELECT COUNT(*) FROM sqlite_master "
+        "WHERE type = 'table' AND name = 'parts_fts'");
+    return mDb->count(query) > 0;
+  } catch (const Exception& e) {
+    return false;
+  }
+}
+
+QString WorkspaceLibraryDb::toFullTextQuery(const QString& keyword) noexcept {
+  // The trigram tokenizer cannot match less than 3 characters, thus the
+  // caller needs to fall back to a LIKE query in that case.
+  if (keyword.toUcs4().count() < 3) {
+    return QString();
+  }
+
+  // Quote the keyword to get a plain substring match, without interpreting
+  // any FTS5 query syntax like "AND", "OR", "*" or column filters.
+  QString escaped = keyword;
+  escaped.replace("\"", "\"\"");
+  return "\"" % escaped % "\"";
+}
+
 template <typename ElementType>
 QString WorkspaceLibraryDb::getTable() noexcept {
   return WorkspaceLibraryDbWriter::getElementTable<ElementType>();
@@ -162,6 +162,14 @@ public:
    */
   const FilePath& getFilePath() const noexcept { return mFilePath; }
 
+  /**
+   * @brief Check if the full-text search index is available
+   *
+   * @return Whether searches are served by FTS5 trigram indices (if false,
+   *         the slower substring search over all rows is used instead).
+   */
+  bool isFullTextSearchAvailable() const noexcept { return mFullTextSearch; }
+
   /**
    * @brief Check if there is currently a library scan in progress
    *
@@ -230,8 +238,10 @@ public:
    * @param keyword   Keyword to search for. Note that the translations for
    *                  all languages will be taken into account.
    *
-   * @return  UUIDs of elements matching the filter, sorted alphabetically
-   *          and without duplicates. Empty if no elements were found.
+   * @return  UUIDs of elements matching the filter, without duplicates.
+   *          An exact UUID match comes first, then the results are sorted
+   *          by relevance (if the full-text search index is available) and
+   *          alphabetically. Empty if no elements were found.
    */
   template <typename ElementType>
   QList<Uuid> find(const QString& keyword) const;
@@ -242,8 +252,9 @@ public:
    * @param keyword   Keyword to search for.
    *
    * @return  All devices which contain parts matching the filter, sorted
-   *          alphabetically and without duplicates. Empty if no elements
-   *          were found.
+   *          by relevance (if the full-text search index is available) and
+   *          alphabetically, without duplicates. Empty if no elements were
+   *          found.
    */
   QList<Uuid> findDevicesOfParts(const QString& keyword) const;
 
@@ -505,6 +516,14 @@ public:
 
   // General Methods
 
+  /**
+   * @brief Set the number of threads used to parse library elements on scans
+   *
+   * @param count   Number of threads. If zero or negative, the ideal thread
+   *                count of the system is used (the default).
+   */
+  void setScanThreadCount(int count) noexcept;
+
   /**
    * @brief Re-initialize database and start new rescan
    */
@@ -512,6 +531,10 @@ public:
 
   /**
    * @brief Rescan the whole library directory and update the SQLite database
+   *
+   * Only library elements which have been added, modified or removed since
+   * the last scan are parsed, all others are kept in the database as-is.
+   * Use #resetAndRescan() to enforce parsing all elements again.
    */
   void startLibraryRescan() noexcept;
 
@@ -532,7 +555,7 @@ signals:
   void scanProgressUpdate(int percent);
   void scanSucceeded(int elementCount);
   void scanFailed(QString errorMsg);
-  void scanFinished();
+  void scanFinished(qint64 elapsedMs);
   void scanInProgressChanged(bool inProgress);
 
 private:
@@ -570,6 +593,8 @@ private:
                             const FilePath& elemDir) const;
   static QSet<Uuid> getUuidSet(QSqlQuery& query);
   int getDbVersion() const noexcept;
+  bool hasFullTextIndex() const noexcept;
+  static QString toFullTextQuery(const QString& keyword) noexcept;
   template <typename ElementType>
   static QString getTable() noexcept;
   template <typename ElementType>
@@ -579,10 +604,11 @@ private:
   const FilePath mLibrariesPath;  ///< Path to workspace libraries directory.
   const FilePath mFilePath;  ///< Path to the SQLite database file.
   QScopedPointer<SQLiteDatabase> mDb;  ///< The SQLite database.
+  bool mFullTextSearch;  ///< Whether the FTS5 indices are available.
   QScopedPointer<WorkspaceLibraryScanner> mLibraryScanner;
 
   // Constants
-  static const int sCurrentDbVersion = 8;
+  static const int sCurrentDbVersion = 10;
 };
 
 /*******************************************************************************
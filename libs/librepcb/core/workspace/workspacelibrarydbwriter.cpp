@@ -107,7 +107,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
       "`deprecated` BOOLEAN NOT NULL, "
-      "`parent_uuid` TEXT"
+      "`parent_uuid` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS component_categories_tr ("
@@ -130,7 +131,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
       "`deprecated` BOOLEAN NOT NULL, "
-      "`parent_uuid` TEXT"
+      "`parent_uuid` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS package_categories_tr ("
@@ -153,7 +155,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
       "`deprecated` BOOLEAN NOT NULL, "
-      "`generated_by` TEXT"
+      "`generated_by` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS symbols_tr ("
@@ -184,7 +187,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
       "`deprecated` BOOLEAN NOT NULL, "
-      "`generated_by` TEXT"
+      "`generated_by` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS packages_tr ("
@@ -223,7 +227,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`uuid` TEXT NOT NULL, "
       "`version` TEXT NOT NULL, "
       "`deprecated` BOOLEAN NOT NULL, "
-      "`generated_by` TEXT"
+      "`generated_by` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS components_tr ("
@@ -265,7 +270,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`deprecated` BOOLEAN NOT NULL, "
       "`component_uuid` TEXT NOT NULL, "
       "`package_uuid` TEXT NOT NULL, "
-      "`generated_by` TEXT"
+      "`generated_by` TEXT, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS devices_tr ("
@@ -329,7 +335,8 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`fabs` TEXT NOT NULL, "
       "`shipping` TEXT NOT NULL, "
       "`sponsor` BOOL NOT NULL, "
-      "`priority` INTEGER NOT NULL "
+      "`priority` INTEGER NOT NULL, "
+      "`stamp` TEXT"
       ")");
   queries << QString(
       "CREATE TABLE IF NOT EXISTS organizations_tr ("
@@ -364,6 +371,19 @@ void WorkspaceLibraryDbWriter::createAllTables() {
       "`name` TEXT NOT NULL "
       ")");
 
+  // full-text search indices (external content tables kept in sync by
+  // triggers, thus also cascaded deletes and clearTable() are covered)
+  if (mDb.isFullTextSearchSupported()) {
+    const QStringList elementTables = {"symbols", "packages", "components",
+                                       "devices"};
+    foreach (const QString& elementsTable, elementTables) {
+      queries << createFullTextIndexQueries(elementsTable % "_tr",
+                                            {"name", "keywords"});
+    }
+    queries << createFullTextIndexQueries("packages_alt", {"name"});
+    queries << createFullTextIndexQueries("parts", {"mpn", "manufacturer"});
+  }
+
   // execute queries
   foreach (const QString& string, queries) {
     QSqlQuery query = mDb.prepareQuery(string);
@@ -372,7 +392,7 @@ void WorkspaceLibraryDbWriter::createAllTables() {
 }
 
 void WorkspaceLibraryDbWriter::addInternalData(const QString& key, int value) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO internal (key, value_int) "
       "VALUES (:key, :version)");
   query.bindValue(":key", key);
@@ -385,7 +405,7 @@ int WorkspaceLibraryDbWriter::addLibrary(const FilePath& fp, const Uuid& uuid,
                                          bool deprecated,
                                          const QByteArray& iconPng,
                                          const QString& manufacturer) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO libraries "
       "(filepath, uuid, version, deprecated, icon_png, manufacturer) VALUES "
       "(:filepath, :uuid, :version, :deprecated, :icon_png, :manufacturer)");
@@ -401,7 +421,7 @@ int WorkspaceLibraryDbWriter::addLibrary(const FilePath& fp, const Uuid& uuid,
 void WorkspaceLibraryDbWriter::updateLibrary(
     const FilePath& fp, const Uuid& uuid, const Version& version,
     bool deprecated, const QByteArray& iconPng, const QString& manufacturer) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "UPDATE libraries "
       "SET uuid = :uuid, version = :version, deprecated = :deprecated, "
       "icon_png = :icon_png, manufacturer = :manufacturer "
@@ -421,7 +441,7 @@ int WorkspaceLibraryDbWriter::addDevice(int libId, const FilePath& fp,
                                         const QString& generatedBy,
                                         const Uuid& component,
                                         const Uuid& package) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO devices "
       "(library_id, filepath, uuid, version, deprecated, generated_by, "
       "component_uuid, package_uuid) VALUES "
@@ -440,7 +460,7 @@ int WorkspaceLibraryDbWriter::addDevice(int libId, const FilePath& fp,
 
 int WorkspaceLibraryDbWriter::addPart(int devId, const QString& mpn,
                                       const QString& manufacturer) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO parts "
       "(device_id, mpn, manufacturer) VALUES "
       "(:device_id, :mpn, :manufacturer)");
@@ -452,7 +472,7 @@ int WorkspaceLibraryDbWriter::addPart(int devId, const QString& mpn,
 
 int WorkspaceLibraryDbWriter::addPartAttribute(int partId,
                                                const Attribute& attribute) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO parts_attr "
       "(part_id, key, type, value, unit) VALUES "
       "(:part_id, :key, :type, :value, :unit)");
@@ -466,12 +486,29 @@ int WorkspaceLibraryDbWriter::addPartAttribute(int partId,
   return mDb.insert(query);
 }
 
+void WorkspaceLibraryDbWriter::addPartAttributes(
+    int partId, const AttributeList& attributes) {
+  QVector<QVariantList> rows;
+  rows.reserve(attributes.count());
+  for (const Attribute& attribute : attributes) {
+    rows.append({
+        partId,
+        *attribute.getKey(),
+        attribute.getType().getName(),
+        nonNull(attribute.getValue()),
+        attribute.getUnit() ? attribute.getUnit()->getName() : QVariant(),
+    });
+  }
+  mDb.insertMultiple("parts_attr", {"part_id", "key", "type", "value", "unit"},
+                     rows);
+}
+
 int WorkspaceLibraryDbWriter::addOrganization(
     int libId, const FilePath& fp, const Uuid& uuid, const Version& version,
     bool deprecated, const QByteArray& logoPng, const QUrl& url,
     const QString& country, const QStringList& fabs,
     const QStringList& shipping, bool isSponsor, int priority) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO organizations "
       "(library_id, filepath, uuid, version, deprecated, logo_png, url, "
       "country, fabs, shipping, sponsor, priority) VALUES "
@@ -495,7 +532,7 @@ int WorkspaceLibraryDbWriter::addOrganization(
 int WorkspaceLibraryDbWriter::addOrganizationPcbDesignRules(
     int orgId, const Uuid& uuid, const QString& name,
     const QString& description, const QUrl& url, int maxLayers) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO organization_pcb_design_rules "
       "(organization_id, uuid, name, description, url, max_layers) VALUES "
       "(:organization_id, :uuid, :name, :description, :url, :max_layers)");
@@ -511,7 +548,7 @@ int WorkspaceLibraryDbWriter::addOrganizationPcbDesignRules(
 int WorkspaceLibraryDbWriter::addOrganizationOutputJob(
     int orgId, WorkspaceLibraryDb::OutputJobKind kind, const Uuid& uuid,
     const QString& type, const QString& name) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO organization_output_jobs "
       "(organization_id, kind, uuid, type, name) VALUES "
       "(:organization_id, :kind, :uuid, :type, :name)");
@@ -525,7 +562,7 @@ int WorkspaceLibraryDbWriter::addOrganizationOutputJob(
 
 int WorkspaceLibraryDbWriter::addAlternativeName(
     int pkgId, const ElementName& name, const SimpleString& reference) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO packages_alt "
       "(package_id, name, reference) VALUES "
       "(:package_id, :name, :reference)");
@@ -610,7 +647,7 @@ int WorkspaceLibraryDbWriter::addElement(const QString& elementsTable,
                                          const Version& version,
                                          bool deprecated,
                                          const QString& generatedBy) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO %elements "
       "(library_id, filepath, uuid, version, deprecated, generated_by) VALUES "
       "(:library_id, :filepath, :uuid, :version, :deprecated, :generated_by)",
@@ -632,7 +669,7 @@ int WorkspaceLibraryDbWriter::addCategory(const QString& categoriesTable,
                                           const Version& version,
                                           bool deprecated,
                                           const std::optional<Uuid>& parent) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO %categories "
       "(library_id, filepath, uuid, version, deprecated, parent_uuid) VALUES "
       "(:library_id, :filepath, :uuid, :version, :deprecated, :parent_uuid)",
@@ -648,9 +685,23 @@ int WorkspaceLibraryDbWriter::addCategory(const QString& categoriesTable,
   return mDb.insert(query);
 }
 
+void WorkspaceLibraryDbWriter::setElementStamp(const QString& elementsTable,
+                                               int elementId,
+                                               const QString& stamp) {
+  QSqlQuery& query = mDb.prepareCachedQuery(
+      "UPDATE %elements SET stamp = :stamp "
+      "WHERE id = :id",
+      {
+          {"%elements", elementsTable},
+      });
+  query.bindValue(":id", elementId);
+  query.bindValue(":stamp", nonEmptyOrNull(stamp));
+  mDb.exec(query);
+}
+
 void WorkspaceLibraryDbWriter::removeElement(const QString& elementsTable,
                                              const FilePath& fp) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "DELETE FROM %elements "
       "WHERE filepath = :filepath",
       {
@@ -669,7 +720,7 @@ int WorkspaceLibraryDbWriter::addTranslation(
     const std::optional<ElementName>& name,
     const std::optional<QString>& description,
     const std::optional<QString>& keywords) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO %elements_tr "
       "(element_id, locale, name, description, keywords) VALUES "
       "(:element_id, :locale, :name, :description, :keywords)",
@@ -684,6 +735,25 @@ int WorkspaceLibraryDbWriter::addTranslation(
   return mDb.insert(query);
 }
 
+void WorkspaceLibraryDbWriter::addTranslations(
+    const QString& elementsTable, int elementId,
+    const QList<Translation>& translations) {
+  QVector<QVariantList> rows;
+  rows.reserve(translations.count());
+  for (const Translation& tr : translations) {
+    rows.append({
+        elementId,
+        tr.locale,
+        tr.name ? **tr.name : QVariant(),
+        tr.description ? *tr.description : QVariant(),
+        tr.keywords ? *tr.keywords : QVariant(),
+    });
+  }
+  mDb.insertMultiple(
+      elementsTable % "_tr",
+      {"element_id", "locale", "name", "description", "keywords"}, rows);
+}
+
 void WorkspaceLibraryDbWriter::removeAllTranslations(
     const QString& elementsTable) {
   mDb.clearTable(elementsTable % "_tr");
@@ -692,7 +762,7 @@ void WorkspaceLibraryDbWriter::removeAllTranslations(
 int WorkspaceLibraryDbWriter::addToCategory(const QString& elementsTable,
                                             int elementId,
                                             const Uuid& category) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO %elements_cat "
       "(element_id, category_uuid) VALUES "
       "(:element_id, :category_uuid)",
@@ -704,11 +774,23 @@ int WorkspaceLibraryDbWriter::addToCategory(const QString& elementsTable,
   return mDb.insert(query);
 }
 
+void WorkspaceLibraryDbWriter::addToCategories(const QString& elementsTable,
+                                               int elementId,
+                                               const QSet<Uuid>& categories) {
+  QVector<QVariantList> rows;
+  rows.reserve(categories.count());
+  foreach (const Uuid& category, categories) {
+    rows.append({elementId, category.toStr()});
+  }
+  mDb.insertMultiple(elementsTable % "_cat", {"element_id", "category_uuid"},
+                     rows);
+}
+
 int WorkspaceLibraryDbWriter::addResource(const QString& elementsTable,
                                           int elementId, const QString& name,
                                           const QString& mediaType,
                                           const QUrl& url) {
-  QSqlQuery query = mDb.prepareQuery(
+  QSqlQuery& query = mDb.prepareCachedQuery(
       "INSERT INTO %elements_res "
       "(element_id, name, media_type, url) VALUES "
       "(:element_id, :name, :media_type, :url)",
@@ -727,6 +809,47 @@ QString WorkspaceLibraryDbWriter::filePathToString(
   return fp.toRelative(mLibrariesRoot);
 }
 
+QStringList WorkspaceLibraryDbWriter::createFullTextIndexQueries(
+    const QString& table, const QStringList& columns) {
+  // The trigram tokenizer allows arbitrary substring matches, i.e. the same
+  // semantics as "LIKE '%keyword%'", but without scanning the whole table.
+  const QString cols = columns.join(", ");
+  const QString newCols = "new." % columns.join(", new.");
+  const QString oldCols = "old." % columns.join(", old.");
+  const SQLiteDatabase::Replacements replacements = {
+      {"%table", table},
+      {"%cols", cols},
+      {"%new", newCols},
+      {"%old", oldCols},
+  };
+  QStringList queries = {
+      "CREATE VIRTUAL TABLE IF NOT EXISTS %table_fts USING fts5("
+      "%cols, content='%table', content_rowid='id', tokenize='trigram'"
+      ")",
+      "CREATE TRIGGER IF NOT EXISTS %table_fts_insert AFTER INSERT ON %table "
+      "BEGIN "
+      "INSERT INTO %table_fts (rowid, %cols) VALUES (new.id, %new); "
+      "END",
+      "CREATE TRIGGER IF NOT EXISTS %table_fts_delete AFTER DELETE ON %table "
+      "BEGIN "
+      "INSERT INTO %table_fts (%table_fts, rowid, %cols) "
+      "VALUES ('delete', old.id, %old); "
+      "END",
+      "CREATE TRIGGER IF NOT EXISTS %table_fts_update AFTER UPDATE ON %table "
+      "BEGIN "
+      "INSERT INTO %table_fts (%table_fts, rowid, %cols) "
+      "VALUES ('delete', old.id, %old); "
+      "INSERT INTO %table_fts (rowid, %cols) VALUES (new.id, %new); "
+      "END",
+  };
+  for (QString& query : queries) {
+    for (const auto& replacement : replacements) {
+      query.replace(replacement.first, replacement.second);
+    }
+  }
+  return queries;
+}
+
 QString WorkspaceLibraryDbWriter::nonEmptyOrNull(const QString& s) noexcept {
   return s.isEmpty() ? QString() : s;
 }
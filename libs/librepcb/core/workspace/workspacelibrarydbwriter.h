@@ -57,6 +57,14 @@ class Version;
  */
 class WorkspaceLibraryDbWriter final {
 public:
+  // Types
+  struct Translation {
+    QString locale;
+    std::optional<ElementName> name;
+    std::optional<QString> description;
+    std::optional<QString> keywords;
+  };
+
   // Constructors / Destructor
   WorkspaceLibraryDbWriter() = delete;
   WorkspaceLibraryDbWriter(const WorkspaceLibraryDbWriter& other) = delete;
@@ -69,6 +77,11 @@ public:
    * @brief Create all tables to initialize the database
    *
    * This has to be done only once, after creating a new database.
+   *
+   * If supported by the SQLite library, this also creates FTS5 full-text
+   * search indices for element names, keywords and parts. They are kept
+   * up to date by triggers, so no special care is needed when adding or
+   * removing elements.
    */
   void createAllTables();
 
@@ -193,6 +206,16 @@ public:
    */
   int addPartAttribute(int partId, const Attribute& attribute);
 
+  /**
+   * @brief Add multiple attributes to a previously added part
+   *
+   * Same as #addPartAttribute(), but inserts all attributes at once.
+   *
+   * @param partId        ID of the part containing these attributes.
+   * @param attributes    Attributes to add.
+   */
+  void addPartAttributes(int partId, const AttributeList& attributes);
+
   /**
    * @brief #addElement() specialized for organizations
    *
@@ -248,6 +271,21 @@ public:
                                const Uuid& uuid, const QString& type,
                                const QString& name);
 
+  /**
+   * @brief Set the modification stamp of a previously added library element
+   *
+   * The stamp is used by the library scanner to detect whether an element
+   * has been modified on the file system since it was added to the database.
+   *
+   * @tparam ElementType  Type of element to update.
+   * @param elementId     ID of the element to update.
+   * @param stamp         Modification stamp of the element directory.
+   */
+  template <typename ElementType>
+  void setElementStamp(int elementId, const QString& stamp) {
+    setElementStamp(getElementTable<ElementType>(), elementId, stamp);
+  }
+
   /**
    * @brief Remove a library element
    *
@@ -295,6 +333,20 @@ public:
                           name, description, keywords);
   }
 
+  /**
+   * @brief Add multiple translations for a library element
+   *
+   * Same as #addTranslation(), but inserts all translations at once.
+   *
+   * @tparam ElementType  Type of element to add translations.
+   * @param elementId     ID of the element to add translations.
+   * @param translations  Translations to add.
+   */
+  template <typename ElementType>
+  void addTranslations(int elementId, const QList<Translation>& translations) {
+    addTranslations(getElementTable<ElementType>(), elementId, translations);
+  }
+
   /**
    * @brief Remove all translations for a library element type
    *
@@ -323,6 +375,25 @@ public:
     return addToCategory(getElementTable<ElementType>(), elementId, category);
   }
 
+  /**
+   * @brief Add a library element to multiple categories
+   *
+   * Same as #addToCategory(), but inserts all categories at once.
+   *
+   * @tparam ElementType  Type of element to add to the categories.
+   * @param elementId     ID of the element to add to the categories.
+   * @param categories    Category UUIDs.
+   */
+  template <typename ElementType>
+  void addToCategories(int elementId, const QSet<Uuid>& categories) {
+    static_assert(std::is_same<ElementType, Symbol>::value ||
+                      std::is_same<ElementType, Package>::value ||
+                      std::is_same<ElementType, Component>::value ||
+                      std::is_same<ElementType, Device>::value,
+                  "Unsupported ElementType");
+    addToCategories(getElementTable<ElementType>(), elementId, categories);
+  }
+
   /**
    * @brief Add a resource for a library element
    *
@@ -386,6 +457,8 @@ private:  // Methods
   int addCategory(const QString& categoriesTable, int libId, const FilePath& fp,
                   const Uuid& uuid, const Version& version, bool deprecated,
                   const std::optional<Uuid>& parent);
+  void setElementStamp(const QString& elementsTable, int elementId,
+                       const QString& stamp);
   void removeElement(const QString& elementsTable, const FilePath& fp);
   void removeAllElements(const QString& elementsTable);
   int addTranslation(const QString& elementsTable, int elementId,
@@ -393,13 +466,19 @@ private:  // Methods
                      const std::optional<ElementName>& name,
                      const std::optional<QString>& description,
                      const std::optional<QString>& keywords);
+  void addTranslations(const QString& elementsTable, int elementId,
+                       const QList<Translation>& translations);
   void removeAllTranslations(const QString& elementsTable);
   int addToCategory(const QString& elementsTable, int elementId,
                     const Uuid& category);
+  void addToCategories(const QString& elementsTable, int elementId,
+                       const QSet<Uuid>& categories);
   int addResource(const QString& elementsTable, int elementId,
                   const QString& name, const QString& mediaType,
                   const QUrl& url);
   QString filePathToString(const FilePath& fp) const noexcept;
+  static QStringList createFullTextIndexQueries(const QString& table,
+                                                const QStringList& columns);
   static QString nonEmptyOrNull(const QString& s) noexcept;
   static QString nonNull(const QString& s) noexcept;
 
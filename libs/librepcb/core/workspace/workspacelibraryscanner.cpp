@@ -36,6 +36,7 @@
 #include "../utils/toolbox.h"
 #include "workspacelibrarydbwriter.h"
 
+#include <QtConcurrent>
 #include <QtCore>
 
 #include <memory>
@@ -56,6 +57,9 @@ WorkspaceLibraryScanner::WorkspaceLibraryScanner(
     mDbFilePath(dbFilePath),
     mState(State::Idle),
     mLastProgressPercent(100) {
+  // Parse library elements with the same low priority as this thread.
+  mThreadPool.setThreadPriority(QThread::LowestPriority);
+
   connect(
       this, &WorkspaceLibraryScanner::scanProgressUpdate, this,
       [this](int percent) { mLastProgressPercent = percent; },
@@ -100,6 +104,11 @@ void WorkspaceLibraryScanner::startScan() noexcept {
   mStateCV.notify_one();
 }
 
+void WorkspaceLibraryScanner::setThreadCount(int count) noexcept {
+  mThreadPool.setMaxThreadCount(
+      (count > 0) ? count : QThread::idealThreadCount());
+}
+
 bool WorkspaceLibraryScanner::cancelScan() noexcept {
   {
     std::lock_guard lk(mMutex);
@@ -149,9 +158,9 @@ void WorkspaceLibraryScanner::run() noexcept {
 }
 
 void WorkspaceLibraryScanner::scan() noexcept {
+  QElapsedTimer timer;
+  timer.start();
   try {
-    QElapsedTimer timer;
-    timer.start();
     emit scanStarted();
     emit scanInProgressChanged(true);
     emit scanProgressUpdate(0);
@@ -161,6 +170,12 @@ void WorkspaceLibraryScanner::scan() noexcept {
     SQLiteDatabase db(mDbFilePath);  // can throw
     WorkspaceLibraryDbWriter writer(mLibrariesPath, db);
 
+    // The database is just a cache which is rebuilt if it gets corrupted, so
+    // don't wait for the disk to sync on every commit. The journal mode needs
+    // to stay WAL to not block readers while scanning.
+    db.setSynchronousMode(SQLiteDatabase::SynchronousMode::Off);  // can throw
+    db.setCacheSize(64 * 1024);  // can throw
+
     // update list of libraries
     QList<std::shared_ptr<Library>> libraries;
     getLibrariesOfDirectory("local", libraries);
@@ -175,14 +190,14 @@ void WorkspaceLibraryScanner::scan() noexcept {
     // begin database transaction
     SQLiteDatabase::TransactionScopeGuard transactionGuard(db);  // can throw
 
-    // clear all tables
-    writer.removeAllElements<ComponentCategory>();
-    writer.removeAllElements<PackageCategory>();
-    writer.removeAllElements<Symbol>();
-    writer.removeAllElements<Package>();
-    writer.removeAllElements<Component>();
-    writer.removeAllElements<Device>();
-    writer.removeAllElements<Organization>();
+    // get modification stamps of all elements currently in the database
+    ElementStamps cmpCatStamps = getElementStamps<ComponentCategory>(db);
+    ElementStamps pkgCatStamps = getElementStamps<PackageCategory>(db);
+    ElementStamps symStamps = getElementStamps<Symbol>(db);
+    ElementStamps pkgStamps = getElementStamps<Package>(db);
+    ElementStamps cmpStamps = getElementStamps<Component>(db);
+    ElementStamps devStamps = getElementStamps<Device>(db);
+    ElementStamps orgStamps = getElementStamps<Organization>(db);
 
     // scan all libraries
     int count = 0;
@@ -194,34 +209,48 @@ void WorkspaceLibraryScanner::scan() noexcept {
       int libId = libIds[fp];
       if (abortRequested()) break;
       count += addElementsToDb<ComponentCategory>(
-          writer, fp, lib->searchForElements<ComponentCategory>(), libId);
+          writer, fp, lib->searchForElements<ComponentCategory>(), libId,
+          cmpCatStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
       count += addElementsToDb<PackageCategory>(
-          writer, fp, lib->searchForElements<PackageCategory>(), libId);
+          writer, fp, lib->searchForElements<PackageCategory>(), libId,
+          pkgCatStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
-      count += addElementsToDb<Symbol>(writer, fp,
-                                       lib->searchForElements<Symbol>(), libId);
+      count += addElementsToDb<Symbol>(
+          writer, fp, lib->searchForElements<Symbol>(), libId, symStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
       count += addElementsToDb<Package>(
-          writer, fp, lib->searchForElements<Package>(), libId);
+          writer, fp, lib->searchForElements<Package>(), libId, pkgStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
       count += addElementsToDb<Component>(
-          writer, fp, lib->searchForElements<Component>(), libId);
+          writer, fp, lib->searchForElements<Component>(), libId, cmpStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
-      count += addElementsToDb<Device>(writer, fp,
-                                       lib->searchForElements<Device>(), libId);
+      count += addElementsToDb<Device>(
+          writer, fp, lib->searchForElements<Device>(), libId, devStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
       if (abortRequested()) break;
       count += addElementsToDb<Organization>(
-          writer, fp, lib->searchForElements<Organization>(), libId);
+          writer, fp, lib->searchForElements<Organization>(), libId,
+          orgStamps);
       emit scanProgressUpdate(percent += qreal(98) / fraction);
     }
 
+    // remove elements which no longer exist (or failed to open)
+    if (!abortRequested()) {
+      removeElementsFromDb<ComponentCategory>(writer, cmpCatStamps);
+      removeElementsFromDb<PackageCategory>(writer, pkgCatStamps);
+      removeElementsFromDb<Symbol>(writer, symStamps);
+      removeElementsFromDb<Package>(writer, pkgStamps);
+      removeElementsFromDb<Component>(writer, cmpStamps);
+      removeElementsFromDb<Device>(writer, devStamps);
+      removeElementsFromDb<Organization>(writer, orgStamps);
+    }
+
     // commit transaction
     std::lock_guard lk(mMutex);
     if (mState == State::Scanning) {
@@ -240,7 +269,7 @@ void WorkspaceLibraryScanner::scan() noexcept {
   }
   emit scanProgressUpdate(100);
   emit scanInProgressChanged(false);
-  emit scanFinished();
+  emit scanFinished(timer.elapsed());
   mStateCV.notify_all();
 }
 
@@ -322,29 +351,104 @@ QHash<FilePath, int> WorkspaceLibraryScanner::updateLibraries(
   return dbLibIds;
 }
 
+template <typename ElementType>
+WorkspaceLibraryScanner::ElementStamps
+    WorkspaceLibraryScanner::getElementStamps(SQLiteDatabase& db) const {
+  ElementStamps stamps;
+  QSqlQuery query = db.prepareQuery(
+      "SELECT id, library_id, filepath, stamp FROM %elements",
+      {
+          {"%elements",
+           WorkspaceLibraryDbWriter::getElementTable<ElementType>()},
+      });
+  db.exec(query);
+  while (query.next()) {
+    FilePath fp = mLibrariesPath.getPathTo(query.value(2).toString());
+    if (!fp.isValid()) throw LogicError(__FILE__, __LINE__);
+    stamps.insert(fp,
+                  ElementStamp{query.value(0).toInt(), query.value(1).toInt(),
+                               query.value(3).toString()});
+  }
+  return stamps;
+}
+
 template <typename ElementType>
 int WorkspaceLibraryScanner::addElementsToDb(WorkspaceLibraryDbWriter& writer,
                                              const FilePath& libPath,
-                                             const QStringList& dirs,
-                                             int libId) {
+                                             const QStringList& dirs, int libId,
+                                             ElementStamps& stamps) {
   int count = 0;
-  foreach (const QString& dirpath, dirs) {
-    if (((count % 20) == 19) && abortRequested()) break;
-    const FilePath fp = libPath.getPathTo(dirpath);
-    try {
-      std::unique_ptr<ElementType> element =
-          openAndMigrate<ElementType>(fp);  // can throw
-      int id = addElementToDb(writer, libId, *element);
-      addTranslationsToDb(writer, id, *element);
-      count++;
-    } catch (const Exception& e) {
-      qWarning() << "Failed to open library element during scan:"
-                 << fp.toNative();
+  QList<FilePath> paths;
+  QStringList pathStamps;
+  for (int i = 0; i < dirs.count(); ++i) {
+    if (((i % 20) == 19) && abortRequested()) return count;
+    const FilePath fp = libPath.getPathTo(dirs.at(i));
+
+    // Skip elements which have not been modified since the last scan. The
+    // stamp is determined before opening the element, so any modification
+    // made while parsing it will be detected by the next scan.
+    const QString stamp = getDirectoryStamp(fp);
+    auto it = stamps.find(fp);
+    if (it != stamps.end()) {
+      const bool upToDate = (it->libId == libId) && (!stamp.isEmpty()) &&
+          (it->stamp == stamp);
+      stamps.erase(it);
+      if (upToDate) {
+        count++;
+        continue;
+      }
+      writer.removeElement<ElementType>(fp);
     }
+    paths.append(fp);
+    pathStamps.append(stamp);
   }
+
+  // Parse the elements in chunks with the worker thread pool. While the next
+  // chunk is being parsed, the results of the previous chunk are added to
+  // the database by this thread, which is the only one writing to it. The
+  // chunks keep the number of elements in memory bounded.
+  const int chunkSize = std::max(mThreadPool.maxThreadCount(), 1) * 16;
+  auto parseChunk = [this, &paths, chunkSize](int start) {
+    return QtConcurrent::mapped(
+        &mThreadPool, paths.mid(start, chunkSize), [this](const FilePath& fp) {
+          std::shared_ptr<ElementType> element;
+          try {
+            element = openAndMigrate<ElementType>(fp);  // can throw
+            element->moveToThread(this);  // Will be destroyed by this thread.
+          } catch (const Exception& e) {
+            qWarning() << "Failed to open library element during scan:"
+                       << fp.toNative();
+          }
+          return element;
+        });
+  };
+  QFuture<std::shared_ptr<ElementType>> future = parseChunk(0);
+  for (int start = 0; start < paths.count(); start += chunkSize) {
+    const QList<std::shared_ptr<ElementType>> elements = future.results();
+    if (abortRequested()) break;
+    future = parseChunk(start + chunkSize);
+    for (int i = 0; i < elements.count(); ++i) {
+      if (const std::shared_ptr<ElementType>& element = elements.at(i)) {
+        const int id = addElementToDb(writer, libId, *element);
+        addTranslationsToDb(writer, id, *element);
+        writer.setElementStamp<ElementType>(id, pathStamps.at(start + i));
+        count++;
+      }
+    }
+  }
+  future.cancel();
+  future.waitForFinished();
   return count;
 }
 
+template <typename ElementType>
+void WorkspaceLibraryScanner::removeElementsFromDb(
+    WorkspaceLibraryDbWriter& writer, const ElementStamps& stamps) {
+  for (auto it = stamps.begin(); it != stamps.end(); it++) {
+    writer.removeElement<ElementType>(it.key());
+  }
+}
+
 template <typename ElementType>
 int WorkspaceLibraryScanner::addElementToDb(WorkspaceLibraryDbWriter& writer,
                                             int libId,
@@ -412,9 +516,7 @@ int WorkspaceLibraryScanner::addElementToDb<Device>(
     if (!part.isEmpty()) {
       const int partId =
           writer.addPart(id, *part.getMpn(), *part.getManufacturer());
-      for (const Attribute& attribute : part.getAttributes()) {
-        writer.addPartAttribute(partId, attribute);
-      }
+      writer.addPartAttributes(partId, part.getAttributes());
     }
   }
   return id;
@@ -458,21 +560,23 @@ template <typename ElementType>
 void WorkspaceLibraryScanner::addTranslationsToDb(
     WorkspaceLibraryDbWriter& writer, int elementId,
     const ElementType& element) {
+  QList<WorkspaceLibraryDbWriter::Translation> translations;
   foreach (const QString& locale, element.getAllAvailableLocales()) {
-    writer.addTranslation<ElementType>(elementId, locale,
-                                       element.getNames().tryGet(locale),
-                                       element.getDescriptions().tryGet(locale),
-                                       element.getKeywords().tryGet(locale));
+    translations.append(WorkspaceLibraryDbWriter::Translation{
+        locale,
+        element.getNames().tryGet(locale),
+        element.getDescriptions().tryGet(locale),
+        element.getKeywords().tryGet(locale),
+    });
   }
+  writer.addTranslations<ElementType>(elementId, translations);
 }
 
 template <typename ElementType>
 void WorkspaceLibraryScanner::addToCategories(WorkspaceLibraryDbWriter& writer,
                                               int elementId,
                                               const ElementType& element) {
-  foreach (const Uuid& category, element.getCategories()) {
-    writer.addToCategory<ElementType>(elementId, category);
-  }
+  writer.addToCategories<ElementType>(elementId, element.getCategories());
 }
 
 template <typename ElementType>
@@ -488,11 +592,17 @@ void WorkspaceLibraryScanner::addResourcesToDb(WorkspaceLibraryDbWriter& writer,
 template <typename ElementType>
 std::unique_ptr<ElementType> WorkspaceLibraryScanner::openAndMigrate(
     const FilePath& fp) {
-  // Try to open the library element read-only first.
+  // Try to open the library element read-only first. For elements which may
+  // contain a lot of geometry, load only the metadata required for indexing.
   auto fs = TransactionalFileSystem::openRO(fp);
-  std::unique_ptr<ElementType> element =
-      ElementType::open(std::make_unique<TransactionalDirectory>(fs),
-                        true);  // can throw
+  std::unique_ptr<ElementType> element;
+  if constexpr (std::is_base_of<LibraryElement, ElementType>::value) {
+    element = ElementType::openMetadata(
+        std::make_unique<TransactionalDirectory>(fs));  // can throw
+  } else {
+    element = ElementType::open(std::make_unique<TransactionalDirectory>(fs),
+                                true);  // can throw
+  }
   if (!element) {
     // If this didn't work, a file format migration is required so we try
     // it again in read/write mode. Afterwards save the element to disk to
@@ -513,6 +623,34 @@ bool WorkspaceLibraryScanner::abortRequested() const noexcept {
   return mState != State::Scanning;
 }
 
+QString WorkspaceLibraryScanner::getDirectoryStamp(
+    const FilePath& dir) noexcept {
+  // Hash relative path, size and modification time of all files, so not only
+  // added or removed files are detected, but also files modified in-place
+  // (which does not update the modification time of the directory itself) or
+  // renamed. The list is sorted since the iteration order is not specified.
+  const QDir root(dir.toStr());
+  QStringList entries;
+  QDirIterator it(dir.toStr(), QDir::Files | QDir::Hidden | QDir::System,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    const QFileInfo info = it.fileInfo();
+    entries.append(QString("%1:%2:%3")
+                       .arg(root.relativeFilePath(info.filePath()))
+                       .arg(info.size())
+                       .arg(info.lastModified().toMSecsSinceEpoch()));
+  }
+  if (entries.isEmpty()) {
+    return QString();
+  }
+  entries.sort();
+  return QString::fromLatin1(
+      QCryptographicHash::hash(entries.join('\n').toUtf8(),
+                               QCryptographicHash::Sha256)
+          .toHex());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
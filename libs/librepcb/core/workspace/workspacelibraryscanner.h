@@ -63,6 +63,13 @@ class WorkspaceLibraryScanner final : public QThread {
     ShutdownRequested,
   };
 
+  struct ElementStamp {
+    int id;  ///< ID of the element in the database.
+    int libId;  ///< ID of the library containing the element.
+    QString stamp;  ///< Modification stamp of the element directory.
+  };
+  typedef QHash<FilePath, ElementStamp> ElementStamps;
+
 public:
   // Constructors / Destructor
   WorkspaceLibraryScanner(const FilePath& librariesPath,
@@ -72,6 +79,17 @@ public:
 
   // Getters
   int getProgressPercent() const noexcept { return mLastProgressPercent; }
+  int getThreadCount() const noexcept { return mThreadPool.maxThreadCount(); }
+
+  // Setters
+
+  /**
+   * @brief Set the number of worker threads used to parse library elements
+   *
+   * @param count   Number of threads. If zero or negative, the ideal thread
+   *                count of the system is used (the default).
+   */
+  void setThreadCount(int count) noexcept;
 
   // General Methods
   void startScan() noexcept;
@@ -87,7 +105,7 @@ signals:
   void scanProgressUpdate(int percent);
   void scanSucceeded(int elementCount);
   void scanFailed(QString errorMsg);
-  void scanFinished();
+  void scanFinished(qint64 elapsedMs);
   void scanInProgressChanged(bool inProgress);
 
 private:  // Methods
@@ -100,8 +118,14 @@ private:  // Methods
       SQLiteDatabase& db, WorkspaceLibraryDbWriter& writer,
       const QList<std::shared_ptr<Library>>& libs);
   template <typename ElementType>
+  ElementStamps getElementStamps(SQLiteDatabase& db) const;
+  template <typename ElementType>
   int addElementsToDb(WorkspaceLibraryDbWriter& writer, const FilePath& libPath,
-                      const QStringList& dirs, int libId);
+                      const QStringList& dirs, int libId,
+                      ElementStamps& stamps);
+  template <typename ElementType>
+  void removeElementsFromDb(WorkspaceLibraryDbWriter& writer,
+                            const ElementStamps& stamps);
   template <typename ElementType>
   int addElementToDb(WorkspaceLibraryDbWriter& writer, int libId,
                      const ElementType& element);
@@ -117,6 +141,7 @@ private:  // Methods
   template <typename ElementType>
   std::unique_ptr<ElementType> openAndMigrate(const FilePath& fp);
   bool abortRequested() const noexcept;
+  static QString getDirectoryStamp(const FilePath& dir) noexcept;
 
 private:  // Data
   const FilePath mLibrariesPath;  ///< Path to workspace libraries directory.
@@ -125,6 +150,7 @@ private:  // Data
   State mState;  ///< Protected by #mMutex
   std::condition_variable mStateCV;  ///< To notify about #mState changes
   int mLastProgressPercent;
+  QThreadPool mThreadPool;  ///< Worker threads to parse library elements.
 };
 
 /*******************************************************************************
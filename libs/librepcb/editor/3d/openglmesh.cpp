@@ -0,0 +1,137 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "openglmesh.h"
+
+#include <QtCore>
+#include <QtOpenGL>
+
+#include <unordered_map>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace editor {
+
+struct OpenGlMeshVertexHash {
+  std::size_t operator()(const QVector3D& v) const noexcept {
+    return qHashMulti(0, v.x(), v.y(), v.z());
+  }
+};
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+OpenGlMesh::OpenGlMesh(const QVector<QVector3D>& triangles) noexcept
+  : mSubMeshes(),
+    mVertexCount(0),
+    mIndexCount(0),
+    mBufferSize(0),
+    mMutex() {
+  // Merge identical vertices. Since the shaders don't use normals, vertices
+  // can be shared across faces. A new sub-mesh is started whenever a triangle
+  // would exceed the range of 16-bit indices.
+  std::unordered_map<QVector3D, quint16, OpenGlMeshVertexHash> map;
+  for (int i = 0; (i + 2) < triangles.count(); i += 3) {
+    if (mSubMeshes.isEmpty() ||
+        (mSubMeshes.last().newVertices->count() > (0x10000 - 3))) {
+      mSubMeshes.append(SubMesh{QOpenGLBuffer(QOpenGLBuffer::VertexBuffer),
+                                QOpenGLBuffer(QOpenGLBuffer::IndexBuffer), 0,
+                                QVector<QVector3D>(), QVector<quint16>()});
+      map.clear();
+    }
+    SubMesh& subMesh = mSubMeshes.last();
+    for (int k = i; k < (i + 3); ++k) {
+      const quint16 index = subMesh.newVertices->count();
+      auto it = map.try_emplace(triangles.at(k), index).first;
+      if (it->second == index) {
+        subMesh.newVertices->append(triangles.at(k));
+      }
+      subMesh.newIndices->append(it->second);
+    }
+  }
+  for (SubMesh& subMesh : mSubMeshes) {
+    subMesh.indexCount = subMesh.newIndices->count();
+    mVertexCount += subMesh.newVertices->count();
+    mIndexCount += subMesh.indexCount;
+    mBufferSize += subMesh.newVertices->count() * sizeof(QVector3D) +
+        subMesh.indexCount * sizeof(quint16);
+  }
+}
+
+OpenGlMesh::~OpenGlMesh() noexcept {
+  for (SubMesh& subMesh : mSubMeshes) {
+    subMesh.vertexBuffer.destroy();
+    subMesh.indexBuffer.destroy();
+  }
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+void OpenGlMesh::draw(QOpenGLFunctions& gl,
+                      QOpenGLShaderProgram& program) noexcept {
+  // Upload data, if not done yet.
+  {
+    QMutexLocker lock(&mMutex);
+    for (SubMesh& subMesh : mSubMeshes) {
+      if (!subMesh.vertexBuffer.isCreated()) {
+        subMesh.vertexBuffer.create();
+        subMesh.indexBuffer.create();
+      }
+      if (subMesh.newVertices && subMesh.newIndices) {
+        subMesh.vertexBuffer.bind();
+        subMesh.vertexBuffer.allocate(
+            subMesh.newVertices->constData(),
+            subMesh.newVertices->count() * sizeof(QVector3D));
+        subMesh.indexBuffer.bind();
+        subMesh.indexBuffer.allocate(
+            subMesh.newIndices->constData(),
+            subMesh.newIndices->count() * sizeof(quint16));
+        subMesh.newVertices = std::nullopt;
+        subMesh.newIndices = std::nullopt;
+      }
+    }
+  }
+
+  const int vertexLocation = program.attributeLocation("a_position");
+  program.enableAttributeArray(vertexLocation);
+  for (SubMesh& subMesh : mSubMeshes) {
+    subMesh.vertexBuffer.bind();
+    program.setAttributeBuffer(vertexLocation, GL_FLOAT, 0, 3,
+                               sizeof(QVector3D));
+    subMesh.indexBuffer.bind();
+    gl.glDrawElements(GL_TRIANGLES, subMesh.indexCount, GL_UNSIGNED_SHORT,
+                      nullptr);
+    subMesh.indexBuffer.release();
+  }
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace editor
+}  // namespace librepcb
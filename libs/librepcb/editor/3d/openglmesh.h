@@ -0,0 +1,107 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_EDITOR_OPENGLMESH_H
+#define LIBREPCB_EDITOR_OPENGLMESH_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <QtCore>
+#include <QtOpenGL>
+
+#include <optional>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+namespace editor {
+
+/*******************************************************************************
+ *  Class OpenGlMesh
+ ******************************************************************************/
+
+/**
+ * @brief Indexed triangle mesh which can be shared by multiple 3D objects
+ *
+ * Converts a list of triangle vertices into unique vertices plus indices and
+ * uploads them to the GPU on the first draw. Afterwards the CPU-side copy is
+ * released, so a mesh drawn many times (e.g. the 3D model of a package which
+ * is placed many times on a board) consumes its memory only once.
+ *
+ * Large meshes are split into several sub-meshes of at most 65536 vertices
+ * each, since OpenGL ES 2.0 supports only 16-bit indices without the
+ * `OES_element_index_uint` extension.
+ *
+ * @see ::librepcb::editor::OpenGlMeshObject
+ */
+class OpenGlMesh final {
+public:
+  // Constructors / Destructor
+  OpenGlMesh() = delete;
+  explicit OpenGlMesh(const QVector<QVector3D>& triangles) noexcept;
+  OpenGlMesh(const OpenGlMesh& other) = delete;
+  ~OpenGlMesh() noexcept;
+
+  // Getters
+  int getSubMeshCount() const noexcept { return mSubMeshes.size(); }
+  int getVertexCount() const noexcept { return mVertexCount; }
+  int getIndexCount() const noexcept { return mIndexCount; }
+  qint64 getBufferSize() const noexcept { return mBufferSize; }
+
+  // General Methods
+
+  /**
+   * @brief Draw the mesh with the currently bound shader program
+   *
+   * @param gl        OpenGL functions.
+   * @param program   Shader program, with all uniforms already set.
+   */
+  void draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& program) noexcept;
+
+  // Operator Overloadings
+  OpenGlMesh& operator=(const OpenGlMesh& rhs) = delete;
+
+private:  // Types
+  struct SubMesh {
+    QOpenGLBuffer vertexBuffer;
+    QOpenGLBuffer indexBuffer;
+    int indexCount;
+    std::optional<QVector<QVector3D>> newVertices;  ///< Not uploaded yet
+    std::optional<QVector<quint16>> newIndices;  ///< Not uploaded yet
+  };
+
+private:  // Data
+  QVector<SubMesh> mSubMeshes;
+  int mVertexCount;
+  int mIndexCount;
+  qint64 mBufferSize;
+
+  QMutex mMutex;  ///< Protects the upload of the buffers
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace editor
+}  // namespace librepcb
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "openglmeshobject.h"
+
+#include "openglmesh.h"
+
+#include <QtCore>
+#include <QtOpenGL>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace editor {
+
+/*******************************************************************************
+ *  Constructors / Destructor
+ ******************************************************************************/
+
+OpenGlMeshObject::OpenGlMeshObject(Type type) noexcept
+  : OpenGlObject(type),
+    mMutex(),
+    mColor(Qt::black),
+    mMesh(),
+    mTransform() {
+}
+
+OpenGlMeshObject::~OpenGlMeshObject() noexcept {
+}
+
+/*******************************************************************************
+ *  General Methods
+ ******************************************************************************/
+
+void OpenGlMeshObject::setData(const QColor& color,
+                               std::shared_ptr<OpenGlMesh> mesh,
+                               const QMatrix4x4& transform) noexcept {
+  QMutexLocker lock(&mMutex);
+  mColor = lighterDarkColor(color, 0.2);
+  mMesh = mesh;
+  mTransform = transform;
+}
+
+void OpenGlMeshObject::draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& program,
+                            qreal alpha) noexcept {
+  QMutexLocker lock(&mMutex);
+  if (!mMesh) {
+    return;
+  }
+
+  QColor color = mColor;
+  color.setAlphaF(color.alphaF() * alpha);
+  program.setAttributeValue("a_color", color);
+  program.setUniformValue("model_matrix", mTransform);
+  mMesh->draw(gl, program);
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace editor
+}  // namespace librepcb
@@ -0,0 +1,82 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBREPCB_EDITOR_OPENGLMESHOBJECT_H
+#define LIBREPCB_EDITOR_OPENGLMESHOBJECT_H
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include "openglobject.h"
+
+#include <QtCore>
+#include <QtOpenGL>
+
+#include <memory>
+
+/*******************************************************************************
+ *  Namespace / Forward Declarations
+ ******************************************************************************/
+namespace librepcb {
+namespace editor {
+
+class OpenGlMesh;
+
+/*******************************************************************************
+ *  Class OpenGlMeshObject
+ ******************************************************************************/
+
+/**
+ * @brief Instance of a shared ::librepcb::editor::OpenGlMesh
+ *
+ * Only holds a reference to the mesh and its own color and transformation,
+ * which is applied by the vertex shader.
+ */
+class OpenGlMeshObject final : public OpenGlObject {
+public:
+  // Constructors / Destructor
+  OpenGlMeshObject() = delete;
+  explicit OpenGlMeshObject(Type type) noexcept;
+  OpenGlMeshObject(const OpenGlMeshObject& other) = delete;
+  ~OpenGlMeshObject() noexcept override;
+
+  // General Methods
+  void setData(const QColor& color, std::shared_ptr<OpenGlMesh> mesh,
+               const QMatrix4x4& transform) noexcept;
+  void draw(QOpenGLFunctions& gl, QOpenGLShaderProgram& program,
+            qreal alpha) noexcept override;
+
+  // Operator Overloadings
+  OpenGlMeshObject& operator=(const OpenGlMeshObject& rhs) = delete;
+
+private:  // Data
+  QMutex mMutex;
+  QColor mColor;
+  std::shared_ptr<OpenGlMesh> mMesh;
+  QMatrix4x4 mTransform;
+};
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace editor
+}  // namespace librepcb
+
+#endif
@@ -63,6 +63,27 @@ public:
                     qreal alpha) noexcept = 0;
 
 protected:
+  /**
+   * @brief Helper to avoid too dark colors
+   *
+   * Colors close to black make the 3D shading almost invisible. Edges and
+   * faces are much better visible on dark gray than on black objects.
+   */
+  static QColor lighterDarkColor(QColor color, qreal minValue) noexcept {
+    float h, s, v, a;
+    color.getHsvF(&h, &s, &v, &a);
+    if (v >= minValue) return color;  // Not dark enough to touch
+
+    // How far into the "dark zone" are we? 0.0 = at minValue, 1.0 = black
+    float t = 1.0 - (v / minValue);
+    t = t * t * (3.0 - 2.0 * t);  // Smoothstep for non-linear transition
+
+    return QColor::fromHsvF(h,
+                            s * (1.0 - t),  // Desaturate proportionally
+                            v + t * (minValue - v),  // Lift value to minValue
+                            a);
+  }
+
   const Type mType;
 };
 
@@ -22,9 +22,12 @@
  ******************************************************************************/
 #include "openglscenebuilder.h"
 
+#include "openglmesh.h"
+#include "openglmeshobject.h"
 #include "opengltriangleobject.h"
 
 #include <librepcb/core/3d/occmodel.h>
+#include <librepcb/core/3d/tesselationcache.h>
 #include <librepcb/core/exceptions.h>
 #include <librepcb/core/fileio/filesystem.h>
 #include <librepcb/core/fileio/fileutils.h>
@@ -63,8 +66,13 @@ namespace editor {
  *  Constructors / Destructor
  ******************************************************************************/
 
-OpenGlSceneBuilder::OpenGlSceneBuilder(QObject* parent) noexcept
-  : QObject(parent), mMaxArcTolerance(5000), mFuture(), mAbort(false) {
+OpenGlSceneBuilder::OpenGlSceneBuilder(TesselationCache* cache,
+                                       QObject* parent) noexcept
+  : QObject(parent),
+    mMaxArcTolerance(5000),
+    mTesselationCache(cache),
+    mFuture(),
+    mAbort(false) {
   qRegisterMetaType<std::shared_ptr<OpenGlObject>>();
 }
 
@@ -294,6 +302,11 @@ void OpenGlSceneBuilder::run(std::shared_ptr<SceneData3D> data) noexcept {
     }
 
     qDebug() << "Successfully built 3D scene in" << timer.elapsed() << "ms.";
+    if (mTesselationCache) {
+      qDebug() << "Tesselation cache statistics:"
+               << mTesselationCache->getHitCount() << "hits,"
+               << mTesselationCache->getMissCount() << "misses.";
+    }
   } catch (const Exception& e) {
     qCritical().noquote() << "Failed to build 3D scene after" << timer.elapsed()
                           << "ms:" << e.getMsg();
@@ -423,21 +436,36 @@ void OpenGlSceneBuilder::publishTriangleData(
 void OpenGlSceneBuilder::publishDevice(const SceneData3D::DeviceData& obj,
                                        const QByteArray& stepContent, qreal z,
                                        qreal scaleFactor) {
-  StepModel model;
-  if (mStepModels.contains(stepContent)) {
-    model = mStepModels.value(stepContent);
-  } else {
-    if (stepContent.size()) {
+  auto meshesIt = mStepMeshes.find(stepContent);
+  if (meshesIt == mStepMeshes.end()) {
+    StepModel model;
+    std::optional<StepModel> cachedModel;
+    if (stepContent.size() && mTesselationCache) {
+      cachedModel = mTesselationCache->load(stepContent);
+    }
+    if (cachedModel) {
+      model = *cachedModel;
+    } else if (stepContent.size()) {
       try {
         std::unique_ptr<OccModel> occModel = OccModel::loadStep(stepContent);
         model = occModel->tesselate();
+        if (mTesselationCache) {
+          mTesselationCache->store(stepContent, model);
+        }
       } catch (const Exception& e) {
         qCritical().nospace()
             << "Failed to draw 3D model of " << obj.name << ": " << e.getMsg();
       }
     }
-    mStepModels.insert(stepContent, model);
+    // Create meshes only once per STEP model, all devices using the same
+    // model will share them.
+    StepMeshes meshes;
+    for (auto it = model.begin(); it != model.end(); it++) {
+      meshes.insert(it.key(), std::make_shared<OpenGlMesh>(it.value()));
+    }
+    meshesIt = mStepMeshes.insert(stepContent, meshes);
   }
+  const StepMeshes meshes = *meshesIt;
 
   QMatrix4x4 m;
   m.scale(scaleFactor);
@@ -455,28 +483,23 @@ void OpenGlSceneBuilder::publishDevice(const SceneData3D::DeviceData& obj,
   m.rotate(std::get<1>(obj.stepRotation).toDeg(), 0, 1, 0);
   m.rotate(std::get<0>(obj.stepRotation).toDeg(), 1, 0, 0);
 
-  QMap<Color, std::shared_ptr<OpenGlTriangleObject>>& items =
-      mDevices[obj.uuid];
+  QMap<Color, std::shared_ptr<OpenGlMeshObject>>& items = mDevices[obj.uuid];
   foreach (const Color& color, items.keys()) {
-    if (!model.contains(color)) {
+    if (!meshes.contains(color)) {
       emit objectRemoved(items.take(color));
     }
   }
-  for (auto it = model.begin(); it != model.end(); it++) {
-    QVector<QVector3D> vertices = it.value();
-    for (auto& vertex : vertices) {
-      vertex = m.map(vertex);
-    }
-    std::shared_ptr<OpenGlTriangleObject> obj = items.value(it.key());
+  for (auto it = meshes.begin(); it != meshes.end(); it++) {
+    std::shared_ptr<OpenGlMeshObject> obj = items.value(it.key());
     QColor color =
         QColor::fromRgbF(std::get<0>(it.key()), std::get<1>(it.key()),
                          std::get<2>(it.key()), std::get<3>(it.key()));
     if (obj) {
-      obj->setData(color, vertices);
+      obj->setData(color, it.value(), m);
       emit objectUpdated(obj);
     } else {
-      obj = std::make_shared<OpenGlTriangleObject>(OpenGlObject::Type::Device);
-      obj->setData(color, vertices);
+      obj = std::make_shared<OpenGlMeshObject>(OpenGlObject::Type::Device);
+      obj->setData(color, it.value(), m);
       items[it.key()] = obj;
       emit objectAdded(obj);
     }
@@ -36,8 +36,13 @@
  *  Namespace / Forward Declarations
  ******************************************************************************/
 namespace librepcb {
+
+class TesselationCache;
+
 namespace editor {
 
+class OpenGlMesh;
+class OpenGlMeshObject;
 class OpenGlTriangleObject;
 
 /*******************************************************************************
@@ -54,9 +59,11 @@ public:
   // Types
   typedef std::tuple<qreal, qreal, qreal, qreal> Color;
   typedef QMap<Color, QVector<QVector3D>> StepModel;
+  typedef QMap<Color, std::shared_ptr<OpenGlMesh>> StepMeshes;
 
   // Constructors / Destructor
-  OpenGlSceneBuilder(QObject* parent = nullptr) noexcept;
+  OpenGlSceneBuilder(TesselationCache* cache = nullptr,
+                     QObject* parent = nullptr) noexcept;
   OpenGlSceneBuilder(const OpenGlSceneBuilder& other) = delete;
   ~OpenGlSceneBuilder() noexcept override;
 
@@ -112,13 +119,14 @@ private:  // Methods
 
 private:  // Data
   const PositiveLength mMaxArcTolerance;
+  TesselationCache* mTesselationCache;  ///< Persistent cache (optional)
   QFuture<void> mFuture;
   bool mAbort;
 
   // Thread data.
   QHash<QString, std::shared_ptr<OpenGlTriangleObject>> mBoardObjects;
-  QHash<Uuid, QMap<Color, std::shared_ptr<OpenGlTriangleObject>>> mDevices;
-  QHash<QByteArray, StepModel> mStepModels;  ///< Cache
+  QHash<Uuid, QMap<Color, std::shared_ptr<OpenGlMeshObject>>> mDevices;
+  QHash<QByteArray, StepMeshes> mStepMeshes;  ///< In-memory cache
 };
 
 /*******************************************************************************
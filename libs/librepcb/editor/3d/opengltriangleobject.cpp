@@ -31,24 +31,6 @@
 namespace librepcb {
 namespace editor {
 
-// Helper to avoid too dark colors, since colors close to black make the
-// 3D shading almost invisible. Edges and faces are much better visible on
-// dark gray than on black objects.
-static QColor lighterDarkColor(QColor color, qreal minValue) {
-  float h, s, v, a;
-  color.getHsvF(&h, &s, &v, &a);
-  if (v >= minValue) return color;  // Not dark enough to touch
-
-  // How far into the "dark zone" are we? 0.0 = at minValue, 1.0 = pure black
-  float t = 1.0 - (v / minValue);
-  t = t * t * (3.0 - 2.0 * t);  // Smoothstep for natural, non-linear transition
-
-  return QColor::fromHsvF(h,
-                          s * (1.0 - t),  // Desaturate proportionally
-                          v + t * (minValue - v),  // Lift value toward minValue
-                          a);
-}
-
 /*******************************************************************************
  *  Constructors / Destructor
  ******************************************************************************/
@@ -98,6 +80,7 @@ void OpenGlTriangleObject::draw(QOpenGLFunctions& gl,
   QColor color = mColor;
   color.setAlphaF(color.alphaF() * alpha);
   program.setAttributeValue("a_color", color);
+  program.setUniformValue("model_matrix", QMatrix4x4());  // Identity.
 
   mBuffer.bind();
   int vertexLocation = program.attributeLocation("a_position");
@@ -619,7 +619,8 @@ void PackageTab::activate() noexcept {
   connect(mOpenGlView.get(), &SlintOpenGlView::contentChanged, this,
           &PackageTab::requestRepaint);
 
-  mOpenGlSceneBuilder = std::make_unique<OpenGlSceneBuilder>();
+  mOpenGlSceneBuilder = std::make_unique<OpenGlSceneBuilder>(
+      &mApp.getWorkspace().getTesselationCache());
   connect(mOpenGlSceneBuilder.get(), &OpenGlSceneBuilder::objectAdded,
           mOpenGlView.get(), &SlintOpenGlView::addObject);
   connect(mOpenGlSceneBuilder.get(), &OpenGlSceneBuilder::objectRemoved,
@@ -609,10 +609,12 @@ void Board2dTab::activate() noexcept {
   mScene->addItem(*mBackgroundImageGraphicsItem);
 
   // Force airwire rebuild immediately and on every project modification.
+  // The latter is done in background to keep the UI responsive on large
+  // boards.
   mBoard.triggerAirWiresRebuild();
   mActiveConnections.append(connect(&mProjectEditor.getUndoStack(),
                                     &UndoStack::stateModified, &mBoard,
-                                    &Board::triggerAirWiresRebuild));
+                                    &Board::triggerAirWiresRebuildAsync));
 
   // Unplaced component state.
   mUnplacedComponentsModel =
@@ -188,7 +188,8 @@ void Board3dTab::activate() noexcept {
   }
 
   if (!mSceneBuilder) {
-    mSceneBuilder = std::make_shared<OpenGlSceneBuilder>(this);
+    mSceneBuilder = std::make_shared<OpenGlSceneBuilder>(
+        &mApp.getWorkspace().getTesselationCache(), this);
     connect(mSceneBuilder.get(), &OpenGlSceneBuilder::objectAdded, mView.get(),
             &SlintOpenGlView::addObject);
     connect(mSceneBuilder.get(), &OpenGlSceneBuilder::objectRemoved,
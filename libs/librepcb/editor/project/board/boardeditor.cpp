@@ -277,7 +277,7 @@ void BoardEditor::startPlanesRebuild(bool force) noexcept {
     connect(mPlanesBuilder.get(), &BoardPlaneFragmentsBuilder::finished, this,
             [this](BoardPlaneFragmentsBuilder::Result result) {
               if (result.applyToBoard() && result.board) {
-                result.board->forceAirWiresRebuild();
+                result.board->forceAirWiresRebuildAsync();
                 emit planesUpdated();
               }
               mTimestampOfLastPlaneRebuild =
@@ -55,18 +55,18 @@ BGI_AirWire::BGI_AirWire(
 
   if (mAirWire.isVertical()) {
     Length size(200000);
-    Point p1 = mAirWire.getP1().getPosition() + Point(size, size);
-    Point p2 = mAirWire.getP1().getPosition() - Point(size, size);
-    Point p3 = mAirWire.getP1().getPosition() + Point(size, -size);
-    Point p4 = mAirWire.getP1().getPosition() - Point(size, -size);
+    Point p1 = mAirWire.getPosition1() + Point(size, size);
+    Point p2 = mAirWire.getPosition1() - Point(size, size);
+    Point p3 = mAirWire.getPosition1() + Point(size, -size);
+    Point p4 = mAirWire.getPosition1() - Point(size, -size);
     mLines.append(QLineF(p1.toPxQPointF(), p2.toPxQPointF()));
     mLines.append(QLineF(p3.toPxQPointF(), p4.toPxQPointF()));
     mBoundingRect = QRectF(p1.toPxQPointF(), p2.toPxQPointF()).normalized();
   } else {
-    mLines.append(QLineF(mAirWire.getP1().getPosition().toPxQPointF(),
-                         mAirWire.getP2().getPosition().toPxQPointF()));
-    mBoundingRect = QRectF(mAirWire.getP1().getPosition().toPxQPointF(),
-                           mAirWire.getP2().getPosition().toPxQPointF())
+    mLines.append(QLineF(mAirWire.getPosition1().toPxQPointF(),
+                         mAirWire.getPosition2().toPxQPointF()));
+    mBoundingRect = QRectF(mAirWire.getPosition1().toPxQPointF(),
+                           mAirWire.getPosition2().toPxQPointF())
                         .normalized();
   }
 
@@ -5,6 +5,7 @@ precision mediump float;
 
 uniform mat4 mv_matrix;
 uniform mat4 mvp_matrix;
+uniform mat4 model_matrix;  // Transformation of the drawn object.
 
 attribute vec4 a_position;
 attribute vec4 a_color;
@@ -14,6 +15,7 @@ varying vec3 v_view_pos;
 
 void main() {
     v_color = a_color;
-    v_view_pos = (mv_matrix * a_position).xyz;
-    gl_Position = mvp_matrix * a_position;
+    vec4 position = model_matrix * a_position;
+    v_view_pos = (mv_matrix * position).xyz;
+    gl_Position = mvp_matrix * position;
 }
@@ -27,6 +27,10 @@ Options:
                                      file containing custom settings. If not
                                      set, the settings from the boards will be
                                      used instead.
+  --drc-profile <format>             Print the execution time of each design
+                                     rule check job, either as 'table' or as
+                                     'json'. Only has an effect together with
+                                     '--drc'.
   --run-job <name>                   Run a particular output job. Can be given
                                      multiple times to run multiple jobs.
   --run-jobs                         Run all existing output jobs.
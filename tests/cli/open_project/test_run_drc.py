@@ -1,6 +1,8 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 
+import json
+
 import params
 import pytest
 from helpers import nofmt
@@ -206,3 +208,60 @@ Run DRC...
 Finished with errors!
 """)
     assert code == 1
+
+
+@pytest.mark.parametrize("project", [params.EMPTY_PROJECT_LPP_PARAM])
+def test_profile_as_table(cli, project):
+    cli.add_project(project.dir, as_lppz=project.is_lppz)
+    code, stdout, stderr = cli.run(
+        "open-project", "--drc", "--drc-profile=table", project.path
+    )
+    assert stderr == ""
+    lines = stdout.splitlines()
+    assert lines[0:5] == [
+        f"Open project '{project.path}'...",
+        "Run DRC...",
+        "  Board 'default':",
+        "    Approved messages: 0",
+        "    Non-approved messages: 0",
+    ]
+    assert lines[5] == "    Profile:"
+    assert lines[6].startswith("      Total time:")
+    assert "      Jobs (executed in parallel):" in lines
+    assert any("checkCopperCopperClearances" in line for line in lines)
+    assert lines[-1] == "SUCCESS"
+    assert code == 0
+
+
+@pytest.mark.parametrize("project", [params.EMPTY_PROJECT_LPP_PARAM])
+def test_profile_as_json(cli, project):
+    cli.add_project(project.dir, as_lppz=project.is_lppz)
+    code, stdout, stderr = cli.run(
+        "open-project", "--drc", "--drc-profile=json", project.path
+    )
+    assert stderr == ""
+    lines = stdout.splitlines()
+    assert lines[-1] == "SUCCESS"
+    profile = json.loads(lines[-2].strip())
+    assert profile["elapsed_time_ms"] >= 0
+    assert profile["items"]["devices"] == 0
+    names = [job["name"] for job in profile["jobs"]]
+    assert "checkCopperBoardClearances" in names
+    assert code == 0
+
+
+@pytest.mark.parametrize("project", [params.EMPTY_PROJECT_LPP_PARAM])
+def test_profile_with_invalid_format(cli, project):
+    cli.add_project(project.dir, as_lppz=project.is_lppz)
+    code, stdout, stderr = cli.run(
+        "open-project", "--drc", "--drc-profile=foo", project.path
+    )
+    assert stderr == nofmt("""\
+ERROR: Unknown DRC profile format 'foo'.
+""")
+    assert stdout == nofmt(f"""\
+Open project '{project.path}'...
+Run DRC...
+Finished with errors!
+""")
+    assert code == 1
@@ -191,6 +191,69 @@ TEST_F(OccModelTest, testBuildAndSaveAssembly) {
   std::unique_ptr<OccModel> outModel = OccModel::loadStep(outContent);
 }
 
+// Adding the same model multiple times must reference the same shapes instead
+// of copying them, but with separate locations and names per instance.
+TEST_F(OccModelTest, testAddSameModelMultipleTimes) {
+  if (!OccModel::isAvailable()) {
+    GTEST_SKIP();
+  }
+
+  const QString dir = TEST_DATA_DIR "/unittests/librepcbcommon/OccModelTest/";
+  std::unique_ptr<OccModel> model1 = OccModel::loadStep(
+      FileUtils::readFile(FilePath(dir % "colors.step")));
+  std::unique_ptr<OccModel> model2 =
+      OccModel::loadStep(FileUtils::readFile(FilePath(dir % "model.step")));
+  const Point3D pos(Length(0), Length(0), Length(0));
+  const Angle3D rot(Angle::deg0(), Angle::deg0(), Angle::deg0());
+
+  std::unique_ptr<OccModel> assembly =
+      OccModel::createAssembly("Test Assembly");
+  assembly->addToAssembly(*model1, pos, rot,
+                          Transform(Point(10000000, 0), Angle::deg0(), false),
+                          "X1");
+  assembly->addToAssembly(*model1, pos, rot,
+                          Transform(Point(20000000, 0), Angle::deg0(), false),
+                          "X2");
+  assembly->addToAssembly(*model2, pos, rot,
+                          Transform(Point(30000000, 0), Angle::deg0(), false),
+                          "X3");
+
+  const QVector<OccModel::AssemblyComponent> cmps =
+      assembly->getAssemblyComponents();
+  ASSERT_EQ(3, cmps.count());
+  const OccModel::AssemblyComponent& x1 = cmps.at(0);
+  const OccModel::AssemblyComponent& x2 = cmps.at(1);
+  const OccModel::AssemblyComponent& x3 = cmps.at(2);
+
+  // Names are per instance, shape names are independent of the instances.
+  EXPECT_EQ("X1", x1.name.toStdString());
+  EXPECT_EQ("X2", x2.name.toStdString());
+  EXPECT_EQ("X3", x3.name.toStdString());
+  EXPECT_EQ(x1.shapeNames, x2.shapeNames);
+  for (const QString& name : x1.shapeNames + x3.shapeNames) {
+    for (const QString& cmpName : {"X1", "X2", "X3"}) {
+      EXPECT_FALSE(name.startsWith(cmpName)) << name.toStdString();
+    }
+  }
+
+  // Identical models share their shape labels, different models don't.
+  ASSERT_FALSE(x1.shapeEntries.isEmpty());
+  ASSERT_FALSE(x3.shapeEntries.isEmpty());
+  EXPECT_EQ(x1.shapeEntries, x2.shapeEntries);
+  for (const QString& entry : x3.shapeEntries) {
+    EXPECT_FALSE(x1.shapeEntries.contains(entry)) << entry.toStdString();
+  }
+
+  // Locations are per instance.
+  EXPECT_NEAR(10, x1.location(0, 3), 0.001);
+  EXPECT_NEAR(20, x2.location(0, 3), 0.001);
+  EXPECT_NEAR(30, x3.location(0, 3), 0.001);
+
+  // Colors are also available for the second instance.
+  EXPECT_FALSE(x1.colors.isEmpty());
+  EXPECT_EQ(x1.colors, x2.colors);
+}
+
 TEST_F(OccModelTest, testTesselate) {
   if (OccModel::isAvailable()) {
     const FilePath fp(TEST_DATA_DIR
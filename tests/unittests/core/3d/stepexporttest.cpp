@@ -0,0 +1,119 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/core/3d/occmodel.h>
+#include <librepcb/core/3d/scenedata3d.h>
+#include <librepcb/core/3d/stepexport.h>
+#include <librepcb/core/fileio/filepath.h>
+#include <librepcb/core/fileio/fileutils.h>
+#include <librepcb/core/fileio/transactionalfilesystem.h>
+#include <librepcb/core/geometry/path.h>
+#include <librepcb/core/types/layer.h>
+#include <librepcb/core/utils/transform.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class StepExportTest : public ::testing::Test {};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+// Export many devices using only a few different STEP models. Since identical
+// models are added only once to the assembly, the file must be smaller than
+// an assembly which loaded the STEP model of every device separately. The
+// assembly structure itself is checked in OccModelTest.
+TEST_F(StepExportTest, testExportSharedModels) {
+  if (!OccModel::isAvailable()) {
+    GTEST_SKIP();
+  }
+
+  const FilePath modelFp(TEST_DATA_DIR
+                         "/unittests/librepcbcommon/OccModelTest/model.step");
+  const QByteArray content = FileUtils::readFile(modelFp);
+  const FilePath dir = FilePath::getRandomTempPath();
+  for (int i = 0; i < 4; ++i) {
+    // Add a comment to get different content hashes.
+    QByteArray modified = content;
+    modified.insert(modified.indexOf('\n') + 1,
+                    "/* " % QByteArray::number(i) % " */\n");
+    FileUtils::writeFile(dir.getPathTo(QString("%1.step").arg(i)), modified);
+  }
+
+  std::shared_ptr<SceneData3D> data =
+      std::make_shared<SceneData3D>(TransactionalFileSystem::openRO(dir));
+  data->setProjectName("Test");
+  data->addArea(Layer::boardOutlines(),
+                Path::rect(Point(0, 0), Point(100000000, 100000000)),
+                Transform());
+  for (int i = 0; i < 20; ++i) {
+    const Point pos(Length((i % 5) * 5000000), Length((i / 5) * 5000000));
+    data->addDevice(Uuid::createRandom(),
+                    Transform(pos, Angle::deg90() * (i % 4), (i % 3) == 0),
+                    QString("%1.step").arg(i % 4), Point3D(), Angle3D(),
+                    QString("R%1").arg(i + 1));
+  }
+
+  // Export with deduplicated models.
+  const FilePath outFp = dir.getPathTo("out/shared.step");
+  StepExport exp;
+  exp.start(data, outFp);
+  EXPECT_EQ("", exp.waitForFinished().toStdString());
+  const qint64 sharedSize = QFileInfo(outFp.toStr()).size();
+
+  // Export with a separately loaded model per device.
+  std::unique_ptr<OccModel> assembly = OccModel::createAssembly("Test");
+  for (const auto& obj : data->getDevices()) {
+    std::unique_ptr<OccModel> devModel =
+        OccModel::loadStep(data->getFileSystem()->readIfExists(obj.stepFile));
+    assembly->addToAssembly(*devModel, obj.stepPosition, obj.stepRotation,
+                            obj.transform, obj.name);
+  }
+  const FilePath separateFp = dir.getPathTo("out/separate.step");
+  assembly->saveAsStep("Test", separateFp);
+  const qint64 separateSize = QFileInfo(separateFp.toStr()).size();
+
+  // Read back.
+  EXPECT_NO_THROW(OccModel::loadStep(FileUtils::readFile(outFp)));
+  EXPECT_GT(sharedSize, 0);
+  EXPECT_LT(sharedSize, separateSize);
+
+  FileUtils::removeDirRecursively(dir);
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -0,0 +1,214 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/core/3d/occmodel.h>
+#include <librepcb/core/3d/tesselationcache.h>
+#include <librepcb/core/fileio/filepath.h>
+#include <librepcb/core/fileio/fileutils.h>
+#include <librepcb/core/utils/toolbox.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class TesselationCacheTest : public ::testing::Test {
+protected:
+  FilePath mTmpDir;
+
+  TesselationCacheTest() : mTmpDir(FilePath::getRandomTempPath()) {}
+
+  ~TesselationCacheTest() override {
+    QDir(mTmpDir.toStr()).removeRecursively();
+  }
+
+  static TesselationCache::Model createModel(int vertices) noexcept {
+    TesselationCache::Model model;
+    QVector<QVector3D>& red = model[std::make_tuple(1.0, 0.0, 0.0, 1.0)];
+    QVector<QVector3D>& gray = model[std::make_tuple(0.5, 0.5, 0.5, 0.8)];
+    for (int i = 0; i < vertices; ++i) {
+      red.append(QVector3D(i, -i, 0.5f * i));
+      gray.append(QVector3D(0.25f * i, 3, -i));
+    }
+    model[std::make_tuple(0.0, 0.0, 1.0, 1.0)];  // Empty group.
+    return model;
+  }
+
+  static QDateTime getModificationTime(const FilePath& fp) noexcept {
+    return QFileInfo(fp.toStr()).lastModified();
+  }
+
+  static void setModificationTime(const FilePath& fp, const QDateTime& dt) {
+    QFile file(fp.toStr());
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(dt, QFileDevice::FileModificationTime));
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(TesselationCacheTest, testSerializeDeserialize) {
+  const TesselationCache::Model model = createModel(100);
+  const QByteArray data = TesselationCache::serialize(model);
+  std::optional<TesselationCache::Model> result =
+      TesselationCache::deserialize(data.constData(), data.size());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(model, *result);
+}
+
+TEST_F(TesselationCacheTest, testDeserializeInvalidData) {
+  const QByteArray data = TesselationCache::serialize(createModel(10));
+  for (qint64 size : {qint64(0), qint64(8), qint64(data.size() - 1)}) {
+    EXPECT_FALSE(TesselationCache::deserialize(data.constData(), size));
+  }
+  QByteArray wrongMagic = data;
+  wrongMagic[0] = 'X';
+  EXPECT_FALSE(
+      TesselationCache::deserialize(wrongMagic.constData(), wrongMagic.size()));
+  QByteArray wrongVersion = data;
+  wrongVersion[4] = 99;
+  EXPECT_FALSE(TesselationCache::deserialize(wrongVersion.constData(),
+                                             wrongVersion.size()));
+}
+
+TEST_F(TesselationCacheTest, testStoreAndLoad) {
+  const TesselationCache::Model model1 = createModel(10);
+  const TesselationCache::Model model2 = createModel(20);
+
+  TesselationCache cache(mTmpDir);
+  EXPECT_FALSE(cache.load("step 1"));
+  cache.store("step 1", model1);
+  cache.store("step 2", model2);
+  EXPECT_EQ(model1, cache.load("step 1"));
+  EXPECT_EQ(model2, cache.load("step 2"));
+  EXPECT_FALSE(cache.load("step 3"));
+  EXPECT_EQ(2, cache.getHitCount());
+  EXPECT_EQ(2, cache.getMissCount());
+
+  // Check persistence.
+  TesselationCache cache2(mTmpDir);
+  EXPECT_EQ(model2, cache2.load("step 2"));
+  EXPECT_EQ(1, cache2.getHitCount());
+  EXPECT_EQ(0, cache2.getMissCount());
+
+  // Corrupt files must be treated as a miss.
+  for (const FilePath& fp : FileUtils::getFilesInDirectory(mTmpDir)) {
+    FileUtils::writeFile(fp, "corrupt");
+  }
+  EXPECT_FALSE(cache2.load("step 1"));
+  EXPECT_EQ(1, cache2.getMissCount());
+
+  // Clear.
+  cache.store("step 1", model1);
+  cache.clear();
+  EXPECT_FALSE(cache.load("step 1"));
+  EXPECT_TRUE(FileUtils::getFilesInDirectory(mTmpDir).isEmpty());
+}
+
+TEST_F(TesselationCacheTest, testLoadUpdatesModificationTime) {
+  TesselationCache cache(mTmpDir);
+  cache.store("step", createModel(10));
+  const QList<FilePath> files = FileUtils::getFilesInDirectory(mTmpDir);
+  ASSERT_EQ(1, files.count());
+  const QDateTime old = QDateTime::currentDateTime().addDays(-10);
+  setModificationTime(files.first(), old);
+  ASSERT_LT(getModificationTime(files.first()), old.addDays(1));
+
+  ASSERT_TRUE(cache.load("step"));
+  EXPECT_GT(getModificationTime(files.first()), old.addDays(1));
+}
+
+TEST_F(TesselationCacheTest, testSizeLimit) {
+  const TesselationCache::Model model = createModel(1000);
+  const qint64 fileSize = TesselationCache::serialize(model).size();
+
+  // Fill the cache up to its size limit. Set the modification times
+  // explicitly to get a well-defined usage order, with the first model being
+  // the least recently used.
+  TesselationCache cache(mTmpDir, fileSize * 10);
+  const QDateTime base = QDateTime::currentDateTime().addDays(-1);
+  for (int i = 0; i < 10; ++i) {
+    const QSet<FilePath> files =
+        Toolbox::toSet(FileUtils::getFilesInDirectory(mTmpDir));
+    cache.store(QString("step %1").arg(i).toUtf8(), model);
+    const QSet<FilePath> newFiles =
+        Toolbox::toSet(FileUtils::getFilesInDirectory(mTmpDir)) - files;
+    ASSERT_EQ(1, newFiles.count());
+    setModificationTime(*newFiles.begin(), base.addSecs(60 * i));
+  }
+  EXPECT_EQ(10, FileUtils::getFilesInDirectory(mTmpDir).count());
+
+  // Use the first model, thus the second one is now least recently used.
+  ASSERT_TRUE(cache.load("step 0"));
+
+  // Exceeding the size limit removes the least recently used entries until
+  // 3/4 of the size limit is reached.
+  cache.store("step 10", model);
+  qint64 totalSize = 0;
+  for (const FilePath& fp : FileUtils::getFilesInDirectory(mTmpDir)) {
+    totalSize += QFileInfo(fp.toStr()).size();
+  }
+  EXPECT_EQ(fileSize * 7, totalSize);
+  EXPECT_TRUE(cache.load("step 0"));  // Recently used.
+  for (int i = 1; i < 5; ++i) {
+    EXPECT_FALSE(cache.load(QString("step %1").arg(i).toUtf8()));  // Old.
+  }
+  for (int i = 5; i < 11; ++i) {
+    EXPECT_TRUE(cache.load(QString("step %1").arg(i).toUtf8()));  // Newer.
+  }
+}
+
+TEST_F(TesselationCacheTest, testStoreAndLoadStepModel) {
+  if (!OccModel::isAvailable()) {
+    GTEST_SKIP();
+  }
+
+  const FilePath modelFp(TEST_DATA_DIR
+                         "/unittests/librepcbcommon/OccModelTest/model.step");
+  const QByteArray content = FileUtils::readFile(modelFp);
+  const TesselationCache::Model model =
+      OccModel::loadStep(content)->tesselate();
+  ASSERT_FALSE(model.isEmpty());
+
+  TesselationCache cache(mTmpDir);
+  cache.store(content, model);
+  TesselationCache cache2(mTmpDir);
+  EXPECT_EQ(model, cache2.load(content));
+  EXPECT_EQ(1, cache2.getHitCount());
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -26,6 +26,9 @@
 
 #include <QtCore>
 
+#include <limits>
+#include <numeric>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -180,6 +183,116 @@ TEST_F(AirWiresBuilderTest, testPartlyConnectedCollinearPoints) {
   EXPECT_EQ(expected, airwires);
 }
 
+TEST_F(AirWiresBuilderTest, testMinimumSpanningTree) {
+  // Points 0, 1 and 2 are already connected, 3 and 4 are unconnected.
+  const QVector<AirWiresBuilder::Edge> edges = {
+      {0, 1, -1}, {1, 2, -1}, {0, 3, 100}, {2, 3, 50},
+      {3, 4, 10}, {0, 4, 5},  {1, 4, 7},
+  };
+  AirWiresBuilder::AirWires airwires =
+      sorted(AirWiresBuilder::buildMinimumSpanningTree(5, edges));
+  AirWiresBuilder::AirWires expected = {
+      {0, 4},
+      {3, 4},
+  };
+  EXPECT_EQ(expected, airwires);
+}
+
+TEST_F(AirWiresBuilderTest, testMinimumSpanningTreeLargeNets) {
+  // Nets of different sizes with points arranged in a grid where every second
+  // row is already connected by traces. The results are checked to connect
+  // all points with minimum total weight.
+  foreach (const int count, QVector<int>({10, 1000, 100000})) {
+    const int columns = std::max(qRound(std::sqrt(count)), 1);
+    QVector<AirWiresBuilder::Edge> edges;
+    QHash<AirWiresBuilder::AirWire, qreal> weights;
+    int connectedEdges = 0;
+    for (int i = 0; i < count; ++i) {
+      const int x = i % columns;
+      const int y = i / columns;
+      if ((x > 0) && (y % 2 == 1)) {
+        edges.append(AirWiresBuilder::Edge{i - 1, i, -1});
+        ++connectedEdges;
+      } else if (x > 0) {
+        edges.append(AirWiresBuilder::Edge{i - 1, i, qreal(1 + (i % 7))});
+      }
+      if (y > 0) {
+        edges.append(
+            AirWiresBuilder::Edge{i - columns, i, qreal(1 + (i % 5))});
+      }
+    }
+    for (const AirWiresBuilder::Edge& edge : edges) {
+      weights.insert(std::make_pair(edge.p1, edge.p2), edge.weight);
+    }
+
+    const AirWiresBuilder::AirWires airwires =
+        AirWiresBuilder::buildMinimumSpanningTree(count, edges);
+    EXPECT_EQ(count - 1 - connectedEdges, airwires.count());
+
+    // All points must be connected by traces and air wires.
+    QVector<int> components(count);
+    std::iota(components.begin(), components.end(), 0);
+    auto findRoot = [&components](int i) {
+      while (components[i] != i) {
+        i = components[i] = components[components[i]];
+      }
+      return i;
+    };
+    int componentCount = count;
+    auto connect = [&](int p1, int p2) {
+      const int root1 = findRoot(p1);
+      const int root2 = findRoot(p2);
+      if (root1 != root2) {
+        components[root1] = root2;
+        --componentCount;
+      }
+    };
+    for (const AirWiresBuilder::Edge& edge : edges) {
+      if (edge.weight < 0) {
+        connect(edge.p1, edge.p2);
+      }
+    }
+    qreal weight = 0;
+    for (AirWiresBuilder::AirWire airwire : sorted(airwires)) {
+      ASSERT_TRUE(weights.contains(airwire));
+      weight += weights.value(airwire);
+      connect(airwire.first, airwire.second);
+    }
+    EXPECT_EQ(1, componentCount);
+
+    // Compare the total weight with a simple O(n^2) implementation of Prim's
+    // algorithm, treating connected edges as weight zero. Skipped for the
+    // largest net since it would take too long.
+    if (count <= 1000) {
+      QVector<QVector<std::pair<int, qreal>>> neighbors(count);
+      for (const AirWiresBuilder::Edge& edge : edges) {
+        const qreal w = std::max(edge.weight, qreal(0));
+        neighbors[edge.p1].append(std::make_pair(edge.p2, w));
+        neighbors[edge.p2].append(std::make_pair(edge.p1, w));
+      }
+      QVector<qreal> distances(count, std::numeric_limits<qreal>::max());
+      QVector<bool> done(count, false);
+      distances[0] = 0;
+      qreal expectedWeight = 0;
+      for (int n = 0; n < count; ++n) {
+        int next = -1;
+        for (int i = 0; i < count; ++i) {
+          if ((!done[i]) && ((next < 0) || (distances[i] < distances[next]))) {
+            next = i;
+          }
+        }
+        done[next] = true;
+        expectedWeight += distances[next];
+        for (const auto& neighbor : neighbors[next]) {
+          distances[neighbor.first] =
+              std::min(distances[neighbor.first], neighbor.second);
+        }
+      }
+      EXPECT_EQ(expectedWeight, weight);
+    }
+  }
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
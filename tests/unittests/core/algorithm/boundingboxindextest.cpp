@@ -0,0 +1,191 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/core/algorithm/boundingboxindex.h>
+
+#include <QtCore>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class BoundingBoxIndexTest : public ::testing::Test {
+protected:
+  typedef BoundingBoxIndex::Rect Rect;
+  typedef BoundingBoxIndex::Pair Pair;
+
+  static QVector<Pair> bruteForcePairs(const QVector<Rect>& rects) noexcept {
+    QVector<Pair> pairs;
+    for (int i = 0; i < rects.count(); ++i) {
+      for (int k = i + 1; k < rects.count(); ++k) {
+        if (rects.at(i).isValid() && rects.at(k).isValid() &&
+            rects.at(i).overlaps(rects.at(k))) {
+          pairs.append(std::make_pair(i, k));
+        }
+      }
+    }
+    return pairs;
+  }
+
+  // Grid of n*n boxes, each overlapping only with its 8 direct neighbors.
+  static void fillGrid(BoundingBoxIndex& index, int n) noexcept {
+    for (int x = 0; x < n; ++x) {
+      for (int y = 0; y < n; ++y) {
+        index.insert(x * n + y,
+                     Rect{x * 100, y * 100, x * 100 + 150, y * 100 + 150});
+      }
+    }
+  }
+  static int expectedGridPairs(int n) noexcept {
+    return (2 * n * (n - 1)) + (2 * (n - 1) * (n - 1));
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(BoundingBoxIndexTest, testRectFromPaths) {
+  EXPECT_FALSE(Rect::fromPaths({}).isValid());
+
+  ClipperLib::Paths paths(2);
+  paths[0].push_back(ClipperLib::IntPoint(10, 20));
+  paths[0].push_back(ClipperLib::IntPoint(-30, 40));
+  paths[1].push_back(ClipperLib::IntPoint(50, -60));
+  const Rect rect = Rect::fromPaths(paths);
+  EXPECT_TRUE(rect.isValid());
+  EXPECT_EQ(-30, rect.minX);
+  EXPECT_EQ(-60, rect.minY);
+  EXPECT_EQ(50, rect.maxX);
+  EXPECT_EQ(40, rect.maxY);
+}
+
+TEST_F(BoundingBoxIndexTest, testEmpty) {
+  BoundingBoxIndex index;
+  EXPECT_EQ(0, index.getCount());
+  EXPECT_EQ(QVector<Pair>{}, index.findOverlappingPairs());
+  EXPECT_EQ(QVector<int>{}, index.query(Rect{0, 0, 100, 100}));
+}
+
+TEST_F(BoundingBoxIndexTest, testInvalidRectsAreIgnored) {
+  BoundingBoxIndex index;
+  index.insert(1, Rect());
+  index.insert(2, Rect{0, 0, 100, 100});
+  EXPECT_EQ(1, index.getCount());
+  EXPECT_EQ(QVector<Pair>{}, index.findOverlappingPairs());
+  EXPECT_EQ(QVector<int>{}, index.query(Rect()));
+}
+
+TEST_F(BoundingBoxIndexTest, testTouchingRectsOverlap) {
+  BoundingBoxIndex index;
+  index.insert(5, Rect{0, 0, 100, 100});
+  index.insert(3, Rect{100, 100, 200, 200});
+  index.insert(7, Rect{201, 0, 300, 100});
+  EXPECT_EQ(QVector<Pair>{std::make_pair(3, 5)}, index.findOverlappingPairs());
+  EXPECT_EQ((QVector<int>{3, 7}), index.query(Rect{150, 90, 250, 110}));
+}
+
+TEST_F(BoundingBoxIndexTest, testLargeItems) {
+  BoundingBoxIndex index;
+  fillGrid(index, 10);  // IDs 0..99
+  index.insert(100, Rect{-10000, -10000, 10000, 10000});  // Covers everything.
+  index.insert(101, Rect{-20000, -20000, -15000, -15000});  // Far away.
+  index.insert(102, Rect{-20000, -20000, 20000, -9000});  // Overlaps 100+101.
+
+  const QVector<Pair> pairs = index.findOverlappingPairs();
+  EXPECT_EQ(expectedGridPairs(10) + 100 + 2, pairs.count());
+  EXPECT_TRUE(pairs.contains(std::make_pair(100, 102)));
+  EXPECT_TRUE(pairs.contains(std::make_pair(101, 102)));
+  EXPECT_FALSE(pairs.contains(std::make_pair(100, 101)));
+
+  EXPECT_EQ((QVector<int>{0, 100}), index.query(Rect{0, 0, 10, 10}));
+  EXPECT_EQ((QVector<int>{101, 102}),
+            index.query(Rect{-19000, -19000, -18000, -18000}));
+}
+
+TEST_F(BoundingBoxIndexTest, testModificationRebuildsGrid) {
+  BoundingBoxIndex index;
+  index.insert(0, Rect{0, 0, 100, 100});
+  EXPECT_EQ(QVector<Pair>{}, index.findOverlappingPairs());
+  index.insert(1, Rect{50, 50, 5000, 5000});
+  EXPECT_EQ(QVector<Pair>{std::make_pair(0, 1)}, index.findOverlappingPairs());
+  index.clear();
+  EXPECT_EQ(0, index.getCount());
+  EXPECT_EQ(QVector<Pair>{}, index.findOverlappingPairs());
+}
+
+TEST_F(BoundingBoxIndexTest, testRandomRectsMatchBruteForce) {
+  QRandomGenerator rng(42);
+  QVector<Rect> rects;
+  BoundingBoxIndex index;
+  for (int i = 0; i < 2000; ++i) {
+    const qint64 x = rng.bounded(-1000000, 1000000);
+    const qint64 y = rng.bounded(-1000000, 1000000);
+    // Mostly small rects, but some very large ones.
+    const qint64 size = (i % 100 == 0) ? rng.bounded(100000, 1000000)
+                                       : rng.bounded(0, 30000);
+    const Rect rect{x, y, x + size, y + rng.bounded(0, 30000)};
+    rects.append(rect);
+    index.insert(i, rect);
+  }
+  EXPECT_EQ(bruteForcePairs(rects), index.findOverlappingPairs());
+
+  const Rect area{-50000, -50000, 50000, 80000};
+  QVector<int> expected;
+  for (int i = 0; i < rects.count(); ++i) {
+    if (rects.at(i).overlaps(area)) {
+      expected.append(i);
+    }
+  }
+  EXPECT_EQ(expected, index.query(area));
+}
+
+TEST_F(BoundingBoxIndexTest, testScaling) {
+  // Verify that the number of comparisons does not grow quadratically with
+  // the number of items. A quadratic algorithm would need ~256x more
+  // comparisons for the 16x larger grid, a linear one only ~16x.
+  BoundingBoxIndex small;
+  fillGrid(small, 100);  // 10k items
+  EXPECT_EQ(expectedGridPairs(100), small.findOverlappingPairs().count());
+
+  BoundingBoxIndex large;
+  fillGrid(large, 400);  // 160k items
+  EXPECT_EQ(expectedGridPairs(400), large.findOverlappingPairs().count());
+
+  EXPECT_GT(small.getComparisonCount(), 0);
+  EXPECT_LT(large.getComparisonCount(), small.getComparisonCount() * 32);
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -68,7 +68,6 @@ TEST_F(ExcellonGeneratorTest, testCircularDrills) {
   gen.drill(makeNonEmptyPath(Point(555, 666)), PositiveLength(500000), true,
             ExcellonGenerator::Function::ComponentDrill);
 
-  gen.generate();
   EXPECT_EQ(
       "M48\n"
       "; #@! TF.GenerationSoftware,LibrePCB,LibrePCB,0.1.2\n"
@@ -94,7 +93,7 @@ TEST_F(ExcellonGeneratorTest, testCircularDrills) {
       "X0.000333Y0.000444\n"
       "T0\n"
       "M30\n",
-      makeComparable(gen.toStr()));
+      makeComparable(gen.generate()));
 }
 
 TEST_F(ExcellonGeneratorTest, testSlotRout) {
@@ -111,7 +110,6 @@ TEST_F(ExcellonGeneratorTest, testSlotRout) {
             PositiveLength(500000), false,
             ExcellonGenerator::Function::MechanicalDrill);
 
-  gen.generate();
   EXPECT_EQ(
       "M48\n"
       "; #@! TF.GenerationSoftware,LibrePCB,LibrePCB,0.1.2\n"
@@ -137,7 +135,7 @@ TEST_F(ExcellonGeneratorTest, testSlotRout) {
       "G05\n"
       "T0\n"
       "M30\n",
-      makeComparable(gen.toStr()));
+      makeComparable(gen.generate()));
 }
 
 TEST_F(ExcellonGeneratorTest, testSlotG85) {
@@ -155,7 +153,6 @@ TEST_F(ExcellonGeneratorTest, testSlotG85) {
             PositiveLength(500000), false,
             ExcellonGenerator::Function::MechanicalDrill);
 
-  gen.generate();
   EXPECT_EQ(
       "M48\n"
       "; #@! TF.GenerationSoftware,LibrePCB,LibrePCB,0.1.2\n"
@@ -177,7 +174,7 @@ TEST_F(ExcellonGeneratorTest, testSlotG85) {
       "X0.000333Y0.000444G85X0.000555Y0.000666\n"
       "T0\n"
       "M30\n",
-      makeComparable(gen.toStr()));
+      makeComparable(gen.generate()));
 }
 
 TEST_F(ExcellonGeneratorTest, testCurvedSlotG85) {
@@ -189,8 +189,7 @@ protected:
           }
         }
       }
-      gen.generate();
-      cache[componentPins] = gen.toStr();
+      cache[componentPins] = gen.generate();
     }
     return cache[componentPins];
   }
@@ -234,6 +233,50 @@ TEST_F(GerberGeneratorTest, testDoesNotContainZeroSizeApertures) {
   ASSERT_GE(checkedCircles, 3);  // Sanity check if test works.
 }
 
+TEST_F(GerberGeneratorTest, testDensePour) {
+  // Build a pour consisting of many small polygons with many vertices.
+  QVector<Path> areas;
+  for (int i = 0; i < 200; ++i) {
+    Path path;
+    for (int k = 0; k < 2500; ++k) {
+      // Zig-zag outline like it is typical for pours around pads and traces.
+      path.addVertex(Point(Length(i * 1234567 + k * 997),
+                           Length(i * 7654321 - (k % 2) * 123457)));
+    }
+    areas.append(path.toClosedPath());
+  }
+
+  GerberGenerator gen(QDateTime::currentDateTime(), "Project Name",
+                      Uuid::createRandom(), "rev-1.0");
+  gen.setFileFunctionCopper(1, GerberGenerator::CopperSide::Top,
+                            GerberGenerator::Polarity::Positive);
+  foreach (const Path& area, areas) {
+    gen.drawPathArea(area, GerberAttribute::ApertureFunction::Conductor,
+                     QString("GND"), QString());
+  }
+  const QByteArray output = gen.generate();
+
+  // Every vertex must be written.
+  EXPECT_EQ(areas.count(), output.count("G36*\n"));
+  EXPECT_EQ(areas.count(), output.count("D02*\n"));
+  EXPECT_EQ(areas.count() * 2500, output.count("D01*\n"));
+  const Point& last = areas.last().getVertices().last().getPos();
+  EXPECT_TRUE(output.contains(QString("X%1Y%2D01*\n")
+                                  .arg(last.getX().toNmString(),
+                                       last.getY().toNmString())
+                                  .toUtf8()));
+
+  // Verify the checksum of the streamed file.
+  const int md5Pos = output.lastIndexOf("%TF.MD5,");
+  ASSERT_GT(md5Pos, 0);
+  const QByteArray expectedMd5 =
+      QCryptographicHash::hash(output.left(md5Pos).replace('\n', QByteArray()),
+                               QCryptographicHash::Md5)
+          .toHex();
+  EXPECT_EQ(expectedMd5.toStdString(),
+            output.mid(md5Pos + 8, 32).toStdString());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
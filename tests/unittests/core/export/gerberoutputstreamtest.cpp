@@ -0,0 +1,135 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+
+#include <gtest/gtest.h>
+#include <librepcb/core/exceptions.h>
+#include <librepcb/core/export/gerberoutputstream.h>
+#include <librepcb/core/types/angle.h>
+#include <librepcb/core/types/length.h>
+#include <librepcb/core/utils/toolbox.h>
+
+#include <QtCore>
+
+#include <limits>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class GerberOutputStreamTest : public ::testing::Test {};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(GerberOutputStreamTest, testNumberFormatting) {
+  const QVector<qint64> values = {0,
+                                   1,
+                                   -1,
+                                   9,
+                                   10,
+                                   333,
+                                   -5,
+                                   120000,
+                                   999999,
+                                   1000000,
+                                   -1000000,
+                                   1000001,
+                                   1234567,
+                                   -1234567,
+                                   100000000,
+                                   -100000000,
+                                   std::numeric_limits<qint64>::max(),
+                                   std::numeric_limits<qint64>::min() + 1};
+  foreach (qint64 value, values) {
+    GerberOutputStream s;
+    s.writeNm(Length(value)).write(' ').writeMm(Length(value));
+    const QString expected = Length(value).toNmString() % " " %
+        Toolbox::decimalFixedPointToString<int64_t>(value, 6);
+    EXPECT_EQ(expected.toStdString(), s.getData().toStdString()) << value;
+  }
+}
+
+TEST_F(GerberOutputStreamTest, testAngleFormatting) {
+  const QVector<qint32> values = {0,         1,         -1,
+                                   45000000,  -45000000, 90000000,
+                                   123456,    359999999, -359999999};
+  foreach (qint32 value, values) {
+    GerberOutputStream s;
+    s.writeDeg(Angle(value));
+    EXPECT_EQ(Angle(value).toDegString().toStdString(),
+              s.getData().toStdString())
+        << value;
+  }
+}
+
+TEST_F(GerberOutputStreamTest, testStringEncoding) {
+  GerberOutputStream s;
+  s.write('A').write("BC").write(QByteArray("DE")).write(QString("Fä"));
+  s.writeInteger(-42);
+  EXPECT_EQ(QString("ABCDEFä-42").toUtf8(), s.getData());
+}
+
+TEST_F(GerberOutputStreamTest, testStreamToDevice) {
+  QByteArray expected;
+  QByteArray output;
+  QBuffer buffer(&output);
+  buffer.open(QIODevice::WriteOnly);
+  GerberOutputStream s(&buffer, true);
+  for (int i = 0; i < 100000; ++i) {
+    s.write('X').writeInteger(i).write("*\n");
+    expected.append("X" % QByteArray::number(i) % "*\n");
+  }
+  const QByteArray largeChunk(200000, 'A');
+  s.write(largeChunk);
+  expected.append(largeChunk);
+  const QString md5 = s.getMd5Checksum();
+  EXPECT_EQ(expected.size(), output.size());
+  EXPECT_TRUE(expected == output);
+
+  const QString expectedMd5 = QString(
+      QCryptographicHash::hash(expected.replace('\n', QByteArray()),
+                               QCryptographicHash::Md5)
+          .toHex());
+  EXPECT_EQ(expectedMd5.toStdString(), md5.toStdString());
+}
+
+TEST_F(GerberOutputStreamTest, testWriteError) {
+  QBuffer buffer;  // Not opened -> write fails.
+  GerberOutputStream s(&buffer);
+  s.write("foo");
+  EXPECT_THROW(s.flush(), Exception);
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
@@ -88,6 +88,42 @@ TEST_F(PackageTest, testUpgradeV01) {
   { std::unique_ptr<Package> obj = Package::open(createDir()); }
 }
 
+TEST_F(PackageTest, testOpenMetadata) {
+  // Copy into temporary directory.
+  const FilePath src =
+      FilePath(TEST_DATA_DIR "/libraries/v0.1.lplib/pkg").getPathTo(sUuid);
+  FileUtils::copyDirRecursively(src, mTmpDir);
+
+  // Loading metadata is not possible if a migration is required.
+  EXPECT_EQ(nullptr, Package::openMetadata(createDir(false)));
+
+  // Upgrade.
+  {
+    std::unique_ptr<Package> obj = Package::open(createDir());
+    obj->save();
+    obj->getDirectory().getFileSystem()->save();
+  }
+
+  // Load metadata and compare with fully loaded package.
+  std::unique_ptr<Package> full = Package::open(createDir(false));
+  std::unique_ptr<Package> obj = Package::openMetadata(createDir(false));
+  ASSERT_NE(nullptr, obj);
+  EXPECT_FALSE(full->isMetadataOnly());
+  EXPECT_TRUE(obj->isMetadataOnly());
+  EXPECT_EQ(full->getUuid(), obj->getUuid());
+  EXPECT_EQ(full->getVersion(), obj->getVersion());
+  EXPECT_EQ(full->isDeprecated(), obj->isDeprecated());
+  EXPECT_EQ(full->getNames(), obj->getNames());
+  EXPECT_EQ(full->getCategories(), obj->getCategories());
+  EXPECT_FALSE(full->getPads().isEmpty());
+  EXPECT_FALSE(full->getFootprints().isEmpty());
+  EXPECT_TRUE(obj->getPads().isEmpty());
+  EXPECT_TRUE(obj->getFootprints().isEmpty());
+
+  // Saving must be refused to avoid losing data.
+  EXPECT_THROW(obj->save(), LogicError);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
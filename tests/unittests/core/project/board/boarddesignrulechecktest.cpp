@@ -25,13 +25,18 @@
 #include <librepcb/core/fileio/transactionalfilesystem.h>
 #include <librepcb/core/project/board/board.h>
 #include <librepcb/core/project/board/drc/boarddesignrulecheck.h>
+#include <librepcb/core/project/board/drc/boarddesignrulecheckmessages.h>
+#include <librepcb/core/project/board/items/bi_netsegment.h>
+#include <librepcb/core/project/board/items/bi_via.h>
 #include <librepcb/core/project/project.h>
 #include <librepcb/core/project/projectloader.h>
 #include <librepcb/core/serialization/sexpression.h>
+#include <librepcb/core/types/layer.h>
 #include <librepcb/core/utils/toolbox.h>
 
 #include <QtCore>
 
+#include <chrono>
 #include <memory>
 
 /*******************************************************************************
@@ -170,6 +175,122 @@ TEST(BoardDesignRuleCheckTest, testMultithreading) {
             << " ms\n";
 }
 
+TEST(BoardDesignRuleCheckTest, testManyCopperClearanceViolations) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Gerber Test/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+
+  // Add a grid of unconnected vias, far away from the existing board items.
+  // Each via overlaps with its horizontal and vertical neighbors, leading to
+  // at least 2*n*(n-1) copper clearance violations.
+  const int n = 80;
+  for (int x = 0; x < n; ++x) {
+    for (int y = 0; y < n; ++y) {
+      BI_NetSegment* segment =
+          new BI_NetSegment(*board, Uuid::createRandom(), nullptr);
+      board->addNetSegment(*segment);
+      const Point pos(-1000000000 + x * 500000, -1000000000 + y * 500000);
+      const Via via(Uuid::createRandom(), Layer::topCopper(),
+                    Layer::botCopper(), pos, PositiveLength(300000),
+                    PositiveLength(600000), MaskConfig::off());
+      segment->addElements({}, {new BI_Via(*segment, via)}, {}, {});
+    }
+  }
+  const int expectedViolations = 2 * n * (n - 1);
+  ASSERT_GT(expectedViolations, 10000);
+
+  // Run the quick check which includes the copper clearance check.
+  BoardDesignRuleCheck drc;
+  drc.start(*board, board->getDrcSettings(), true);
+  const BoardDesignRuleCheck::Result result = drc.waitForFinished();
+  EXPECT_EQ(0, result.errors.count());
+
+  // Each via pair must be reported exactly once.
+  int violations = 0;
+  QSet<SExpression> approvals;
+  for (const auto& msg : result.messages) {
+    if (msg->as<DrcMsgCopperCopperClearanceViolation>()) {
+      ++violations;
+      approvals.insert(msg->getApproval());
+    }
+  }
+  EXPECT_GE(violations, expectedViolations);
+  EXPECT_EQ(violations, approvals.count());
+
+  // The copper clearance check is split into several jobs, at least one per
+  // copper layer, and each of them counts its Clipper operations.
+  int copperClearanceJobs = 0;
+  quint64 copperClearanceOperations = 0;
+  for (const auto& job : result.jobs) {
+    if (job.name.startsWith("checkCopperCopperClearances")) {
+      ++copperClearanceJobs;
+      copperClearanceOperations += job.clipperOperations;
+    }
+  }
+  EXPECT_GE(copperClearanceJobs, 2);
+  EXPECT_GE(copperClearanceOperations, quint64(expectedViolations));
+}
+
+TEST(BoardDesignRuleCheckTest, testSubsequentRunsAfterModifications) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Gerber Test/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+
+  // Add a row of three unconnected vias, far away from the existing board
+  // items. Each via overlaps with its neighbors.
+  QList<BI_Via*> vias;
+  for (int i = 0; i < 3; ++i) {
+    BI_NetSegment* segment =
+        new BI_NetSegment(*board, Uuid::createRandom(), nullptr);
+    board->addNetSegment(*segment);
+    const Via via(Uuid::createRandom(), Layer::topCopper(), Layer::botCopper(),
+                  Point(-1000000000 + i * 500000, -1000000000),
+                  PositiveLength(300000), PositiveLength(600000),
+                  MaskConfig::off());
+    vias.append(new BI_Via(*segment, via));
+    segment->addElements({}, {vias.last()}, {}, {});
+  }
+
+  // The same DRC object is reused to make sure results of previous runs are
+  // not reused for modified objects.
+  BoardDesignRuleCheck drc;
+  auto run = [&]() {
+    drc.start(*board, board->getDrcSettings(), true);
+    const BoardDesignRuleCheck::Result result = drc.waitForFinished();
+    EXPECT_EQ(0, result.errors.count());
+    QSet<SExpression> approvals;
+    for (const auto& msg : result.messages) {
+      if (msg->as<DrcMsgCopperCopperClearanceViolation>()) {
+        approvals.insert(msg->getApproval());
+      }
+    }
+    return approvals;
+  };
+  const QSet<SExpression> initial = run();
+  EXPECT_EQ(2, initial.count());
+  EXPECT_EQ(initial, run());
+
+  // Move the last via away.
+  vias.last()->setPosition(Point(-900000000, -900000000));
+  EXPECT_EQ(1, run().count());
+
+  // Move the last via back.
+  vias.last()->setPosition(Point(-999000000, -1000000000));
+  EXPECT_EQ(initial, run());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -127,6 +127,54 @@ TEST(BoardGerberExportTest, test) {
   }
 }
 
+TEST(BoardGerberExportTest, testParallelExport) {
+  FilePath outDir = FilePath::getRandomTempPath();
+
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Gerber Test/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());
+  Board* board = project->getBoards().first();
+
+  // force planes rebuild
+  BoardPlaneFragmentsBuilder builder;
+  builder.runAndApply(*board);  // can throw
+
+  // Export with a single thread and with the default thread count.
+  auto exportFiles = [&](const QString& subDir, int threads) {
+    BoardFabricationOutputSettings config =
+        board->getFabricationOutputSettings();
+    config.setOutputBasePath(outDir.getPathTo(subDir).toStr() %
+                             "/{{PROJECT}}");
+    BoardGerberExport grbExport(*board);
+    grbExport.setThreadCount(threads);
+    grbExport.exportPcbLayers(config);
+    return grbExport.getWrittenFiles();
+  };
+  const QVector<FilePath> serial = exportFiles("serial", 1);
+  const QVector<FilePath> parallel = exportFiles("parallel", 0);
+
+  // Both must produce the same files in the same order, with the same content
+  // except volatile data.
+  auto normalize = [](const FilePath& fp) {
+    QString content = FileUtils::readFile(fp);
+    content.replace(QRegularExpression("TF\\.CreationDate,[^\\s\\*]*"), "");
+    content.replace(QRegularExpression(".*TF\\.MD5,.*"), "");
+    return content.toStdString();
+  };
+  ASSERT_EQ(serial.count(), parallel.count());
+  for (int i = 0; i < serial.count(); ++i) {
+    EXPECT_EQ(serial.at(i).getFilename().toStdString(),
+              parallel.at(i).getFilename().toStdString());
+    EXPECT_EQ(normalize(serial.at(i)), normalize(parallel.at(i)));
+  }
+  FileUtils::removeDirRecursively(outDir);
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -26,11 +26,15 @@
 #include <librepcb/core/fileio/transactionalfilesystem.h>
 #include <librepcb/core/project/board/board.h>
 #include <librepcb/core/project/board/boardplanefragmentsbuilder.h>
+#include <librepcb/core/project/board/items/bi_netsegment.h>
 #include <librepcb/core/project/board/items/bi_plane.h>
+#include <librepcb/core/project/board/items/bi_via.h>
+#include <librepcb/core/project/circuit/circuit.h>
 #include <librepcb/core/project/project.h>
 #include <librepcb/core/project/projectloader.h>
 #include <librepcb/core/serialization/sexpression.h>
 #include <librepcb/core/types/layer.h>
+#include <librepcb/core/utils/clipperhelpers.h>
 
 #include <QtCore>
 
@@ -175,6 +179,293 @@ TEST(BoardPlaneFragmentsBuilderTest, testManyThreads) {
             << " ms\n";
 }
 
+TEST(BoardPlaneFragmentsBuilderTest, testManyIndependentPlanes) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Nested Planes/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+  const QList<NetSignal*> netSignals =
+      project->getCircuit().getNetSignals().values();
+  ASSERT_GE(netSignals.count(), 2);
+
+  // Add a grid of planes on top and bottom, far away from the board. Each
+  // plane slightly overlaps with its neighbors which have alternating nets,
+  // thus they depend on each other but most of them can still be calculated
+  // in parallel. The board clearance is set to zero to avoid clipping the
+  // planes to the board outline.
+  QList<BI_Plane*> planes;
+  for (const Layer* layer : {&Layer::topCopper(), &Layer::botCopper()}) {
+    for (int x = 0; x < 6; ++x) {
+      for (int y = 0; y < 5; ++y) {
+        const Point pos(Length::fromMm(-1000 + x * 10),
+                        Length::fromMm(-1000 + y * 10));
+        const Path outline = Path::centeredRect(PositiveLength(11000000),
+                                                PositiveLength(11000000));
+        BI_Plane* plane = new BI_Plane(*board, Uuid::createRandom(), *layer,
+                                       netSignals.at((x + y) % 2),
+                                       outline.translated(pos));
+        plane->setMinClearanceToBoard(UnsignedLength(0));
+        plane->setPriority((x * y) % 3);
+        board->addPlane(*plane);
+        planes.append(plane);
+      }
+    }
+  }
+
+  // Build planes several times to check that the result is deterministic.
+  BoardPlaneFragmentsBuilder builder;
+  QHash<Uuid, QVector<Path>> firstResult;
+  for (int i = 0; i < 5; ++i) {
+    builder.start(*board);
+    BoardPlaneFragmentsBuilder::Result result = builder.waitForFinished();
+    EXPECT_EQ(0, result.errors.count());
+    EXPECT_TRUE(result.finished);
+    if (i == 0) {
+      firstResult = result.planes;
+    } else {
+      EXPECT_TRUE(result.planes == firstResult);
+    }
+  }
+
+  // Check that the fragments of neighboring planes with different nets do
+  // not overlap.
+  int overlappingPairs = 0;
+  for (int i = 0; i < planes.count(); ++i) {
+    const BI_Plane* plane1 = planes.at(i);
+    EXPECT_FALSE(firstResult.value(plane1->getUuid()).isEmpty());
+    for (int k = i + 1; k < planes.count(); ++k) {
+      const BI_Plane* plane2 = planes.at(k);
+      if ((&plane1->getLayer() != &plane2->getLayer()) ||
+          (plane1->getNetSignal() == plane2->getNetSignal())) {
+        continue;
+      }
+      ClipperLib::Paths paths1 = ClipperHelpers::convert(
+          firstResult.value(plane1->getUuid()), PositiveLength(5000));
+      const ClipperLib::Paths paths2 = ClipperHelpers::convert(
+          firstResult.value(plane2->getUuid()), PositiveLength(5000));
+      ClipperHelpers::intersect(paths1, paths2, ClipperLib::pftEvenOdd,
+                                ClipperLib::pftEvenOdd);
+      if (!paths1.empty()) {
+        ++overlappingPairs;
+      }
+    }
+  }
+  EXPECT_EQ(0, overlappingPairs);
+}
+
+// Calculate a board with many planes which do not depend on each other, once
+// serially and once in parallel. Both results must be identical.
+TEST(BoardPlaneFragmentsBuilderTest, testManyPlanesSerialAndParallel) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Nested Planes/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+  const QList<NetSignal*> netSignals =
+      project->getCircuit().getNetSignals().values();
+  ASSERT_GE(netSignals.count(), 2);
+
+  // Add a grid of 64 non-overlapping planes on top and bottom, far away from
+  // the board, each containing some vias of another net.
+  BI_NetSegment* segment =
+      new BI_NetSegment(*board, Uuid::createRandom(), netSignals.at(1));
+  board->addNetSegment(*segment);
+  QList<BI_Via*> vias;
+  for (const Layer* layer : {&Layer::topCopper(), &Layer::botCopper()}) {
+    for (int x = 0; x < 8; ++x) {
+      for (int y = 0; y < 4; ++y) {
+        const Point pos(Length::fromMm(-1000 + x * 12),
+                        Length::fromMm(-1000 + y * 12));
+        const Path outline = Path::centeredRect(PositiveLength(10000000),
+                                                PositiveLength(10000000));
+        BI_Plane* plane =
+            new BI_Plane(*board, Uuid::createRandom(), *layer,
+                         netSignals.at(0), outline.translated(pos));
+        plane->setMinClearanceToBoard(UnsignedLength(0));
+        board->addPlane(*plane);
+        if (layer == &Layer::topCopper()) {
+          for (int i = 0; i < 9; ++i) {
+            const Via via(Uuid::createRandom(), Layer::topCopper(),
+                          Layer::botCopper(),
+                          pos + Point::fromMm((i % 3) * 3 - 3, (i / 3) * 3 - 3),
+                          PositiveLength(300000), PositiveLength(600000),
+                          MaskConfig::off());
+            vias.append(new BI_Via(*segment, via));
+          }
+        }
+      }
+    }
+  }
+  segment->addElements({}, vias, {}, {});
+  ASSERT_GE(board->getPlanes().count(), 64);
+
+  auto run = [&]() {
+    BoardPlaneFragmentsBuilder builder;  // Without cached obstacles.
+    builder.start(*board);
+    BoardPlaneFragmentsBuilder::Result result = builder.waitForFinished();
+    EXPECT_EQ(0, result.errors.count());
+    EXPECT_TRUE(result.finished);
+    return result.planes;
+  };
+
+  // Serial calculation by limiting the thread pool to a single thread. The
+  // plane jobs are then executed by the waiting thread itself.
+  QThreadPool* pool = QThreadPool::globalInstance();
+  const int maxThreadCount = pool->maxThreadCount();
+  pool->setMaxThreadCount(1);
+  const QHash<Uuid, QVector<Path>> serial = run();
+  pool->setMaxThreadCount(maxThreadCount);
+
+  // Parallel calculation.
+  const QHash<Uuid, QVector<Path>> parallel = run();
+
+  EXPECT_EQ(board->getPlanes().count(), serial.count());
+  EXPECT_TRUE(serial == parallel);
+}
+
+TEST(BoardPlaneFragmentsBuilderTest, testSubsequentRunsAfterModifications) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Nested Planes/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+
+  // The same builder is reused to make sure cached obstacles of previous runs
+  // are not reused for modified objects. The result is compared with a new
+  // builder which has no cache.
+  BoardPlaneFragmentsBuilder builder;
+  auto run = [&]() {
+    builder.start(*board);
+    const BoardPlaneFragmentsBuilder::Result result = builder.waitForFinished();
+    EXPECT_EQ(0, result.errors.count());
+    EXPECT_TRUE(result.finished);
+    BoardPlaneFragmentsBuilder reference;
+    reference.start(*board);
+    EXPECT_TRUE(result.planes == reference.waitForFinished().planes);
+    return result.planes;
+  };
+  const QHash<Uuid, QVector<Path>> initial = run();
+  EXPECT_TRUE(initial == run());
+
+  // Add a via without net at the corner of each plane.
+  BI_NetSegment* segment =
+      new BI_NetSegment(*board, Uuid::createRandom(), nullptr);
+  board->addNetSegment(*segment);
+  QList<BI_Via*> vias;
+  foreach (const BI_Plane* plane, board->getPlanes()) {
+    const Via via(Uuid::createRandom(), Layer::topCopper(), Layer::botCopper(),
+                  plane->getOutline().getVertices().first().getPos(),
+                  PositiveLength(300000), PositiveLength(600000),
+                  MaskConfig::off());
+    vias.append(new BI_Via(*segment, via));
+  }
+  segment->addElements({}, vias, {}, {});
+  EXPECT_FALSE(initial == run());
+
+  // Increase the clearance of all planes.
+  foreach (BI_Plane* plane, board->getPlanes()) {
+    plane->setMinClearanceToCopper(
+        UnsignedLength(*plane->getMinClearanceToCopper() + Length(100000)));
+  }
+  const QHash<Uuid, QVector<Path>> modified = run();
+
+  // Revert all modifications.
+  segment->removeElements({}, vias, {}, {});
+  foreach (BI_Plane* plane, board->getPlanes()) {
+    plane->setMinClearanceToCopper(
+        UnsignedLength(*plane->getMinClearanceToCopper() - Length(100000)));
+  }
+  EXPECT_TRUE(initial == run());
+  EXPECT_FALSE(modified == initial);
+}
+
+TEST(BoardPlaneFragmentsBuilderTest, testPartialRebuild) {
+  // open project from test data directory
+  FilePath projectFp(TEST_DATA_DIR "/projects/Nested Planes/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+  const QSet<const Layer*> layers = board->getCopperLayers();
+
+  // Add a plane far away from all other planes, thus it never needs to be
+  // rebuilt when modifying something in the other planes, and vice versa.
+  BI_Plane* farPlane =
+      new BI_Plane(*board, Uuid::createRandom(), Layer::topCopper(), nullptr,
+                   Path::centeredRect(PositiveLength(10000000),
+                                      PositiveLength(10000000))
+                       .translated(Point::fromMm(-500, -500)));
+  farPlane->setMinClearanceToBoard(UnsignedLength(0));
+  board->addPlane(*farPlane);
+  BoardPlaneFragmentsBuilder builder;
+  builder.runAndApply(*board);  // can throw
+  ASSERT_FALSE(farPlane->getFragments().isEmpty());
+
+  // Helper to add a via without net.
+  BI_NetSegment* segment =
+      new BI_NetSegment(*board, Uuid::createRandom(), nullptr);
+  board->addNetSegment(*segment);
+  auto addVia = [&](const Point& pos) {
+    const Via via(Uuid::createRandom(), Layer::topCopper(), Layer::botCopper(),
+                  pos, PositiveLength(300000), PositiveLength(600000),
+                  MaskConfig::off());
+    BI_Via* biVia = new BI_Via(*segment, via);
+    segment->addElements({}, {biVia}, {}, {});
+    return biVia;
+  };
+
+  // Helper to compare the fragments with the result of a full rebuild.
+  auto checkFragments = [&]() {
+    BoardPlaneFragmentsBuilder reference;
+    reference.start(*board);
+    const QHash<Uuid, QVector<Path>> full = reference.waitForFinished().planes;
+    EXPECT_EQ(board->getPlanes().count(), full.count());
+    foreach (const BI_Plane* p, board->getPlanes()) {
+      EXPECT_TRUE(p->getFragments() == full.value(p->getUuid()));
+    }
+  };
+
+  // A via far away from all planes does not require any plane rebuild.
+  BI_Via* via = addVia(Point(-1000000000, -1000000000));
+  EXPECT_EQ(0, builder.runAndApply(*board, &layers).count());
+
+  // Move the via into the first plane -> partial rebuild which must not
+  // contain the far plane.
+  const BI_Plane* plane = board->getPlanes().first();
+  via->setPosition(plane->getOutline().getVertices().first().getPos());
+  const QHash<Uuid, QVector<Path>> partial =
+      builder.runAndApply(*board, &layers);  // can throw
+  EXPECT_TRUE(partial.contains(plane->getUuid()));
+  EXPECT_FALSE(partial.contains(farPlane->getUuid()));
+  EXPECT_LT(partial.count(), board->getPlanes().count());
+  checkFragments();
+
+  // Add a via into the far plane -> only the far plane is rebuilt.
+  const QVector<Path> farFragments = farPlane->getFragments();
+  addVia(Point::fromMm(-500, -500));
+  const QHash<Uuid, QVector<Path>> farPartial =
+      builder.runAndApply(*board, &layers);  // can throw
+  EXPECT_EQ(QList<Uuid>{farPlane->getUuid()}, farPartial.keys());
+  EXPECT_FALSE(farPlane->getFragments() == farFragments);
+  checkFragments();
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
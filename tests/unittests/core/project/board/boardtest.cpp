@@ -0,0 +1,120 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/core/fileio/transactionalfilesystem.h>
+#include <librepcb/core/project/board/board.h>
+#include <librepcb/core/project/board/items/bi_airwire.h>
+#include <librepcb/core/project/board/items/bi_netsegment.h>
+#include <librepcb/core/project/board/items/bi_via.h>
+#include <librepcb/core/project/circuit/circuit.h>
+#include <librepcb/core/project/project.h>
+#include <librepcb/core/project/projectloader.h>
+#include <librepcb/core/types/layer.h>
+
+#include <QSignalSpy>
+#include <QtCore>
+
+#include <memory>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class BoardTest : public ::testing::Test {
+protected:
+  static bool hasAirWireTo(const Board& board,
+                           const BI_NetLineAnchor* anchor) noexcept {
+    foreach (const BI_AirWire* airWire, board.getAirWires()) {
+      if ((&airWire->getP1() == anchor) || (&airWire->getP2() == anchor)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+// Removing (and deleting) an anchor while an asynchronous air wires rebuild is
+// pending must not lead to air wires referring to the deleted anchor.
+TEST_F(BoardTest, testRemoveAnchorDuringAsyncAirWiresRebuild) {
+  FilePath projectFp(TEST_DATA_DIR "/projects/Gerber Test/project.lpp");
+  std::shared_ptr<TransactionalFileSystem> projectFs =
+      TransactionalFileSystem::openRO(projectFp.getParentDir());
+  ProjectLoader loader;
+  std::unique_ptr<Project> project =
+      loader.open(std::make_unique<TransactionalDirectory>(projectFs),
+                  projectFp.getFilename());  // can throw
+  Board* board = project->getBoards().first();
+  NetSignal* net = project->getCircuit().getNetSignals().first();
+
+  // Add three unconnected vias of the same net, far away from other items.
+  BI_NetSegment* segment = new BI_NetSegment(*board, Uuid::createRandom(), net);
+  board->addNetSegment(*segment);
+  auto createVia = [&](const Point& pos) {
+    return new BI_Via(*segment,
+                      Via(Uuid::createRandom(), Layer::topCopper(),
+                          Layer::botCopper(), pos, PositiveLength(300000),
+                          PositiveLength(600000), MaskConfig::off()));
+  };
+  BI_Via* via1 = createVia(Point(-1000000000, -1000000000));
+  BI_Via* via2 = createVia(Point(-1000000000, -900000000));
+  BI_Via* via3 = createVia(Point(-1000000000, -800000000));
+  const BI_NetLineAnchor* via2Anchor = via2;
+  segment->addElements({}, {via1, via2, via3}, {}, {});
+  board->triggerAirWiresRebuild();
+  ASSERT_TRUE(hasAirWireTo(*board, via2Anchor));
+
+  // Start an asynchronous rebuild, then remove & delete the via before the
+  // result is applied. The old air wires are kept until then to avoid
+  // flickering.
+  board->scheduleAirWiresRebuild(net);
+  board->triggerAirWiresRebuildAsync();
+  EXPECT_TRUE(hasAirWireTo(*board, via2Anchor));
+  segment->removeElements({}, {via2}, {}, {});
+  delete via2;
+
+  // Start another asynchronous rebuild and wait until its result is applied.
+  // The outdated result of the first rebuild must be discarded.
+  QSignalSpy spy(board, &Board::airWireAdded);
+  board->triggerAirWiresRebuildAsync();
+  ASSERT_TRUE(spy.wait(10000));
+  EXPECT_FALSE(hasAirWireTo(*board, via2Anchor));
+  EXPECT_TRUE(hasAirWireTo(*board, via1));
+  EXPECT_TRUE(hasAirWireTo(*board, via3));
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace librepcb
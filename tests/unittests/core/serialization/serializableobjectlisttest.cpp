@@ -379,6 +379,77 @@ TEST_F(SerializableObjectListTest, testOperatorMove) {
   EXPECT_EQ(mMocks[1], l2[1]);
 }
 
+TEST_F(SerializableObjectListTest, testUuidIndexAfterModifications) {
+  // Large enough to use the UUID index.
+  List l;
+  for (int i = 0; i < 100; ++i) {
+    l.append(std::make_shared<Mock>(Uuid::createRandom(), QString::number(i)));
+  }
+  auto checkAll = [&l]() {
+    for (int i = 0; i < l.count(); ++i) {
+      EXPECT_EQ(i, l.indexOf(l[i]->getUuid()));
+    }
+  };
+  checkAll();
+
+  l.append(mMocks[0]);
+  EXPECT_EQ(100, l.indexOf(mMocks[0]->getUuid()));
+  l.insert(0, mMocks[1]);
+  EXPECT_EQ(0, l.indexOf(mMocks[1]->getUuid()));
+  EXPECT_EQ(101, l.indexOf(mMocks[0]->getUuid()));
+  checkAll();
+
+  l.remove(50);
+  l.swap(3, 70);
+  l.take(mMocks[1].get());
+  EXPECT_EQ(-1, l.indexOf(mMocks[1]->getUuid()));
+  checkAll();
+
+  // Changing the UUID of an element must be reflected by the index.
+  const Uuid oldUuid = l[10]->getUuid();
+  l[10]->mUuid = Uuid::createRandom();
+  l[10]->onEdited.notify();
+  EXPECT_EQ(-1, l.indexOf(oldUuid));
+  EXPECT_EQ(10, l.indexOf(l[10]->getUuid()));
+  checkAll();
+
+  // Editing an element without changing its UUID keeps the index valid.
+  l[15]->mName = "edited";
+  l[15]->onEdited.notify();
+  checkAll();
+
+  // Changing the UUID to the one of a preceding element.
+  const Uuid oldUuid2 = l[30]->getUuid();
+  l[30]->mUuid = l[5]->getUuid();
+  l[30]->onEdited.notify();
+  EXPECT_EQ(-1, l.indexOf(oldUuid2));
+  EXPECT_EQ(5, l.indexOf(l[30]->getUuid()));
+  l[30]->mUuid = oldUuid2;
+  l[30]->onEdited.notify();
+  checkAll();
+
+  // Duplicate UUIDs return the first element, like a linear search.
+  l.append(std::make_shared<Mock>(l[20]->getUuid(), "duplicate"));
+  EXPECT_EQ(20, l.indexOf(l[20]->getUuid()));
+  EXPECT_EQ(l[20], l.get(l[20]->getUuid()));
+
+  l.clear();
+  EXPECT_EQ(-1, l.indexOf(oldUuid));
+}
+
+TEST_F(SerializableObjectListTest, testUuidLookupLargeList) {
+  List l;
+  QVector<Uuid> uuids;
+  for (int i = 0; i < 10000; ++i) {
+    uuids.append(Uuid::createRandom());
+    l.append(std::make_shared<Mock>(uuids.last(), QString::number(i)));
+  }
+  for (int i = 0; i < uuids.count(); ++i) {
+    EXPECT_EQ(i, l.indexOf(uuids.at(i)));
+  }
+  EXPECT_EQ(-1, l.indexOf(Uuid::createRandom()));
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -157,6 +157,61 @@ TEST(SExpressionTest, testParsePartialExpression) {
   }
 }
 
+TEST(SExpressionTest, testParseSetsFilePath) {
+  const FilePath fp("/foo/bar.lp");
+  std::unique_ptr<SExpression> s =
+      SExpression::parse("(test (foo \"bar\")\n)", fp);
+  EXPECT_EQ(fp, s->getFilePath());
+  EXPECT_EQ(fp, s->getChild("foo/@0").getFilePath());
+  EXPECT_EQ(fp, SExpression(*s).getChild("foo").getFilePath());
+  EXPECT_EQ(FilePath(), SExpression::createList("test")->getFilePath());
+}
+
+TEST(SExpressionTest, testParseUtf8) {
+  std::unique_ptr<SExpression> s = SExpression::parse(
+      "(test \"\xC3\xA4\\\"\xE2\x82\xAC\" \xC3\xB6)", FilePath(),
+      SExpression::Mode::Permissive);
+  EXPECT_EQ(QString::fromUtf8("\xC3\xA4\"\xE2\x82\xAC"),
+            s->getChild("@0").getValue());
+  EXPECT_EQ(QString::fromUtf8("\xC3\xB6"), s->getChild("@1").getValue());
+  EXPECT_THROW(SExpression::parse("(test \xC3\xB6)", FilePath()),
+               RuntimeError);
+}
+
+TEST(SExpressionTest, testParseNonAsciiWhitespace) {
+  // Non-ASCII whitespace like U+00A0 or U+3000 is never part of a token.
+  EXPECT_THROW(SExpression::parse("(test foo\xC2\xA0)", FilePath(),
+                                  SExpression::Mode::Permissive),
+               RuntimeError);
+  EXPECT_THROW(SExpression::parse("(test foo\xE3\x80\x80)", FilePath(),
+                                  SExpression::Mode::Permissive),
+               RuntimeError);
+}
+
+TEST(SExpressionTest, testParseSkippedLists) {
+  const QByteArray input =
+      "(test (name \"foo\")\n"
+      " (pad (a \")(\\\"\") ; comment )\n"
+      "  (b (c)))\n"
+      " (keep (pad 1)) (pad)\n"
+      ")";
+  const std::unique_ptr<SExpression> expected = SExpression::parse(
+      "(test (name \"foo\")\n\n (keep (pad 1))\n)", FilePath());
+  const std::unique_ptr<SExpression> actual =
+      SExpression::parse(input, FilePath(), SExpression::Mode::LibrePCB,
+                         {"pad", "unused"});
+  EXPECT_EQ(expected->toByteArray().toStdString(),
+            actual->toByteArray().toStdString());
+  const std::unique_ptr<SExpression> full =
+      SExpression::parse(input, FilePath());
+  EXPECT_EQ(2, full->getChildren("pad").count());
+
+  // The end of a skipped list must still be detected.
+  EXPECT_THROW(SExpression::parse("(test (pad \")\")", FilePath(),
+                                  SExpression::Mode::LibrePCB, {"pad"}),
+               RuntimeError);
+}
+
 TEST(SExpressionTest, testSerializeStringWithEscaping) {
   std::unique_ptr<SExpression> s =
       SExpression::createString("Foo\n \r\n \" \\ Bar");
@@ -314,6 +369,28 @@ TEST(SExpressionTest, testParsePerformance) {
             << " loops\n";
 }
 
+static QByteArray createLargeBoard(int segments) {
+  // Synthetic document similar to a large board file.
+  QByteArray content = "(librepcb_board 71762d7e-e7f1-403c-8020-db9670c01e9b\n";
+  for (int i = 0; i < segments; ++i) {
+    content +=
+        " (netsegment 3115f409-5e6c-4023-a8ab-06428ed0720a (net none)\n"
+        "  (via 2cc45b07-1bef-4340-9292-b54b011c70c5 (from top_cu) (to bot_cu)"
+        "\n   (position 35.91989 46.0375) (size 0.7) (drill 0.3)\n  )\n"
+        "  (trace 0b8d6b2c-e0a4-4e5a-8a2f-1e3c4a3e9d2a (layer top_cu)"
+        " (width 0.25) (name \"Some \\\"quoted\\\" text\")\n  )\n )\n";
+  }
+  content += ")\n";
+  return content;
+}
+
+TEST(SExpressionTest, testSerializeLargeDocument) {
+  const QByteArray content = createLargeBoard(50000);
+  std::unique_ptr<SExpression> s = SExpression::parse(content, FilePath());
+  EXPECT_EQ(50000, s->getChildren("netsegment").count());
+  EXPECT_EQ(content.toStdString(), s->toByteArray().toStdString());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
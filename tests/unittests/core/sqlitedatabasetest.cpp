@@ -96,6 +96,55 @@ TEST_F(SQLiteDatabaseTest, testInsert) {
   }
 }
 
+TEST_F(SQLiteDatabaseTest, testPrepareCachedQuery) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+  QSqlQuery* previous = nullptr;
+  for (int i = 0; i < 10; ++i) {
+    QSqlQuery& query = db.prepareCachedQuery(
+        "INSERT INTO %table (name) VALUES (:name)", {{"%table", "test"}});
+    query.bindValue(":name", QString("row %1").arg(i));
+    EXPECT_EQ(i + 1, db.insert(query));
+    if (previous) {
+      EXPECT_EQ(previous, &query);
+    }
+    previous = &query;
+  }
+  QSqlQuery& other = db.prepareCachedQuery("SELECT COUNT(*) FROM test");
+  EXPECT_NE(previous, &other);
+  EXPECT_EQ(10, db.count(other));
+}
+
+TEST_F(SQLiteDatabaseTest, testInsertMultiple) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+
+  // More rows than parameters allowed per query, to test splitting.
+  QVector<QVariantList> rows;
+  for (int i = 0; i < 1234; ++i) {
+    rows.append({i + 1, QString("row %1").arg(i)});
+  }
+  db.insertMultiple("test", {"id", "name"}, rows);
+  db.insertMultiple("test", {"id", "name"}, {});
+
+  QSqlQuery query = db.prepareQuery("SELECT id, name FROM test ORDER BY id");
+  db.exec(query);
+  int count = 0;
+  while (query.next()) {
+    EXPECT_EQ(count + 1, query.value(0).toInt());
+    EXPECT_EQ(QString("row %1").arg(count), query.value(1).toString());
+    ++count;
+  }
+  EXPECT_EQ(rows.count(), count);
+}
+
+TEST_F(SQLiteDatabaseTest, testInsertMultipleInvalidRow) {
+  SQLiteDatabase db(mTempDbFilePath);
+  db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
+  EXPECT_THROW(db.insertMultiple("test", {"id", "name"}, {QVariantList{1}}),
+               Exception);
+}
+
 TEST_F(SQLiteDatabaseTest, testClearExistingTable) {
   SQLiteDatabase db(mTempDbFilePath);
   db.exec("CREATE TABLE test (`id` INTEGER PRIMARY KEY NOT NULL, `name` TEXT)");
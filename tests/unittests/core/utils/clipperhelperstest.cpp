@@ -24,6 +24,10 @@
 #include <gtest/gtest.h>
 #include <librepcb/core/utils/clipperhelpers.h>
 
+#include <QtCore>
+
+#include <thread>
+
 /*******************************************************************************
  *  Namespace
  ******************************************************************************/
@@ -59,6 +63,31 @@ TEST_F(ClipperHelpersTest, testConvertPathWithApproximate) {
       outputStr.toStdString());
 }
 
+TEST_F(ClipperHelpersTest, testOperationCountIsThreadLocal) {
+  const ClipperLib::Paths square = {
+      {ClipperLib::IntPoint(0, 0), ClipperLib::IntPoint(100, 0),
+       ClipperLib::IntPoint(100, 100), ClipperLib::IntPoint(0, 100)}};
+  const quint64 before = ClipperHelpers::getOperationCount();
+  ClipperLib::Paths paths = square;
+  ClipperHelpers::unite(paths, ClipperLib::pftNonZero);
+  ClipperHelpers::offset(paths, Length(10), PositiveLength(1));
+  EXPECT_EQ(before + 2, ClipperHelpers::getOperationCount());
+
+  // Operations in other threads must not be counted. Use a dedicated thread
+  // since a thread pool might execute the task in the waiting thread.
+  quint64 threadBefore = 0;
+  quint64 threadAfter = 0;
+  std::thread thread([&]() {
+    threadBefore = ClipperHelpers::getOperationCount();
+    ClipperLib::Paths paths = square;
+    ClipperHelpers::unite(paths, ClipperLib::pftNonZero);
+    threadAfter = ClipperHelpers::getOperationCount();
+  });
+  thread.join();
+  EXPECT_EQ(threadBefore + 1, threadAfter);
+  EXPECT_EQ(before + 2, ClipperHelpers::getOperationCount());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -22,6 +22,8 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 #include <librepcb/core/fileio/fileutils.h>
+#include <librepcb/core/fileio/transactionaldirectory.h>
+#include <librepcb/core/fileio/transactionalfilesystem.h>
 #include <librepcb/core/library/cat/componentcategory.h>
 #include <librepcb/core/library/cat/packagecategory.h>
 #include <librepcb/core/library/cmp/component.h>
@@ -112,6 +114,20 @@ public:
   Version version(const QString& version) {
     return Version::fromString(version);
   }
+
+  qint64 runScan() {
+    qint64 elapsedMs = -1;
+    QEventLoop loop;
+    QObject::connect(mWsDb.get(), &WorkspaceLibraryDb::scanFinished, &loop,
+                     [&](qint64 ms) {
+                       elapsedMs = ms;
+                       loop.quit();
+                     });
+    QTimer::singleShot(60000, &loop, &QEventLoop::quit);
+    mWsDb->startLibraryRescan();
+    loop.exec();
+    return elapsedMs;
+  }
 };
 
 /*******************************************************************************
@@ -362,6 +378,38 @@ TEST_F(WorkspaceLibraryDbTest, testFind) {
   EXPECT_EQ(str(QList<Uuid>{}), str(mWsDb->find<Symbol>("sym2 desc")));
 }
 
+TEST_F(WorkspaceLibraryDbTest, testFindExactUuidFirst) {
+  if (!mWsDb->isFullTextSearchAvailable()) {
+    GTEST_SKIP() << "SQLite FTS5 not available.";
+  }
+  // Both symbols match the UUID of sym1 by their name, but the shorter name
+  // of sym2 gets a better rank. Still sym1 must come first.
+  const QString keyword = uuid(1).toStr();
+  int lib = mWriter->addLibrary(toAbs("lib"), uuid(), version("1"), false,
+                                QByteArray(), QString());
+  int sym = mWriter->addElement<Symbol>(lib, toAbs("sym1"), uuid(1),
+                                        version("0.1"), false, QString());
+  mWriter->addTranslation<Symbol>(
+      sym, "", ElementName("a long name " % keyword % " with many words"), "",
+      "");
+  sym = mWriter->addElement<Symbol>(lib, toAbs("sym2"), uuid(2), version("0.1"),
+                                    false, QString());
+  mWriter->addTranslation<Symbol>(sym, "", ElementName(keyword), "", "");
+  int pkg = mWriter->addElement<Package>(lib, toAbs("pkg1"), uuid(1),
+                                         version("0.1"), false, QString());
+  mWriter->addTranslation<Package>(
+      pkg, "", ElementName("a long name " % keyword % " with many words"), "",
+      "");
+  pkg = mWriter->addElement<Package>(lib, toAbs("pkg2"), uuid(2),
+                                     version("0.1"), false, QString());
+  mWriter->addTranslation<Package>(pkg, "", ElementName(keyword), "", "");
+
+  EXPECT_EQ(str(QList<Uuid>{uuid(1), uuid(2)}),
+            str(mWsDb->find<Symbol>(keyword)));
+  EXPECT_EQ(str(QList<Uuid>{uuid(1), uuid(2)}),
+            str(mWsDb->find<Package>(keyword)));
+}
+
 TEST_F(WorkspaceLibraryDbTest, testFindWithDuplicates) {
   int lib = mWriter->addLibrary(toAbs("lib"), uuid(), version("1"), false,
                                 QByteArray(), QString());
@@ -408,6 +456,60 @@ TEST_F(WorkspaceLibraryDbTest, testFindWithMultipleTranslations) {
             str(mWsDb->find<Symbol>("sym1 en_US name")));
 }
 
+TEST_F(WorkspaceLibraryDbTest, testFindDevicesOfPartsUsesIndex) {
+  const int deviceCount = 200;
+  const int partsPerDevice = 3;
+  SQLiteDatabase::TransactionScopeGuard sg(*mDb);
+  for (int i = 0; i < deviceCount; ++i) {
+    const QString number = QString::number(i).rightJustified(6, '0');
+    const int dev = mWriter->addDevice(0, toAbs("dev" % number), uuid(i),
+                                       version("1"), false, QString(), uuid(),
+                                       uuid());
+    mWriter->addTranslation<Device>(dev, "", ElementName("Device " % number),
+                                    "Description " % number,
+                                    "keyword" % number);
+    for (int k = 0; k < partsPerDevice; ++k) {
+      mWriter->addPart(dev, "MPN-" % number % "-" % QString::number(k),
+                       "Manufacturer " % QString::number(i % 10));
+    }
+  }
+  sg.commit();
+
+  // Substring search, case insensitive.
+  EXPECT_EQ(str(QList<Uuid>{uuid(123)}),
+            str(mWsDb->findDevicesOfParts("pn-000123-2")));
+  EXPECT_EQ(deviceCount / 10,
+            mWsDb->findDevicesOfParts("manufacturer 7").count());
+  EXPECT_EQ(str(QList<Uuid>{}), str(mWsDb->findDevicesOfParts("mpn-9999")));
+
+  // The full text search must look up the FTS index instead of scanning
+  // the whole parts table. Keep the SQL in sync with findDevicesOfParts().
+  if (!mWsDb->isFullTextSearchAvailable()) {
+    GTEST_SKIP() << "SQLite FTS5 not available.";
+  }
+  QSqlQuery query = mDb->prepareQuery(
+      "EXPLAIN QUERY PLAN "
+      "SELECT devices.uuid FROM parts_fts "
+      "INNER JOIN parts "
+      "ON parts.id = parts_fts.rowid "
+      "INNER JOIN devices "
+      "ON devices.id = parts.device_id "
+      "LEFT JOIN devices_tr "
+      "ON devices.id = devices_tr.element_id "
+      "WHERE parts_fts MATCH :keyword "
+      "GROUP BY devices.uuid "
+      "ORDER BY MIN(parts_fts.rank) ASC, MIN(devices_tr.name) ASC");
+  query.bindValue(":keyword", "\"mpn-000123-2\"");
+  mDb->exec(query);
+  QStringList plan;
+  while (query.next()) {
+    plan.append(query.value("detail").toString());
+  }
+  EXPECT_EQ(1, plan.filter("parts_fts VIRTUAL TABLE INDEX").count())
+      << qPrintable(plan.join("\n"));
+  EXPECT_FALSE(plan.contains("SCAN parts")) << qPrintable(plan.join("\n"));
+}
+
 /*******************************************************************************
  *  Tests for getTranslations()
  ******************************************************************************/
@@ -1069,6 +1171,131 @@ TEST_F(WorkspaceLibraryDbTest, testGetComponentDevicesDuplicates) {
   EXPECT_EQ(str(QSet<Uuid>{uuid(1)}), str(mWsDb->getComponentDevices(uuid(0))));
 }
 
+/*******************************************************************************
+ *  Tests for startLibraryRescan()
+ ******************************************************************************/
+
+TEST_F(WorkspaceLibraryDbTest, testIncrementalRescan) {
+  // Create a library containing two symbols.
+  std::shared_ptr<TransactionalFileSystem> fs =
+      TransactionalFileSystem::openRW(toAbs("local/Test.lplib"));
+  TransactionalDirectory libDir(fs);
+  Library lib(uuid(), version("1"), "test", QDateTime::currentDateTime(),
+              ElementName("Test"), "", "");
+  lib.moveTo(libDir);
+  TransactionalDirectory symDir(libDir, lib.getElementsDirectoryName<Symbol>());
+  Symbol sym1(uuid(1), version("1"), "test", QDateTime::currentDateTime(),
+              ElementName("Symbol 1"), "", "");
+  sym1.moveIntoParentDirectory(symDir);
+  Symbol sym2(uuid(2), version("1"), "test", QDateTime::currentDateTime(),
+              ElementName("Symbol 2"), "", "");
+  sym2.moveIntoParentDirectory(symDir);
+  fs->save();
+
+  // Initial scan adds both symbols.
+  EXPECT_GE(runScan(), 0);
+  EXPECT_EQ(1, mWsDb->getAll<Symbol>(uuid(1)).count());
+  EXPECT_EQ(1, mWsDb->getAll<Symbol>(uuid(2)).count());
+
+  // Modify the first symbol and corrupt the second one without changing its
+  // size and modification time. Only the first symbol must be parsed again,
+  // so the corrupted second symbol is expected to be kept in the database.
+  sym1.setVersion(version("2.0.1"));
+  sym1.save();
+  fs->save();
+  const FilePath sym2Fp = sym2.getDirectory().getAbsPath("symbol.lp");
+  const QDateTime sym2Modified = QFileInfo(sym2Fp.toStr()).lastModified();
+  FileUtils::writeFile(sym2Fp,
+                       QByteArray(FileUtils::readFile(sym2Fp).size(), 'x'));
+  QFile sym2File(sym2Fp.toStr());
+  ASSERT_TRUE(sym2File.open(QIODevice::ReadWrite));
+  ASSERT_TRUE(sym2File.setFileTime(sym2Modified,
+                                   QFileDevice::FileModificationTime));
+  sym2File.close();
+  EXPECT_GE(runScan(), 0);
+  EXPECT_EQ(str(QMultiMap<Version, FilePath>{
+                {version("2.0.1"), sym1.getDirectory().getAbsPath()}}),
+            str(mWsDb->getAll<Symbol>(uuid(1))));
+  EXPECT_EQ(1, mWsDb->getAll<Symbol>(uuid(2)).count());
+
+  // Remove the first symbol.
+  FileUtils::removeDirRecursively(sym1.getDirectory().getAbsPath());
+  EXPECT_GE(runScan(), 0);
+  EXPECT_EQ(0, mWsDb->getAll<Symbol>(uuid(1)).count());
+  EXPECT_EQ(1, mWsDb->getAll<Symbol>(uuid(2)).count());
+}
+
+TEST_F(WorkspaceLibraryDbTest, testScanMultiThreaded) {
+  // Create a synthetic library with some symbols by duplicating the files of
+  // a single symbol, with a different name each.
+  const int elementCount = 50;
+  std::shared_ptr<TransactionalFileSystem> fs =
+      TransactionalFileSystem::openRW(toAbs("local/Test.lplib"));
+  TransactionalDirectory libDir(fs);
+  Library lib(uuid(), version("1"), "test", QDateTime::currentDateTime(),
+              ElementName("Test"), "", "");
+  lib.moveTo(libDir);
+  TransactionalDirectory symDir(libDir, lib.getElementsDirectoryName<Symbol>());
+  Symbol sym(uuid(), version("1"), "test", QDateTime::currentDateTime(),
+             ElementName("Symbol"), "", "");
+  sym.moveIntoParentDirectory(symDir);
+  fs->save();
+  const FilePath symFp = sym.getDirectory().getAbsPath();
+  const QByteArray content = FileUtils::readFile(symFp.getPathTo("symbol.lp"));
+  const QByteArray versionFile =
+      FileUtils::readFile(symFp.getPathTo(".librepcb-sym"));
+  for (int i = 1; i < elementCount; ++i) {
+    const QString newUuid = Uuid::createRandom().toStr();
+    const FilePath fp = symFp.getParentDir().getPathTo(newUuid);
+    FileUtils::writeFile(
+        fp.getPathTo("symbol.lp"),
+        QByteArray(content)
+            .replace(sym.getUuid().toStr().toUtf8(), newUuid.toUtf8())
+            .replace("(name \"Symbol\")",
+                     "(name \"Symbol " % QByteArray::number(i) % "\")"));
+    FileUtils::writeFile(fp.getPathTo(".librepcb-sym"), versionFile);
+  }
+
+  // Dump all scanned data, without the row IDs since they depend on the
+  // order of insertion.
+  auto dump = [this]() {
+    QSqlQuery query = mDb->prepareQuery(
+        "SELECT libraries.*, symbols.*, symbols_tr.* FROM symbols "
+        "INNER JOIN libraries ON libraries.id = symbols.library_id "
+        "LEFT JOIN symbols_tr ON symbols_tr.element_id = symbols.id");
+    mDb->exec(query);
+    QStringList rows;
+    while (query.next()) {
+      const QSqlRecord record = query.record();
+      QStringList values;
+      for (int i = 0; i < record.count(); ++i) {
+        const QString name = record.fieldName(i);
+        if ((name != "id") && (!name.endsWith("_id"))) {
+          values.append(name % "=" % query.value(i).toString());
+        }
+      }
+      rows.append(values.join(", "));
+    }
+    rows.sort();
+    return rows;
+  };
+
+  // Scan with a single worker thread.
+  mWsDb->setScanThreadCount(1);
+  ASSERT_GE(runScan(), 0);
+  const QStringList singleThreaded = dump();
+  EXPECT_EQ(elementCount, singleThreaded.count());
+
+  // Scan again with multiple worker threads. Clear the symbols table before
+  // to enforce parsing all symbols again.
+  mWriter->removeAllElements<Symbol>();
+  ASSERT_TRUE(dump().isEmpty());
+  mWsDb->setScanThreadCount(4);
+  ASSERT_GE(runScan(), 0);
+  EXPECT_EQ(singleThreaded.join("\n").toStdString(),
+            dump().join("\n").toStdString());
+}
+
 /*******************************************************************************
  *  End of File
  ******************************************************************************/
@@ -0,0 +1,213 @@
+/*
+ * LibrePCB - Professional EDA for everyone!
+ * Copyright (C) 2013 LibrePCB Developers, see AUTHORS.md for contributors.
+ * https://librepcb.org/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*******************************************************************************
+ *  Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <librepcb/editor/3d/openglmesh.h>
+#include <librepcb/editor/3d/openglmeshobject.h>
+#include <librepcb/editor/3d/opengltriangleobject.h>
+#include <librepcb/editor/3d/slintopenglview.h>
+
+#include <QtCore>
+#include <QtGui>
+
+/*******************************************************************************
+ *  Namespace
+ ******************************************************************************/
+namespace librepcb {
+namespace editor {
+namespace tests {
+
+/*******************************************************************************
+ *  Test Class
+ ******************************************************************************/
+
+class OpenGlMeshTest : public ::testing::Test {
+protected:
+  // Unit cube, 12 triangles.
+  static QVector<QVector3D> createCube() noexcept {
+    QVector<QVector3D> v;
+    for (int axis = 0; axis < 3; ++axis) {
+      for (float side : {-0.5f, 0.5f}) {
+        auto p = [axis, side](float a, float b) {
+          QVector3D vertex;
+          vertex[axis] = side;
+          vertex[(axis + 1) % 3] = a;
+          vertex[(axis + 2) % 3] = b;
+          return vertex;
+        };
+        v << p(-0.5f, -0.5f) << p(0.5f, -0.5f) << p(0.5f, 0.5f);
+        v << p(-0.5f, -0.5f) << p(0.5f, 0.5f) << p(-0.5f, 0.5f);
+      }
+    }
+    return v;
+  }
+
+  // Grid of slightly rotated, small cubes.
+  static QVector<QMatrix4x4> createTransforms(int count) noexcept {
+    QVector<QMatrix4x4> transforms;
+    const int columns = qCeil(qSqrt(count));
+    for (int i = 0; i < count; ++i) {
+      QMatrix4x4 m;
+      m.translate(-0.45f + 0.9f * (i % columns) / columns,
+                  -0.45f + 0.9f * (i / columns) / columns, 0);
+      m.rotate(30 + i, 1, 1, 0);
+      m.scale(0.5f / columns);
+      transforms.append(m);
+    }
+    return transforms;
+  }
+
+  static QImage render(SlintOpenGlView& view,
+                       const QVector<std::shared_ptr<OpenGlObject>>& objects) {
+    view.setObjects(objects);
+    const slint::Image img = view.render(200, 200);
+    if (auto data = img.to_rgba8()) {
+      // Copy the image since the pixel buffer gets released.
+      return QImage(reinterpret_cast<const uchar*>(data->begin()),
+                    data->width(), data->height(), QImage::Format_RGBA8888)
+          .copy();
+    }
+    return QImage();
+  }
+
+  static qreal calcDifferentPixelsRatio(const QImage& a,
+                                        const QImage& b) noexcept {
+    int count = 0;
+    for (int y = 0; y < a.height(); ++y) {
+      for (int x = 0; x < a.width(); ++x) {
+        const QColor ca = a.pixelColor(x, y);
+        const QColor cb = b.pixelColor(x, y);
+        if ((qAbs(ca.red() - cb.red()) > 8) ||
+            (qAbs(ca.green() - cb.green()) > 8) ||
+            (qAbs(ca.blue() - cb.blue()) > 8)) {
+          ++count;
+        }
+      }
+    }
+    return count / qreal(a.width() * a.height());
+  }
+};
+
+/*******************************************************************************
+ *  Test Methods
+ ******************************************************************************/
+
+TEST_F(OpenGlMeshTest, testIndexing) {
+  const OpenGlMesh mesh(createCube());
+  EXPECT_EQ(1, mesh.getSubMeshCount());
+  EXPECT_EQ(8, mesh.getVertexCount());
+  EXPECT_EQ(36, mesh.getIndexCount());
+  EXPECT_EQ(qint64(8 * sizeof(QVector3D) + 36 * sizeof(quint16)),
+            mesh.getBufferSize());
+}
+
+// Meshes exceeding the range of 16-bit indices are split into sub-meshes
+// since OpenGL ES 2.0 might not support 32-bit indices.
+TEST_F(OpenGlMeshTest, testSplitIntoSubMeshes) {
+  QVector<QVector3D> triangles;
+  for (int i = 0; i < 70002; ++i) {
+    triangles.append(QVector3D(i % 1000, i / 1000, 0));
+  }
+  const OpenGlMesh mesh(triangles);
+  EXPECT_EQ(2, mesh.getSubMeshCount());
+  EXPECT_EQ(70002, mesh.getVertexCount());
+  EXPECT_EQ(70002, mesh.getIndexCount());
+  EXPECT_EQ(qint64(70002 * (sizeof(QVector3D) + sizeof(quint16))),
+            mesh.getBufferSize());
+}
+
+TEST_F(OpenGlMeshTest, testEmpty) {
+  const OpenGlMesh mesh(QVector<QVector3D>{});
+  EXPECT_EQ(0, mesh.getSubMeshCount());
+  EXPECT_EQ(0, mesh.getVertexCount());
+  EXPECT_EQ(0, mesh.getIndexCount());
+  EXPECT_EQ(0, mesh.getBufferSize());
+}
+
+// Render many instances of the same model with a shared mesh and check that
+// the result is identical to transforming all vertices on the CPU and
+// uploading them as separate objects. On CI this runs with a software
+// renderer (Mesa llvmpipe), thus it is skipped if no OpenGL is available.
+TEST_F(OpenGlMeshTest, testSharedMeshRendering) {
+  SlintOpenGlView view;
+  view.setBackgroundColor(Qt::black);
+  if (!view.getOpenGlErrors().isEmpty()) {
+    GTEST_SKIP() << qPrintable(view.getOpenGlErrors().join("\n"));
+  }
+
+  const QVector<QVector3D> cube = createCube();
+  const QVector<QMatrix4x4> transforms = createTransforms(400);
+  const QColor color(Qt::green);
+
+  // Reference: One vertex buffer per instance.
+  QVector<std::shared_ptr<OpenGlObject>> triangleObjects;
+  qint64 triangleObjectsSize = 0;
+  for (const QMatrix4x4& m : transforms) {
+    QVector<QVector3D> vertices = cube;
+    for (QVector3D& vertex : vertices) {
+      vertex = m.map(vertex);
+    }
+    auto obj =
+        std::make_shared<OpenGlTriangleObject>(OpenGlObject::Type::Device);
+    obj->setData(color, vertices);
+    triangleObjects.append(obj);
+    triangleObjectsSize += vertices.count() * sizeof(QVector3D);
+  }
+  const QImage triangleImage = render(view, triangleObjects);
+
+  // Shared mesh, transformed by the vertex shader.
+  auto mesh = std::make_shared<OpenGlMesh>(cube);
+  QVector<std::shared_ptr<OpenGlObject>> meshObjects;
+  for (const QMatrix4x4& m : transforms) {
+    auto obj = std::make_shared<OpenGlMeshObject>(OpenGlObject::Type::Device);
+    obj->setData(color, mesh, m);
+    meshObjects.append(obj);
+  }
+  const QImage meshImage = render(view, meshObjects);
+
+  // Check that something was rendered at all.
+  ASSERT_FALSE(meshImage.isNull());
+  ASSERT_EQ(triangleImage.size(), meshImage.size());
+  QImage black = meshImage;
+  black.fill(Qt::black);
+  EXPECT_GT(calcDifferentPixelsRatio(meshImage, black), 0.1);
+
+  // Allow tiny differences at edges due to different rounding.
+  EXPECT_LT(calcDifferentPixelsRatio(triangleImage, meshImage), 0.01);
+
+  // GPU memory must not scale with the number of instances.
+  EXPECT_LT(mesh->getBufferSize() * 100, triangleObjectsSize);
+
+  // Release OpenGL resources while the context is still alive.
+  view.setObjects({});
+  triangleObjects.clear();
+  meshObjects.clear();
+  mesh.reset();
+}
+
+/*******************************************************************************
+ *  End of File
+ ******************************************************************************/
+
+}  // namespace tests
+}  // namespace editor
+}  // namespace librepcb